@@ -1391,6 +1391,8 @@ public:
      * @param[in] w A new width of the image in pixels.
      * @param[in] h A new height of the image in pixels.
      *
+     * @note If it's called prior to load(), the size is kept and the bitmap loaders (JPG, PNG) may decode the image in a reduced resolution
+     *       which still covers the given size. This would save the decoding time and memory for the thumbnails.
      */
     Result size(float w, float h) noexcept;
 
@@ -2107,6 +2109,8 @@ public:
      * @retval Result::Unknown if attempting to save an empty paint.
      *
      * @note A higher frames per second (FPS) would result in a larger file size. It is recommended to use the default value.
+     * @note Saving a Lottie animation with the ".lotb" extension exports its compiled form, a snapshot of the parsed animation model.
+     *       It's loaded without the json parser, but only on the hosts of the same byte order. The @p quality and @p fps are ignored.
      * @note Saving can be asynchronous if the assigned thread number is greater than zero. To guarantee the saving is done, call sync() afterwards.
      *
      * @see Saver::sync()
@@ -2115,6 +2119,57 @@ public:
      */
     Result save(Animation* animation, const char* filename, uint32_t quality = 100, uint32_t fps = 0) noexcept;
 
+    /**
+     * @brief Export the provided animation data through the given writer function.
+     *
+     * This works the same as save(Animation*, const char*, uint32_t, uint32_t), but the encoded data is passed to the @p writer in order
+     * instead of being written to a file. The data is delivered in large blocks, thus the @p writer might be called several times.
+     *
+     * @param[in] animation The animation to be saved, including all associated properties.
+     * @param[in] writer The function to receive the encoded data. The @p buffer is valid only during the call. Return @c false to stop saving.
+     * @param[in] data The user data to be passed to the @p writer.
+     * @param[in] mimeType The format of the saved data. Currently, @c "gif" and @c "lotb" are supported.
+     * @param[in] quality The encoded quality level. @c 0 is the minimum, @c 100 is the maximum value(recommended).
+     * @param[in] fps The desired frames per second (FPS). Pass 0 to keep the original frame data.
+     *
+     * @retval Result::InvalidArguments if the @p writer is @c nullptr.
+     * @retval Result::InsufficientCondition if there are ongoing resource-saving operations.
+     * @retval Result::NonSupport if the @p mimeType is unknown or not supported.
+     * @retval Result::Unknown if attempting to save an empty paint.
+     *
+     * @note Saving can be asynchronous if the assigned thread number is greater than zero. In this case, the @p writer is called on a worker thread.
+     *       To guarantee the saving is done, call sync() afterwards.
+     *
+     * @see Saver::sync()
+     *
+     * @note Experimental API
+     */
+    Result save(Animation* animation, std::function<bool(const char* buffer, uint32_t size, void* data)> writer, void* data, const char* mimeType, uint32_t quality = 100, uint32_t fps = 0) noexcept;
+
+    /**
+     * @brief Export the provided animation data into a memory buffer.
+     *
+     * This works the same as save(Animation*, const char*, uint32_t, uint32_t), but the encoded data is kept in a buffer growing in the memory.
+     * The buffer is handed over to the @p buffer and @p size once the saving is finished by sync().
+     *
+     * @param[in] animation The animation to be saved, including all associated properties.
+     * @param[out] buffer The pointer to receive the encoded data. The caller takes its ownership and must release it with free().
+     * @param[out] size The size of the encoded data in bytes.
+     * @param[in] mimeType The format of the saved data. Currently, @c "gif" and @c "lotb" are supported.
+     * @param[in] quality The encoded quality level. @c 0 is the minimum, @c 100 is the maximum value(recommended).
+     * @param[in] fps The desired frames per second (FPS). Pass 0 to keep the original frame data.
+     *
+     * @retval Result::InvalidArguments if the @p buffer or @p size is @c nullptr.
+     * @retval Result::InsufficientCondition if there are ongoing resource-saving operations.
+     * @retval Result::NonSupport if the @p mimeType is unknown or not supported.
+     * @retval Result::Unknown if attempting to save an empty paint.
+     *
+     * @see Saver::sync()
+     *
+     * @note Experimental API
+     */
+    Result save(Animation* animation, char** buffer, uint32_t* size, const char* mimeType, uint32_t quality = 100, uint32_t fps = 0) noexcept;
+
     /**
      * @brief Guarantees that the saving task is finished.
      *
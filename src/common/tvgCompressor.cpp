@@ -60,16 +60,16 @@ size_t b64Decode(const char* encoded, const size_t len, char** decoded)
             continue;
         }
 
-        auto value1 = B64_INDEX[(size_t)encoded[0]];
-        auto value2 = B64_INDEX[(size_t)encoded[1]];
+        auto value1 = B64_INDEX[(uint8_t)encoded[0]];
+        auto value2 = B64_INDEX[(uint8_t)encoded[1]];
         output[idx++] = (value1 << 2) + ((value2 & 0x30) >> 4);
 
         if (!encoded[2] || encoded[3] < 0 || encoded[2] == '=' || encoded[2] == '.') break;
-        auto value3 = B64_INDEX[(size_t)encoded[2]];
+        auto value3 = B64_INDEX[(uint8_t)encoded[2]];
         output[idx++] = ((value2 & 0x0f) << 4) + ((value3 & 0x3c) >> 2);
 
         if (!encoded[3] || encoded[3] < 0 || encoded[3] == '=' || encoded[3] == '.') break;
-        auto value4 = B64_INDEX[(size_t)encoded[3]];
+        auto value4 = B64_INDEX[(uint8_t)encoded[3]];
         output[idx++] = ((value3 & 0x03) << 6) + value4;
         encoded += 4;
     }
@@ -95,4 +95,87 @@ unsigned long djb2Encode(const char* str)
     return hash;
 }
 
-}
\ No newline at end of file
+
+
+/************************************************************************/
+/* SHA-256 Implementation                                               */
+/************************************************************************/
+
+static constexpr uint32_t SHA256_K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+static inline uint32_t _rotr(uint32_t x, uint32_t n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+
+static void _sha256Block(uint32_t* h, const uint8_t* block)
+{
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) | (uint32_t(block[i * 4 + 2]) << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        auto s0 = _rotr(w[i - 15], 7) ^ _rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        auto s1 = _rotr(w[i - 2], 17) ^ _rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+
+    for (int i = 0; i < 64; ++i) {
+        auto t1 = k + (_rotr(e, 6) ^ _rotr(e, 11) ^ _rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        auto t2 = (_rotr(a, 2) ^ _rotr(a, 13) ^ _rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+
+void sha256(const uint8_t* data, size_t len, uint8_t* digest)
+{
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    auto remains = len;
+    for (; remains >= 64; remains -= 64, data += 64) _sha256Block(h, data);
+
+    //the padding with the message length in bits
+    uint8_t tail[128] = {0, };
+    memcpy(tail, data, remains);
+    tail[remains] = 0x80;
+    auto size = (remains < 56) ? 64 : 128;
+    auto bits = uint64_t(len) * 8;
+    for (int i = 0; i < 8; ++i) tail[size - 1 - i] = uint8_t(bits >> (i * 8));
+
+    _sha256Block(h, tail);
+    if (size == 128) _sha256Block(h, tail + 64);
+
+    for (int i = 0; i < 8; ++i) {
+        digest[i * 4] = uint8_t(h[i] >> 24);
+        digest[i * 4 + 1] = uint8_t(h[i] >> 16);
+        digest[i * 4 + 2] = uint8_t(h[i] >> 8);
+        digest[i * 4 + 3] = uint8_t(h[i]);
+    }
+}
+
+}
@@ -29,6 +29,7 @@ namespace tvg
 {
     size_t b64Decode(const char* encoded, const size_t len, char** decoded);
     unsigned long djb2Encode(const char* str);
+    void sha256(const uint8_t* data, size_t len, uint8_t* digest);   //digest: 32 bytes
 }
 
 #endif  //_TVG_COMPRESSOR_H_
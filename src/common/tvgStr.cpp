@@ -31,9 +31,47 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-static inline bool _floatExact(float a, float b)
+#define MAX_MANTISSA_DIGITS 19     //max decimal digits fitting in a 64-bit mantissa
+
+
+static inline bool _digit(char c)
 {
-    return memcmp(&a, &b, sizeof(float)) == 0;
+    return (unsigned char)(c - '0') < 10;
+}
+
+
+//Accumulate a digit into the mantissa, the digits over the 64-bit precision only scale the exponent.
+static inline void _accumulate(uint64_t& mantissa, int& digits, int& exponent, char c, bool fraction)
+{
+    if (digits < MAX_MANTISSA_DIGITS) {
+        mantissa = mantissa * 10ULL + static_cast<uint64_t>(c - '0');
+        if (mantissa > 0) ++digits;
+        if (fraction) --exponent;
+    } else if (!fraction) {
+        ++exponent;
+    }
+}
+
+
+/* Clinger's fast path: if the mantissa and the power of ten are both exactly
+   representable in double, a single multiplication or division is correctly
+   rounded. It covers nearly all the numbers appearing in vector graphics data. */
+static float _compose(uint64_t mantissa, int exponent)
+{
+    static constexpr double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    static constexpr int maxExponent = sizeof(pow10) / sizeof(pow10[0]) - 1;
+
+    if (mantissa == 0) return 0.0f;
+
+    auto val = static_cast<double>(mantissa);
+    if (exponent >= 0 && exponent <= maxExponent) return static_cast<float>(val * pow10[exponent]);
+    if (exponent < 0 && exponent >= -maxExponent) return static_cast<float>(val / pow10[-exponent]);
+
+    //out of the fast path range
+    return static_cast<float>(val * pow(10.0, exponent));
 }
 
 
@@ -63,7 +101,9 @@ float toFloat(const char *str, char **end)
     auto a = str;
     auto iter = str;
     auto val = 0.0f;
-    unsigned long long integerPart = 0;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
     int minus = 1;
 
     //ignore leading whitespaces
@@ -100,41 +140,33 @@ float toFloat(const char *str, char **end)
     }
 
     //Optional: integer part before dot
-    if (isdigit(*iter)) {
-        for (; isdigit(*iter); iter++) {
-            integerPart = integerPart * 10ULL + (unsigned long long) (*iter - '0');
+    if (_digit(*iter)) {
+        for (; _digit(*iter); iter++) {
+            _accumulate(mantissa, digits, exponent, *iter, false);
         }
         a = iter;
     } else if (*iter != '.') {
         goto success;
     }
 
-    val = static_cast<float>(integerPart);
-
     //Optional: decimal part after dot
     if (*iter == '.') {
-        unsigned long long decimalPart = 0;
-        unsigned long long pow10 = 1;
-        int count = 0;
-
         iter++;
 
-        if (isdigit(*iter)) {
-            for (; isdigit(*iter); iter++, count++) {
-                if (count < 19) {
-                    decimalPart = decimalPart * 10ULL + +static_cast<unsigned long long>(*iter - '0');
-                    pow10 *= 10ULL;
-                }
+        if (_digit(*iter)) {
+            for (; _digit(*iter); iter++) {
+                _accumulate(mantissa, digits, exponent, *iter, true);
             }
         } else if (isspace(*iter)) { //skip if there is a space after the dot.
+            val = _compose(mantissa, exponent);
             a = iter;
             goto success;
         }
-
-        val += static_cast<float>(decimalPart) / static_cast<float>(pow10);
         a = iter;
     }
 
+    val = _compose(mantissa, exponent);
+
     //Optional: exponent
     if (*iter == 'e' || *iter == 'E') {
         ++iter;
@@ -156,41 +188,23 @@ float toFloat(const char *str, char **end)
             iter++;
         }
 
-        unsigned int exponentPart = 0;
+        int exponentPart = 0;
 
-        if (isdigit(*iter)) {
-            while (*iter == '0') iter++;
-            for (; isdigit(*iter); iter++) {
-                exponentPart = exponentPart * 10U + static_cast<unsigned int>(*iter - '0');
+        if (_digit(*iter)) {
+            for (; _digit(*iter); iter++) {
+                //saturate, the result is out of the float range anyway
+                if (exponentPart < 10000) exponentPart = exponentPart * 10 + (*iter - '0');
             }
-        } else if (!isdigit(*(a - 1))) {
+        } else if (!_digit(*(a - 1))) {
             a = str;
             goto success;
         } else if (*iter == 0) {
             goto success;
         }
 
-        //if ((_floatExact(val, 2.2250738585072011f)) && ((minus_e * static_cast<int>(exponentPart)) <= -308)) {
-        if ((_floatExact(val, 1.175494351f)) && ((minus_e * static_cast<int>(exponentPart)) <= -38)) {
-            //val *= 1.0e-308f;
-            val *= 1.0e-38f;
-            a = iter;
-            goto success;
-        }
-
         a = iter;
-        auto scale = 1.0f;
-
-        while (exponentPart >= 8U) {
-            scale *= 1E8f;
-            exponentPart -= 8U;
-        }
-        while (exponentPart > 0U) {
-            scale *= 10.0f;
-            exponentPart--;
-        }
-        val = (minus_e == -1) ? (val / scale) : (val * scale);
-    } else if ((iter > str) && !isdigit(*(iter - 1))) {
+        val = _compose(mantissa, exponent + minus_e * exponentPart);
+    } else if ((iter > str) && !_digit(*(iter - 1))) {
         a = str;
         goto success;
     }
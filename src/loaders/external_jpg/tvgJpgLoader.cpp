@@ -35,6 +35,41 @@ void JpgLoader::clear()
     freeData = false;
 }
 
+
+void JpgLoader::run(TVG_UNUSED unsigned tid)
+{
+    //determine the image format
+    TJPF format;
+    if (target == ColorSpace::ABGR8888 || target == ColorSpace::ABGR8888S) {
+        format = TJPF_RGBX;
+        surface.cs = ColorSpace::ABGR8888;
+    } else {
+        format = TJPF_BGRX;
+        surface.cs = ColorSpace::ARGB8888;
+    }
+
+    auto image = (unsigned char *)tjAlloc(static_cast<int>(w) * static_cast<int>(h) * tjPixelSize[format]);
+
+    //decompress jpg image
+    if (image && tjDecompress2(jpegDecompressor, data, size, image, static_cast<int>(w), 0, static_cast<int>(h), format, 0) < 0) {
+        TVGERR("JPG LOADER", "%s", tjGetErrorStr());
+        tjFree(image);
+        image = nullptr;
+    }
+
+    clear();
+
+    if (!image) return;
+
+    //setup the surface
+    surface.buf8 = image;
+    surface.stride = w;
+    surface.w = w;
+    surface.h = h;
+    surface.channelSize = sizeof(uint32_t);
+    surface.premultiplied = true;
+}
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -47,6 +82,7 @@ JpgLoader::JpgLoader() : ImageLoader(FileType::Jpg)
 
 JpgLoader::~JpgLoader()
 {
+    done();
     clear();
     tjDestroy(jpegDecompressor);
 
@@ -128,35 +164,24 @@ bool JpgLoader::read()
 
     if (w == 0 || h == 0) return false;
 
-    //determine the image format
-    TJPF format;
-    if (ImageLoader::cs == ColorSpace::ARGB8888 || ImageLoader::cs == ColorSpace::ARGB8888S) {
-        format = TJPF_BGRX;
-        surface.cs = ColorSpace::ARGB8888;
-    } else {
-        format = TJPF_RGBX;
-        surface.cs = ColorSpace::ABGR8888;
-    }
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
-    auto image = (unsigned char *)tjAlloc(static_cast<int>(w) * static_cast<int>(h) * tjPixelSize[format]);
-    if (!image) return false;
-
-    //decompress jpg image
-    if (tjDecompress2(jpegDecompressor, data, size, image, static_cast<int>(w), 0, static_cast<int>(h), format, 0) < 0) {
-        TVGERR("JPG LOADER", "%s", tjGetErrorStr());
-        tjFree(image);
-        image = nullptr;
-        return false;
-    }
+    return true;
+}
 
-    //setup the surface
-    surface.buf8 = image;
-    surface.stride = w;
-    surface.w = w;
-    surface.h = h;
-    surface.channelSize = sizeof(uint32_t);
-    surface.premultiplied = true;
 
-    clear();
+bool JpgLoader::close()
+{
+    if (!LoadModule::close()) return false;
+    this->done();
     return true;
 }
+
+
+RenderSurface* JpgLoader::bitmap(ColorSpace cs)
+{
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
+}
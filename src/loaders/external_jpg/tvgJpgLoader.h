@@ -24,11 +24,11 @@
 #define _TVG_JPG_LOADER_H_
 
 #include "tvgLoader.h"
+#include "tvgTaskScheduler.h"
 
 using tjhandle = void*;
 
-//TODO: Use Task?
-class JpgLoader : public ImageLoader
+class JpgLoader : public ImageLoader, public Task
 {
 public:
     JpgLoader();
@@ -37,9 +37,13 @@ public:
     bool open(const char* path) override;
     bool open(const char* data, uint32_t size, const char* rpath, bool copy) override;
     bool read() override;
+    bool close() override;
+
+    RenderSurface* bitmap(ColorSpace cs) override;
 
 private:
     void clear();
+    void run(unsigned tid) override;
 
     tjhandle jpegDecompressor;
     unsigned char* data = nullptr;
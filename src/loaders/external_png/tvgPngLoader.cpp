@@ -33,6 +33,36 @@ void PngLoader::clear()
     image = nullptr;
 }
 
+
+void PngLoader::run(TVG_UNUSED unsigned tid)
+{
+    if (target == ColorSpace::ABGR8888 || target == ColorSpace::ABGR8888S) {
+        image->format = PNG_FORMAT_RGBA;
+        surface.cs = ColorSpace::ABGR8888S;
+    } else {
+        image->format = PNG_FORMAT_BGRA;
+        surface.cs = ColorSpace::ARGB8888S;
+    }
+
+    auto buffer = tvg::malloc<png_bytep>(PNG_IMAGE_SIZE((*image)));
+    if (!png_image_finish_read(image, NULL, buffer, 0, NULL)) {
+        tvg::free(buffer);
+        clear();
+        return;
+    }
+
+    //setup the surface
+    surface.buf32 = reinterpret_cast<uint32_t*>(buffer);
+    surface.stride = (uint32_t)w;
+    surface.w = (uint32_t)w;
+    surface.h = (uint32_t)h;
+    surface.channelSize = sizeof(uint32_t);
+    //TODO: we can acquire a pre-multiplied image. See "png_structrp"
+    surface.premultiplied = false;
+
+    clear();
+}
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -46,6 +76,7 @@ PngLoader::PngLoader() : ImageLoader(FileType::Png)
 
 PngLoader::~PngLoader()
 {
+    done();
     clear();
     tvg::free(surface.buf32);
 }
@@ -87,30 +118,24 @@ bool PngLoader::read()
 
     if (w == 0 || h == 0) return false;
 
-    if (ImageLoader::cs == ColorSpace::ARGB8888 || ImageLoader::cs == ColorSpace::ARGB8888S) {
-        image->format = PNG_FORMAT_BGRA;
-        surface.cs = ColorSpace::ARGB8888S;
-    } else {
-        image->format = PNG_FORMAT_RGBA;
-        surface.cs = ColorSpace::ABGR8888S;
-    }
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
-    auto buffer = tvg::malloc<png_bytep>(PNG_IMAGE_SIZE((*image)));
-    if (!png_image_finish_read(image, NULL, buffer, 0, NULL)) {
-        tvg::free(buffer);
-        return false;
-    }
-
-    //setup the surface
-    surface.buf32 = reinterpret_cast<uint32_t*>(buffer);
-    surface.stride = (uint32_t)w;
-    surface.w = (uint32_t)w;
-    surface.h = (uint32_t)h;
-    surface.channelSize = sizeof(uint32_t);
-    //TODO: we can acquire a pre-multiplied image. See "png_structrp"
-    surface.premultiplied = false;
+    return true;
+}
 
-    clear();
 
+bool PngLoader::close()
+{
+    if (!LoadModule::close()) return false;
+    this->done();
     return true;
 }
+
+
+RenderSurface* PngLoader::bitmap(ColorSpace cs)
+{
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
+}
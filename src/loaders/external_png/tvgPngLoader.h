@@ -25,8 +25,9 @@
 
 #include <png.h>
 #include "tvgLoader.h"
+#include "tvgTaskScheduler.h"
 
-class PngLoader : public ImageLoader
+class PngLoader : public ImageLoader, public Task
 {
 public:
     PngLoader();
@@ -35,9 +36,13 @@ public:
     bool open(const char* path) override;
     bool open(const char* data, uint32_t size, const char* rpath, bool copy) override;
     bool read() override;
+    bool close() override;
+
+    RenderSurface* bitmap(ColorSpace cs) override;
 
 private:
     void clear();
+    void run(unsigned tid) override;
 
     png_imagep image = nullptr;
 };
@@ -30,17 +30,27 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-void WebpLoader::run(unsigned tid)
+void WebpLoader::run(TVG_UNUSED unsigned tid)
 {
-    //TODO: acquire the current colorspace format & pre-multiplied alpha image.
-    surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
+    //TODO: acquire the pre-multiplied alpha image.
+    if (target == ColorSpace::ABGR8888 || target == ColorSpace::ABGR8888S) {
+        surface.buf8 = WebPDecodeRGBA(data, size, nullptr, nullptr);
+        surface.cs = ColorSpace::ABGR8888S;
+    } else {
+        surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
+        surface.cs = ColorSpace::ARGB8888S;
+    }
     surface.stride = (uint32_t)w;
     surface.w = (uint32_t)w;
     surface.h = (uint32_t)h;
     surface.channelSize = sizeof(uint32_t);
-    surface.cs = ColorSpace::ARGB8888;
     surface.premultiplied = false;
 
+    //the source isn't necessary anymore
+    if (freeData) tvg::free(data);
+    data = nullptr;
+    size = 0;
+    freeData = false;
 }
 
 
@@ -56,7 +66,6 @@ WebpLoader::WebpLoader() : ImageLoader(FileType::Webp)
 WebpLoader::~WebpLoader()
 {
     done();
-
     if (freeData) tvg::free(data);
     data = nullptr;
     size = 0;
@@ -131,15 +140,24 @@ bool WebpLoader::read()
 
     if (!data || w == 0 || h == 0) return false;
 
-    TaskScheduler::request(this);
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
     return true;
 }
 
 
-RenderSurface* WebpLoader::bitmap()
+bool WebpLoader::close()
 {
+    if (!LoadModule::close()) return false;
     this->done();
+    return true;
+}
+
 
-    return ImageLoader::bitmap();
+RenderSurface* WebpLoader::bitmap(ColorSpace cs)
+{
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
 }
\ No newline at end of file
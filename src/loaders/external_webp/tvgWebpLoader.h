@@ -35,8 +35,9 @@ public:
     bool open(const char* path) override;
     bool open(const char* data, uint32_t size, const char* rpath, bool copy) override;
     bool read() override;
+    bool close() override;
 
-    RenderSurface* bitmap() override;
+    RenderSurface* bitmap(ColorSpace cs) override;
 
 private:
     void run(unsigned tid) override;
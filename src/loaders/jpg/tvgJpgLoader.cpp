@@ -36,13 +36,15 @@ void JpgLoader::clear()
 }
 
 
-void JpgLoader::run(unsigned tid)
+void JpgLoader::run(TVG_UNUSED unsigned tid)
 {
-    surface.buf8 = jpgdDecompress(decoder);
-    surface.stride = static_cast<uint32_t>(w);
-    surface.w = static_cast<uint32_t>(w);
-    surface.h = static_cast<uint32_t>(h);
-    surface.cs = ColorSpace::ARGB8888;
+    auto rgba = (target == ColorSpace::ABGR8888 || target == ColorSpace::ABGR8888S);
+    auto mask = (1U << shrink) - 1;
+    surface.buf8 = jpgdDecompress(decoder, shrink, rgba);
+    surface.w = (static_cast<uint32_t>(w) + mask) >> shrink;
+    surface.h = (static_cast<uint32_t>(h) + mask) >> shrink;
+    surface.stride = surface.w;
+    surface.cs = rgba ? ColorSpace::ABGR8888 : ColorSpace::ARGB8888;
     surface.channelSize = sizeof(uint32_t);
     surface.premultiplied = true;
 
@@ -109,13 +111,20 @@ bool JpgLoader::open(const char* data, uint32_t size, TVG_UNUSED const char* rpa
 
 
 
+uint8_t JpgLoader::reduction(float w, float h) const
+{
+    return cover(w, h, 3);
+}
+
+
 bool JpgLoader::read()
 {
     if (!LoadModule::read()) return true;
 
     if (!decoder || w == 0 || h == 0) return false;
 
-    TaskScheduler::request(this);
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
     return true;
 }
@@ -129,8 +138,9 @@ bool JpgLoader::close()
 }
 
 
-RenderSurface* JpgLoader::bitmap()
+RenderSurface* JpgLoader::bitmap(ColorSpace cs)
 {
-    this->done();
-    return ImageLoader::bitmap();
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
 }
\ No newline at end of file
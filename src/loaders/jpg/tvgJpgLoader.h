@@ -43,10 +43,11 @@ public:
 
     bool open(const char* path) override;
     bool open(const char* data, uint32_t size, const char* rpath, bool copy) override;
+    uint8_t reduction(float w, float h) const override;
     bool read() override;
     bool close() override;
 
-    RenderSurface* bitmap() override;
+    RenderSurface* bitmap(ColorSpace cs) override;
 };
 
 #endif //_TVG_JPG_LOADER_H_
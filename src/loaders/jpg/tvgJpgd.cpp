@@ -36,8 +36,18 @@
 #include <stdint.h>
 
 #include "tvgCommon.h"
+#include "tvgArray.h"
+#include "tvgTaskScheduler.h"
 #include "tvgJpgd.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+    #include <immintrin.h>
+    #define THORVG_JPGD_VECTOR_SUPPORT
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define THORVG_JPGD_VECTOR_SUPPORT
+#endif
+
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
@@ -130,6 +140,23 @@ public:
 };
 
 
+// Writes the decoded scan lines to the image, reduced to 1/2^shift.
+struct jpgd_writer
+{
+    uint8_t* pImage_data;
+    int image_width, image_height;
+    int dst_width, dst_bpl;
+    int comps, req_comps;
+    int shift;
+    bool rgba;
+
+    //the blocks are flat in the dc only mode, the first row of each is enough.
+    bool skip(int y) const { return shift == 3 && (y & ((1 << shift) - 1)); }
+    //pRow and pSum are the scratch buffers of the row reduction, the rows of a group are written in order.
+    void write(const uint8_t* pScan_line, int y, uint8_t* pRow, uint32_t* pSum) const;
+};
+
+
 class jpeg_decoder
 {
 public:
@@ -156,9 +183,17 @@ public:
     inline int get_bytes_per_scan_line() const { return m_image_x_size * get_bytes_per_pixel(); }
     // Returns the total number of bytes actually consumed by the decoder (which should equal the actual size of the JPEG file).
     inline int get_total_bytes_read() const { return m_total_bytes_read; }
+    // Transforms the DC coefficients only, every 8x8 block is filled with its average color. (1/8 scaled image in the DCT domain)
+    inline void set_dc_only(bool on) { m_dc_only = on; }
+#ifdef THORVG_THREAD_SUPPORT
+    // Whether decode_parallel() is worth for this image. Call it after begin_decoding().
+    bool parallel() const;
+    // Decodes all the scan lines over the task scheduler workers, instead of decode().
+    bool decode_parallel(const jpgd_writer& writer);
+#endif
 
 private:
-    jpeg_decoder(const jpeg_decoder &);
+    jpeg_decoder(const jpeg_decoder &) = default;
     jpeg_decoder &operator =(const jpeg_decoder &);
 
     typedef bool (*pDecode_block_func)(jpeg_decoder*, int, int, int);
@@ -260,6 +295,7 @@ private:
     uint8_t* m_pScan_line_1;
     jpgd_status m_error_code;
     bool m_ready_flag;
+    bool m_dc_only;
     int m_total_bytes_read;
 
     void free_all_blocks();
@@ -305,6 +341,7 @@ private:
     void H1V1Convert();
     void gray_convert();
     void expanded_convert();
+    const uint8_t* convert_line();
     void find_eoi();
     inline uint32_t get_char();
     inline uint32_t get_char(bool *pPadding_flag);
@@ -319,6 +356,16 @@ private:
     static bool decode_block_dc_refine(jpeg_decoder *pD, int component_id, int block_x, int block_y);
     static bool decode_block_ac_first(jpeg_decoder *pD, int component_id, int block_x, int block_y);
     static bool decode_block_ac_refine(jpeg_decoder *pD, int component_id, int block_x, int block_y);
+#ifdef THORVG_THREAD_SUPPORT
+    struct worker;
+    struct segment_task;
+    struct row_task;
+    jpeg_decoder* fork();
+    int read_segment(Array<uint8_t>& data);
+    bool decode_mcus(int mcu, int count, int rows);
+    bool decode_segments(segment_task* task);
+    void transform_rows(int begin, int end, int rows, const jpgd_writer& writer, uint8_t* pRow, uint32_t* pSum);
+#endif
 };
 
 
@@ -532,6 +579,163 @@ static const uint8_t s_idct_row_table[] = {
 static const uint8_t s_idct_col_table[] = { 1, 1, 2, 3, 3, 3, 3, 3, 3, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8 };
 
 
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+
+/* The vector idct runs the 32 bit integer math of the Row/Col templates on four rows,
+   then on four columns at once, so the result is identical to the scalar one. */
+
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+
+using JpgdVector = __m128i;
+
+static inline JpgdVector _vset(int32_t c) { return _mm_set1_epi32(c); }
+static inline JpgdVector _vadd(JpgdVector a, JpgdVector b) { return _mm_add_epi32(a, b); }
+static inline JpgdVector _vsub(JpgdVector a, JpgdVector b) { return _mm_sub_epi32(a, b); }
+static inline JpgdVector _vmul(JpgdVector a, int32_t c) { return _mm_mullo_epi32(a, _mm_set1_epi32(c)); }
+template<int N> static inline JpgdVector _vshl(JpgdVector a) { return _mm_slli_epi32(a, N); }
+template<int N> static inline JpgdVector _vshr(JpgdVector a) { return _mm_srai_epi32(a, N); }
+
+//widens the 8 coefficients of a row
+static inline void _vload(const jpgd_block_t* src, JpgdVector& lo, JpgdVector& hi)
+{
+    auto v = _mm_loadu_si128((const __m128i*)src);
+    lo = _mm_cvtepi16_epi32(v);
+    hi = _mm_cvtepi16_epi32(_mm_srli_si128(v, 8));
+}
+
+//clamps the 8 samples of a row
+static inline void _vstore(uint8_t* dst, JpgdVector lo, JpgdVector hi)
+{
+    auto v = _mm_packs_epi32(lo, hi);
+    _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(v, v));
+}
+
+static inline void _vtranspose(JpgdVector& a, JpgdVector& b, JpgdVector& c, JpgdVector& d)
+{
+    auto t0 = _mm_unpacklo_epi32(a, b);
+    auto t1 = _mm_unpacklo_epi32(c, d);
+    auto t2 = _mm_unpackhi_epi32(a, b);
+    auto t3 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(t0, t1);
+    b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3);
+    d = _mm_unpackhi_epi64(t2, t3);
+}
+
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+
+using JpgdVector = int32x4_t;
+
+static inline JpgdVector _vset(int32_t c) { return vdupq_n_s32(c); }
+static inline JpgdVector _vadd(JpgdVector a, JpgdVector b) { return vaddq_s32(a, b); }
+static inline JpgdVector _vsub(JpgdVector a, JpgdVector b) { return vsubq_s32(a, b); }
+static inline JpgdVector _vmul(JpgdVector a, int32_t c) { return vmulq_n_s32(a, c); }
+template<int N> static inline JpgdVector _vshl(JpgdVector a) { return vshlq_n_s32(a, N); }
+template<int N> static inline JpgdVector _vshr(JpgdVector a) { return vshrq_n_s32(a, N); }
+
+//widens the 8 coefficients of a row
+static inline void _vload(const jpgd_block_t* src, JpgdVector& lo, JpgdVector& hi)
+{
+    auto v = vld1q_s16(src);
+    lo = vmovl_s16(vget_low_s16(v));
+    hi = vmovl_s16(vget_high_s16(v));
+}
+
+//clamps the 8 samples of a row
+static inline void _vstore(uint8_t* dst, JpgdVector lo, JpgdVector hi)
+{
+    vst1_u8(dst, vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+}
+
+static inline void _vtranspose(JpgdVector& a, JpgdVector& b, JpgdVector& c, JpgdVector& d)
+{
+    auto t0 = vtrnq_s32(a, b);
+    auto t1 = vtrnq_s32(c, d);
+    a = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+    b = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+    c = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+    d = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+}
+
+#endif
+
+//1D idct of the 8 vectors in place, the rounding BIAS is added before the descaling SHIFT
+template<int SHIFT, int32_t BIAS>
+static inline void _vidct8(JpgdVector* v)
+{
+    const auto z2 = v[2], z3 = v[6];
+    const auto z1 = _vmul(_vadd(z2, z3), FIX_0_541196100);
+    const auto tmp2 = _vadd(z1, _vmul(z3, - FIX_1_847759065));
+    const auto tmp3 = _vadd(z1, _vmul(z2, FIX_0_765366865));
+
+    const auto tmp0 = _vadd(_vshl<CONST_BITS>(_vadd(v[0], v[4])), _vset(BIAS));
+    const auto tmp1 = _vadd(_vshl<CONST_BITS>(_vsub(v[0], v[4])), _vset(BIAS));
+
+    const auto tmp10 = _vadd(tmp0, tmp3), tmp13 = _vsub(tmp0, tmp3), tmp11 = _vadd(tmp1, tmp2), tmp12 = _vsub(tmp1, tmp2);
+
+    const auto atmp0 = v[7], atmp1 = v[5], atmp2 = v[3], atmp3 = v[1];
+
+    const auto bz1 = _vadd(atmp0, atmp3), bz2 = _vadd(atmp1, atmp2), bz3 = _vadd(atmp0, atmp2), bz4 = _vadd(atmp1, atmp3);
+    const auto bz5 = _vmul(_vadd(bz3, bz4), FIX_1_175875602);
+
+    const auto az1 = _vmul(bz1, - FIX_0_899976223);
+    const auto az2 = _vmul(bz2, - FIX_2_562915447);
+    const auto az3 = _vadd(_vmul(bz3, - FIX_1_961570560), bz5);
+    const auto az4 = _vadd(_vmul(bz4, - FIX_0_390180644), bz5);
+
+    const auto btmp0 = _vadd(_vadd(_vmul(atmp0, FIX_0_298631336), az1), az3);
+    const auto btmp1 = _vadd(_vadd(_vmul(atmp1, FIX_2_053119869), az2), az4);
+    const auto btmp2 = _vadd(_vadd(_vmul(atmp2, FIX_3_072711026), az2), az3);
+    const auto btmp3 = _vadd(_vadd(_vmul(atmp3, FIX_1_501321110), az1), az4);
+
+    v[0] = _vshr<SHIFT>(_vadd(tmp10, btmp3));
+    v[7] = _vshr<SHIFT>(_vsub(tmp10, btmp3));
+    v[1] = _vshr<SHIFT>(_vadd(tmp11, btmp2));
+    v[6] = _vshr<SHIFT>(_vsub(tmp11, btmp2));
+    v[2] = _vshr<SHIFT>(_vadd(tmp12, btmp1));
+    v[5] = _vshr<SHIFT>(_vsub(tmp12, btmp1));
+    v[3] = _vshr<SHIFT>(_vadd(tmp13, btmp0));
+    v[4] = _vshr<SHIFT>(_vsub(tmp13, btmp0));
+}
+
+
+//the rows 4~7 are skipped unless full, they are zero if the block has no more than 4 nonzero rows
+static void _vidct(const jpgd_block_t* pSrc, uint8_t* pDst, bool full)
+{
+    //row pass: the lanes are the rows 0~3 and 4~7
+    JpgdVector r0[8], r1[8];
+
+    for (int i = 0; i < 4; ++i) _vload(pSrc + i * 8, r0[i], r0[i + 4]);
+    _vtranspose(r0[0], r0[1], r0[2], r0[3]);
+    _vtranspose(r0[4], r0[5], r0[6], r0[7]);
+    _vidct8<CONST_BITS-PASS1_BITS, (SCALEDONE << (CONST_BITS-PASS1_BITS-1))>(r0);
+
+    if (full) {
+        for (int i = 0; i < 4; ++i) _vload(pSrc + (i + 4) * 8, r1[i], r1[i + 4]);
+        _vtranspose(r1[0], r1[1], r1[2], r1[3]);
+        _vtranspose(r1[4], r1[5], r1[6], r1[7]);
+        _vidct8<CONST_BITS-PASS1_BITS, (SCALEDONE << (CONST_BITS-PASS1_BITS-1))>(r1);
+    } else {
+        for (int i = 0; i < 8; ++i) r1[i] = _vset(0);
+    }
+
+    //column pass: the lanes are the columns 0~3 and 4~7
+    JpgdVector c0[8] = {r0[0], r0[1], r0[2], r0[3], r1[0], r1[1], r1[2], r1[3]};
+    JpgdVector c1[8] = {r0[4], r0[5], r0[6], r0[7], r1[4], r1[5], r1[6], r1[7]};
+
+    _vtranspose(c0[0], c0[1], c0[2], c0[3]);
+    _vtranspose(c0[4], c0[5], c0[6], c0[7]);
+    _vtranspose(c1[0], c1[1], c1[2], c1[3]);
+    _vtranspose(c1[4], c1[5], c1[6], c1[7]);
+    _vidct8<CONST_BITS+PASS1_BITS+3, (128 << (CONST_BITS+PASS1_BITS+3)) + (SCALEDONE << (CONST_BITS+PASS1_BITS+2))>(c0);
+    _vidct8<CONST_BITS+PASS1_BITS+3, (128 << (CONST_BITS+PASS1_BITS+3)) + (SCALEDONE << (CONST_BITS+PASS1_BITS+2))>(c1);
+
+    for (int i = 0; i < 8; ++i) _vstore(pDst + i * 8, c0[i], c1[i]);
+}
+
+#endif //THORVG_JPGD_VECTOR_SUPPORT
+
+
 void idct(const jpgd_block_t* pSrc_ptr, uint8_t* pDst_ptr, int block_max_zag)
 {
     JPGD_ASSERT(block_max_zag >= 1);
@@ -550,6 +754,14 @@ void idct(const jpgd_block_t* pSrc_ptr, uint8_t* pDst_ptr, int block_max_zag)
       return;
     }
 
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+    //the templates are cheaper for a single ac coefficient in the first row
+    if (block_max_zag > 2) {
+        _vidct(pSrc_ptr, pDst_ptr, s_idct_col_table[block_max_zag - 1] > 4);
+        return;
+    }
+#endif
+
     int temp[64];
     const jpgd_block_t* pSrc = pSrc_ptr;
     int* pTemp = temp;
@@ -1486,6 +1698,7 @@ void jpeg_decoder::init(jpeg_decoder_stream *pStream)
     m_pMem_blocks = nullptr;
     m_error_code = JPGD_SUCCESS;
     m_ready_flag = false;
+    m_dc_only = false;
     m_image_x_size = m_image_y_size = 0;
     m_pStream = pStream;
     m_progressive_flag = false;
@@ -1627,7 +1840,7 @@ void jpeg_decoder::transform_mcu(int mcu_row)
     uint8_t* pDst_ptr = m_pSample_buf + mcu_row * m_blocks_per_mcu * 64;
 
     for (int mcu_block = 0; mcu_block < m_blocks_per_mcu; mcu_block++) {
-        idct(pSrc_ptr, pDst_ptr, m_mcu_block_max_zag[mcu_block]);
+        idct(pSrc_ptr, pDst_ptr, m_dc_only ? 1 : m_mcu_block_max_zag[mcu_block]);
         pSrc_ptr += 64;
         pDst_ptr += 64;
     }
@@ -1651,11 +1864,23 @@ void jpeg_decoder::transform_mcu_expand(int mcu_row)
     // Y IDCT
     int mcu_block;
     for (mcu_block = 0; mcu_block < m_expanded_blocks_per_component; mcu_block++) {
-        idct(pSrc_ptr, pDst_ptr, m_mcu_block_max_zag[mcu_block]);
+        idct(pSrc_ptr, pDst_ptr, m_dc_only ? 1 : m_mcu_block_max_zag[mcu_block]);
         pSrc_ptr += 64;
         pDst_ptr += 64;
     }
 
+    // Chroma DC only, each block spreads over the 4 expanded blocks.
+    if (m_dc_only) {
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 4; j++) {
+                idct(pSrc_ptr, pDst_ptr, 1);
+                pDst_ptr += 64;
+            }
+            pSrc_ptr += 64;
+        }
+        return;
+    }
+
     // Chroma IDCT, with upsampling
     jpgd_block_t temp_block[64];
 
@@ -1758,7 +1983,7 @@ void jpeg_decoder::transform_mcu_expand(int mcu_row)
 
 
 // Loads and dequantizes the next row of (already decoded) coefficients.
-// Progressive images only.
+// Progressive images, or the baseline ones decoded in parallel.
 void jpeg_decoder::load_next_row()
 {
     int i;
@@ -1797,10 +2022,12 @@ void jpeg_decoder::load_next_row()
 
             if (m_comps_in_scan == 1) block_x_mcu[component_id]++;
             else {
-                if (++block_x_mcu_ofs == m_comp_h_samp[component_id]) block_x_mcu_ofs = 0;
-                if (++block_y_mcu_ofs == m_comp_v_samp[component_id]) {
-                    block_y_mcu_ofs = 0;
-                    block_x_mcu[component_id] += m_comp_h_samp[component_id];
+                if (++block_x_mcu_ofs == m_comp_h_samp[component_id]) {
+                    block_x_mcu_ofs = 0;
+                    if (++block_y_mcu_ofs == m_comp_v_samp[component_id]) {
+                        block_y_mcu_ofs = 0;
+                        block_x_mcu[component_id] += m_comp_h_samp[component_id];
+                    }
                 }
             }
         }
@@ -1940,6 +2167,104 @@ bool jpeg_decoder::decode_next_row()
 }
 
 
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+
+/* The chroma terms of 8 pixels are computed exactly as the m_crr/m_crg/m_cbg/m_cbb tables,
+   with the factors over 16 bits split into multiples of 65536 and a 16 bit remainder:
+   crr = kr + ((26345 * kr + 32768) >> 16), cbb = 2 * kb + ((-14942 * kb + 32768) >> 16),
+   (crg + cbg) >> 16 = ((18734 * kr - 22554 * kb + 32768) >> 16) - kr */
+
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+
+using JpgdPixels = __m128i;
+
+//(a * ca + b * cb + 32768) >> 16
+static inline JpgdPixels _vmadd(JpgdPixels a, JpgdPixels b, int16_t ca, int16_t cb)
+{
+    auto k = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)cb << 16) | (uint16_t)ca));
+    auto bias = _mm_set1_epi32(32768);
+    auto lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), k), bias);
+    auto hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), k), bias);
+    return _mm_packs_epi32(_mm_srai_epi32(lo, 16), _mm_srai_epi32(hi, 16));
+}
+
+static inline void _vchroma(const uint8_t* cb, const uint8_t* cr, JpgdPixels& rc, JpgdPixels& gc, JpgdPixels& bc)
+{
+    auto k = _mm_set1_epi16(128);
+    auto kb = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)cb)), k);
+    auto kr = _mm_sub_epi16(_mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)cr)), k);
+    rc = _mm_add_epi16(kr, _vmadd(kr, kb, 26345, 0));
+    gc = _mm_sub_epi16(_vmadd(kr, kb, 18734, -22554), kr);
+    bc = _mm_add_epi16(_mm_add_epi16(kb, kb), _vmadd(kr, kb, 0, -14942));
+}
+
+//doubles the chroma terms horizontally
+static inline void _vexpand(JpgdPixels c, JpgdPixels& lo, JpgdPixels& hi)
+{
+    lo = _mm_unpacklo_epi16(c, c);
+    hi = _mm_unpackhi_epi16(c, c);
+}
+
+//converts 8 pixels to rgba
+static inline void _vconvert(uint8_t* d, const uint8_t* y, JpgdPixels rc, JpgdPixels gc, JpgdPixels bc)
+{
+    auto l = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)y));
+    auto rb = _mm_packus_epi16(_mm_add_epi16(l, rc), _mm_add_epi16(l, bc));
+    auto ga = _mm_packus_epi16(_mm_add_epi16(l, gc), _mm_set1_epi16(255));
+    auto rg = _mm_unpacklo_epi8(rb, ga);
+    auto ba = _mm_unpackhi_epi8(rb, ga);
+    _mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi16(rg, ba));
+}
+
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+
+using JpgdPixels = int16x8_t;
+
+//(a * ca + b * cb + 32768) >> 16
+static inline JpgdPixels _vmadd(JpgdPixels a, JpgdPixels b, int16_t ca, int16_t cb)
+{
+    auto bias = vdupq_n_s32(32768);
+    auto lo = vmlal_n_s16(vmlal_n_s16(bias, vget_low_s16(a), ca), vget_low_s16(b), cb);
+    auto hi = vmlal_n_s16(vmlal_n_s16(bias, vget_high_s16(a), ca), vget_high_s16(b), cb);
+    return vcombine_s16(vshrn_n_s32(lo, 16), vshrn_n_s32(hi, 16));
+}
+
+static inline void _vchroma(const uint8_t* cb, const uint8_t* cr, JpgdPixels& rc, JpgdPixels& gc, JpgdPixels& bc)
+{
+    auto k = vdup_n_u8(128);
+    auto kb = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(cb), k));
+    auto kr = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(cr), k));
+    rc = vaddq_s16(kr, _vmadd(kr, kb, 26345, 0));
+    gc = vsubq_s16(_vmadd(kr, kb, 18734, -22554), kr);
+    bc = vaddq_s16(vaddq_s16(kb, kb), _vmadd(kr, kb, 0, -14942));
+}
+
+//doubles the chroma terms horizontally
+static inline void _vexpand(JpgdPixels c, JpgdPixels& lo, JpgdPixels& hi)
+{
+    auto z = vzipq_s16(c, c);
+    lo = z.val[0];
+    hi = z.val[1];
+}
+
+//converts 8 pixels to rgba
+static inline void _vconvert(uint8_t* d, const uint8_t* y, JpgdPixels rc, JpgdPixels gc, JpgdPixels bc)
+{
+    auto l = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y)));
+    uint8x8x4_t p;
+    p.val[0] = vqmovun_s16(vaddq_s16(l, rc));
+    p.val[1] = vqmovun_s16(vaddq_s16(l, gc));
+    p.val[2] = vqmovun_s16(vaddq_s16(l, bc));
+    p.val[3] = vdup_n_u8(255);
+    vst4_u8(d, p);
+}
+
+#endif
+
+#endif //THORVG_JPGD_VECTOR_SUPPORT
+
+
 // YCbCr H1V1 (1x1:1:1, 3 m_blocks per MCU) to RGB
 void jpeg_decoder::H1V1Convert()
 {
@@ -1948,6 +2273,12 @@ void jpeg_decoder::H1V1Convert()
     uint8_t *s = m_pSample_buf + row * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+        JpgdPixels rc, gc, bc;
+        _vchroma(s + 64, s + 128, rc, gc, bc);
+        _vconvert(d, s, rc, gc, bc);
+        d += 32;
+#else
         for (int j = 0; j < 8; j++) {
             int y = s[j];
             int cb = s[64+j];
@@ -1959,6 +2290,7 @@ void jpeg_decoder::H1V1Convert()
             d[3] = 255;
             d += 4;
         }
+#endif
         s += 64*3;
     }
 }
@@ -1973,6 +2305,22 @@ void jpeg_decoder::H2V1Convert()
     uint8_t *c = m_pSample_buf + 2*64 + row * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+        JpgdPixels rc[2], gc[2], bc[2];
+        {
+            JpgdPixels r, g, b;
+            _vchroma(c, c + 64, r, g, b);
+            _vexpand(r, rc[0], rc[1]);
+            _vexpand(g, gc[0], gc[1]);
+            _vexpand(b, bc[0], bc[1]);
+        }
+        for (int l = 0; l < 2; l++) {
+            _vconvert(d0, y, rc[l], gc[l], bc[l]);
+            d0 += 32;
+            y += 64;
+        }
+        c += 8;
+#else
         for (int l = 0; l < 2; l++) {
             for (int j = 0; j < 4; j++) {
                 int cb = c[0];
@@ -1998,6 +2346,7 @@ void jpeg_decoder::H2V1Convert()
             }
             y += 64;
         }
+#endif
         y += 64*4 - 64*2;
         c += 64*4 - 8;
     }
@@ -2019,6 +2368,14 @@ void jpeg_decoder::H1V2Convert()
     c = m_pSample_buf + 64*2 + (row >> 1) * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+        JpgdPixels rc, gc, bc;
+        _vchroma(c, c + 64, rc, gc, bc);
+        _vconvert(d0, y, rc, gc, bc);
+        _vconvert(d1, y + 8, rc, gc, bc);
+        d0 += 32;
+        d1 += 32;
+#else
         for (int j = 0; j < 8; j++) {
             int cb = c[0+j];
             int cr = c[64+j];
@@ -2042,6 +2399,7 @@ void jpeg_decoder::H1V2Convert()
             d0 += 4;
             d1 += 4;
         }
+#endif
         y += 64*4;
         c += 64*4;
     }
@@ -2063,6 +2421,24 @@ void jpeg_decoder::H2V2Convert()
     c = m_pSample_buf + 64*4 + (row >> 1) * 8;
 
     for (int i = m_max_mcus_per_row; i > 0; i--) {
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+        JpgdPixels rc[2], gc[2], bc[2];
+        {
+            JpgdPixels r, g, b;
+            _vchroma(c, c + 64, r, g, b);
+            _vexpand(r, rc[0], rc[1]);
+            _vexpand(g, gc[0], gc[1]);
+            _vexpand(b, bc[0], bc[1]);
+        }
+        for (int l = 0; l < 2; l++) {
+            _vconvert(d0, y, rc[l], gc[l], bc[l]);
+            _vconvert(d1, y + 8, rc[l], gc[l], bc[l]);
+            d0 += 32;
+            d1 += 32;
+            y += 64;
+        }
+        c += 8;
+#else
         for (int l = 0; l < 2; l++) {
             for (int j = 0; j < 8; j += 2) {
                 int cb = c[0];
@@ -2103,6 +2479,7 @@ void jpeg_decoder::H2V2Convert()
             }
             y += 64;
         }
+#endif
         y += 64*6 - 64*2;
         c += 64*6 - 8;
     }
@@ -2136,6 +2513,12 @@ void jpeg_decoder::expanded_convert()
             const int Y_ofs = k * 8;
             const int Cb_ofs = Y_ofs + 64 * m_expanded_blocks_per_component;
             const int Cr_ofs = Y_ofs + 64 * m_expanded_blocks_per_component * 2;
+#ifdef THORVG_JPGD_VECTOR_SUPPORT
+            JpgdPixels rc, gc, bc;
+            _vchroma(Py + Cb_ofs, Py + Cr_ofs, rc, gc, bc);
+            _vconvert(d, Py + Y_ofs, rc, gc, bc);
+            d += 32;
+#else
             for (int j = 0; j < 8; j++) {
                 int y = Py[Y_ofs + j];
                 int cb = Py[Cb_ofs + j];
@@ -2148,6 +2531,7 @@ void jpeg_decoder::expanded_convert()
 
                 d += 4;
             }
+#endif
         }
         Py += 64 * m_expanded_blocks_per_mcu;
     }
@@ -2173,6 +2557,46 @@ void jpeg_decoder::find_eoi()
 }
 
 
+// Converts the line of the transformed mcu row given by m_mcu_lines_left.
+const uint8_t* jpeg_decoder::convert_line()
+{
+    if (m_freq_domain_chroma_upsample) {
+        expanded_convert();
+        return m_pScan_line_0;
+    }
+
+    switch (m_scan_type) {
+        case JPGD_YH2V2: {
+            if ((m_mcu_lines_left & 1) == 0) {
+                H2V2Convert();
+                return m_pScan_line_0;
+            }
+            return m_pScan_line_1;
+        }
+        case JPGD_YH2V1: {
+            H2V1Convert();
+            return m_pScan_line_0;
+        }
+        case JPGD_YH1V2: {
+            if ((m_mcu_lines_left & 1) == 0) {
+                H1V2Convert();
+                return m_pScan_line_0;
+            }
+            return m_pScan_line_1;
+        }
+        case JPGD_YH1V1: {
+            H1V1Convert();
+            return m_pScan_line_0;
+        }
+        case JPGD_GRAYSCALE: {
+            gray_convert();
+            return m_pScan_line_0;
+        }
+    }
+    return nullptr;
+}
+
+
 int jpeg_decoder::decode(const void** pScan_line, uint32_t* pScan_line_len)
 {
     if ((m_error_code) || (!m_ready_flag)) return JPGD_FAILED;
@@ -2185,44 +2609,7 @@ int jpeg_decoder::decode(const void** pScan_line, uint32_t* pScan_line_len)
         m_mcu_lines_left = m_max_mcu_y_size;
     }
 
-    if (m_freq_domain_chroma_upsample) {
-        expanded_convert();
-        *pScan_line = m_pScan_line_0;
-    } else {
-        switch (m_scan_type) {
-            case JPGD_YH2V2: {
-                if ((m_mcu_lines_left & 1) == 0) {
-                    H2V2Convert();
-                    *pScan_line = m_pScan_line_0;
-                }
-              else *pScan_line = m_pScan_line_1;
-              break;
-            }
-            case JPGD_YH2V1: {
-                H2V1Convert();
-                *pScan_line = m_pScan_line_0;
-                break;
-            }
-            case JPGD_YH1V2: {
-                if ((m_mcu_lines_left & 1) == 0) {
-                    H1V2Convert();
-                    *pScan_line = m_pScan_line_0;
-                } else *pScan_line = m_pScan_line_1;
-                break;
-            }
-            case JPGD_YH1V1: {
-                H1V1Convert();
-                *pScan_line = m_pScan_line_0;
-                break;
-            }
-            case JPGD_GRAYSCALE: {
-                gray_convert();
-                *pScan_line = m_pScan_line_0;
-                break;
-            }
-        }
-    }
-
+    *pScan_line = convert_line();
     *pScan_line_len = m_real_dest_bytes_per_scan_line;
     m_mcu_lines_left--;
     m_total_lines_left--;
@@ -2909,6 +3296,489 @@ int jpeg_decoder_mem_stream::read(uint8_t *pBuf, int max_bytes_to_read, bool *pE
 }
 
 
+void jpgd_writer::write(const uint8_t* pScan_line, int y, uint8_t* pRow, uint32_t* pSum) const
+{
+    uint8_t *pDst = (shift > 0) ? pRow : pImage_data + y * dst_bpl;
+
+    //Return as BGRA
+    if ((req_comps == 4) && (comps == 3) && !rgba) {
+        for (int x = 0; x < image_width; x++) {
+            pDst[0] = pScan_line[x*4+2];
+            pDst[1] = pScan_line[x*4+1];
+            pDst[2] = pScan_line[x*4+0];
+            pDst[3] = 255;
+            pDst += 4;
+        }
+    } else if (((req_comps == 1) && (comps == 1)) || ((req_comps == 4) && (comps == 3))) {
+        memcpy(pDst, pScan_line, image_width * req_comps);
+    } else if (comps == 1) {
+        if (req_comps == 3) {
+            for (int x = 0; x < image_width; x++) {
+                uint8_t luma = pScan_line[x];
+                pDst[0] = luma;
+                pDst[1] = luma;
+                pDst[2] = luma;
+                pDst += 3;
+            }
+        } else {
+            for (int x = 0; x < image_width; x++) {
+                uint8_t luma = pScan_line[x];
+                pDst[0] = luma;
+                pDst[1] = luma;
+                pDst[2] = luma;
+                pDst[3] = 255;
+                pDst += 4;
+            }
+        }
+    } else if (comps == 3) {
+        if (req_comps == 1) {
+            const int YR = 19595, YG = 38470, YB = 7471;
+            for (int x = 0; x < image_width; x++) {
+                int r = pScan_line[x*4+0];
+                int g = pScan_line[x*4+1];
+                int b = pScan_line[x*4+2];
+                *pDst++ = static_cast<uint8_t>((r * YR + g * YG + b * YB + 32768) >> 16);
+            }
+        } else {
+            for (int x = 0; x < image_width; x++) {
+                pDst[0] = pScan_line[x*4+0];
+                pDst[1] = pScan_line[x*4+1];
+                pDst[2] = pScan_line[x*4+2];
+                pDst += 3;
+            }
+        }
+    }
+
+    if (shift == 0) return;
+
+    pDst = pImage_data + (y >> shift) * dst_bpl;
+
+    if (shift == 3) {
+        for (int x = 0; x < dst_width; x++) {
+            memcpy(pDst + x * 4, pRow + (x << shift) * 4, 4);
+        }
+        return;
+    }
+
+    //accumulate the rows and flush out the averages at the end of every row group.
+    for (int x = 0; x < image_width; x++) {
+        auto pS = pSum + (x >> shift) * 4;
+        pS[0] += pRow[x*4+0];
+        pS[1] += pRow[x*4+1];
+        pS[2] += pRow[x*4+2];
+        pS[3] += pRow[x*4+3];
+    }
+
+    const int mask = (1 << shift) - 1;
+    if ((y & mask) != mask && y != image_height - 1) return;
+
+    const uint32_t rows = (y & mask) + 1;
+    for (int x = 0; x < dst_width; x++) {
+        const uint32_t cols = (x < dst_width - 1) ? (1 << shift) : image_width - (x << shift);
+        const uint32_t cnt = rows * cols;
+        for (int c = 0; c < 4; c++) {
+            pDst[x*4+c] = static_cast<uint8_t>((pSum[x*4+c] + cnt / 2) / cnt);
+        }
+    }
+    memset(pSum, 0, dst_bpl * sizeof(uint32_t));
+}
+
+
+#ifdef THORVG_THREAD_SUPPORT
+
+/* The baseline images are decoded in two stages: the entropy decoding stores the quantized coefficients
+   as the progressive scans do, then the rows of them are dequantized, transformed and converted by load_next_row().
+   The coefficient rows wrap around a ring buffer. The short restart segments are entropy decoded on the workers
+   a window at a time, otherwise the requester decodes the rows ahead while the workers transform the previous ones. */
+
+#define JPGD_PARALLEL_MIN_PIXELS (512 * 512)   //the smaller images are not worth the workers
+#define JPGD_PARALLEL_BAND 2                   //the mcu rows per task
+#define JPGD_PARALLEL_RING 2                   //the bands of the ring buffer per thread
+
+// The scratch state of a thread, the decoder is a copy sharing the tables and the coefficients.
+struct jpeg_decoder::worker
+{
+    jpeg_decoder* decoder = nullptr;
+    uint8_t* pRow = nullptr;
+    uint32_t* pSum = nullptr;
+};
+
+
+struct jpeg_decoder::segment_task : Task
+{
+    worker* workers;
+    Array<uint8_t> data;            //the entropy coded bytes of the segments
+    Array<uint32_t> ends;           //the end offsets of the segments in data
+    int first;                      //the first segment
+    int rows;                       //the mcu rows of the coefficient buffers
+    uint32_t bit_buf;               //the bit buffer primed at the start of the scan
+    int bits_left;
+    bool ok = false;
+    atomic<bool> claimed{false};
+
+    segment_task(worker* workers, int first, int rows, uint32_t bit_buf, int bits_left, uint32_t size)
+        : workers(workers), data(size), first(first), rows(rows), bit_buf(bit_buf), bits_left(bits_left) {}
+
+    //either the requester or a worker decodes it, whoever comes first.
+    bool decode(unsigned tid)
+    {
+        if (claimed.exchange(true)) return false;
+        ok = workers[tid].decoder->decode_segments(this);
+        return true;
+    }
+
+    void run(unsigned tid) override
+    {
+        decode(tid);
+    }
+};
+
+
+struct jpeg_decoder::row_task : Task
+{
+    worker* workers;
+    const jpgd_writer* writer;
+    int begin, end;                 //the mcu rows
+    int rows;                       //the mcu rows of the coefficient buffers
+    atomic<bool> claimed{false};
+
+    row_task(worker* workers, const jpgd_writer* writer, int begin, int end, int rows)
+        : workers(workers), writer(writer), begin(begin), end(end), rows(rows) {}
+
+    //either the requester or a worker transforms it, whoever comes first.
+    bool transform(unsigned tid)
+    {
+        if (claimed.exchange(true)) return false;
+        auto& w = workers[tid];
+        w.decoder->transform_rows(begin, end, rows, *writer, w.pRow, w.pSum);
+        return true;
+    }
+
+    void run(unsigned tid) override
+    {
+        transform(tid);
+    }
+};
+
+
+// Copies the decoder for a thread, it allocates its own sample buffers and reads from its own stream.
+jpeg_decoder* jpeg_decoder::fork()
+{
+    auto decoder = new jpeg_decoder(*this);
+    decoder->m_pMem_blocks = nullptr;
+    decoder->m_pStream = new jpeg_decoder_mem_stream;
+    decoder->m_pIn_buf_ofs = decoder->m_in_buf + (m_pIn_buf_ofs - m_in_buf);
+    decoder->m_pScan_line_0 = (uint8_t *)decoder->alloc(m_dest_bytes_per_scan_line, true);
+    if (m_pScan_line_1) decoder->m_pScan_line_1 = (uint8_t *)decoder->alloc(m_dest_bytes_per_scan_line, true);
+    decoder->m_pMCU_coefficients = (jpgd_block_t*)decoder->alloc(m_max_blocks_per_mcu * 64 * sizeof(jpgd_block_t));
+    decoder->m_pSample_buf = (uint8_t *)decoder->alloc((m_freq_domain_chroma_upsample ? m_expanded_blocks_per_row : m_max_blocks_per_row) * 64);
+    return decoder;
+}
+
+
+// Reads the entropy coded bytes up to the next marker, and returns the marker.
+int jpeg_decoder::read_segment(Array<uint8_t>& data)
+{
+    while (!m_error_code) {
+        if (m_in_buf_left == 0) {
+            if (!prep_in_buffer()) break;
+            if (m_in_buf_left == 0) return M_EOI;
+        }
+        auto marker = (uint8_t*)memchr(m_pIn_buf_ofs, 0xFF, m_in_buf_left);
+        auto n = marker ? uint32_t(marker - m_pIn_buf_ofs) : uint32_t(m_in_buf_left);
+        data.grow(n);
+        memcpy(data.data + data.count, m_pIn_buf_ofs, n);
+        data.count += n;
+        m_pIn_buf_ofs += n;
+        m_in_buf_left -= n;
+        if (!marker) continue;
+
+        get_char();
+        auto c = get_char();
+        if (c == 0x00) {
+            data.push(0xFF);
+            data.push(0x00);
+            continue;
+        }
+        while (c == 0xFF) c = get_char();
+        //keep the marker, the bit reader stops at it just like in the whole stream.
+        data.push(0xFF);
+        data.push(uint8_t(c));
+        return c;
+    }
+    return M_EOI;
+}
+
+
+/* Decodes the mcus [mcu, mcu + count) in the raster order without dequantizing them, into the coefficient buffers
+   of the given mcu rows which the rows of the image wrap around. */
+bool jpeg_decoder::decode_mcus(int mcu, int count, int rows)
+{
+    for (; count > 0; --count, ++mcu) {
+        //the pipelined rows cross the restart markers, the segments decoded apart never do.
+        if (m_restart_interval) {
+            if (m_restarts_left == 0 && !process_restart()) return false;
+            m_restarts_left--;
+        }
+
+        const int mcu_x = mcu % m_mcus_per_row;
+        const int mcu_y = (mcu / m_mcus_per_row) % rows;
+        int block_x_mcu_ofs = 0, block_y_mcu_ofs = 0;
+
+        for (int mcu_block = 0; mcu_block < m_blocks_per_mcu; mcu_block++) {
+            int component_id = m_mcu_org[mcu_block];
+            jpgd_block_t* p = coeff_buf_getp(m_ac_coeffs[component_id], mcu_x * m_comp_h_samp[component_id] + block_x_mcu_ofs, mcu_y * m_comp_v_samp[component_id] + block_y_mcu_ofs);
+            memset(p, 0, 64 * sizeof(jpgd_block_t));
+
+            int r, s;
+            s = huff_decode(m_pHuff_tabs[m_comp_dc_tab[component_id]], r);
+            s = JPGD_HUFF_EXTEND(r, s);
+
+            m_last_dc_val[component_id] = (s += m_last_dc_val[component_id]);
+            p[0] = static_cast<jpgd_block_t>(s);
+
+            huff_tables *pH = m_pHuff_tabs[m_comp_ac_tab[component_id]];
+            for (int k = 1; k < 64; k++) {
+                int extra_bits;
+                s = huff_decode(pH, extra_bits);
+                r = s >> 4;
+                s &= 15;
+
+                if (s) {
+                    if (r) {
+                        if ((k + r) > 63) return false;
+                        k += r;
+                    }
+                    p[g_ZAG[k]] = static_cast<jpgd_block_t>(JPGD_HUFF_EXTEND(extra_bits, s));
+                } else {
+                    if (r == 15) {
+                        if ((k + 16) > 64) return false;
+                        k += 16 - 1; // - 1 because the loop counter is k
+                    } else break;
+                }
+            }
+
+            if (m_comps_in_scan > 1 && ++block_x_mcu_ofs == m_comp_h_samp[component_id]) {
+                block_x_mcu_ofs = 0;
+                if (++block_y_mcu_ofs == m_comp_v_samp[component_id]) block_y_mcu_ofs = 0;
+            }
+        }
+    }
+    return true;
+}
+
+
+// Decodes the restart segments of the task, each of them starts over the bit buffer and the dc predictions.
+bool jpeg_decoder::decode_segments(segment_task* task)
+{
+    if (m_error_code) return false;
+
+    const int total = m_mcus_per_row * m_mcus_per_col;
+    uint32_t begin = 0;
+
+    for (uint32_t i = 0; i < task->ends.count; ++i) {
+        auto segment = task->first + int(i);
+        static_cast<jpeg_decoder_mem_stream*>(m_pStream)->open(task->data.data + begin, task->ends[i] - begin);
+        begin = task->ends[i];
+
+        m_in_buf_left = 0;
+        m_pIn_buf_ofs = m_in_buf;
+        m_eof_flag = false;
+        m_tem_flag = 0;
+
+        if (segment == 0) {
+            m_bit_buf = task->bit_buf;
+            m_bits_left = task->bits_left;
+        } else {
+            m_bits_left = 16;
+            get_bits_no_markers(16);
+            get_bits_no_markers(16);
+        }
+        memset(&m_last_dc_val, 0, m_comps_in_frame * sizeof(uint32_t));
+        m_restarts_left = m_restart_interval;
+
+        auto mcu = segment * m_restart_interval;
+        if (!decode_mcus(mcu, JPGD_MIN(m_restart_interval, total - mcu), task->rows)) return false;
+        if (m_error_code) return false;
+    }
+    return true;
+}
+
+
+// Transforms the mcu rows [begin, end) and writes their scan lines.
+void jpeg_decoder::transform_rows(int begin, int end, int rows, const jpgd_writer& writer, uint8_t* pRow, uint32_t* pSum)
+{
+    for (int row = begin; row < end; ++row) {
+        for (int i = 0; i < m_comps_in_scan; ++i) {
+            auto component_id = m_comp_list[i];
+            m_block_y_mcu[component_id] = (row % rows) * m_comp_v_samp[component_id];
+        }
+        load_next_row();
+
+        auto y = row * m_max_mcu_y_size;
+        for (m_mcu_lines_left = m_max_mcu_y_size; m_mcu_lines_left > 0 && y < m_image_y_size; --m_mcu_lines_left, ++y) {
+            if (writer.skip(y)) continue;
+            writer.write(convert_line(), y, pRow, pSum);
+        }
+    }
+}
+
+
+bool jpeg_decoder::parallel() const
+{
+    if (TaskScheduler::threads() == 0 || TaskScheduler::onthread()) return false;
+    if (m_image_x_size * m_image_y_size < JPGD_PARALLEL_MIN_PIXELS) return false;
+    //the components in separate scans are not supported by the baseline decoding either
+    return m_comps_in_scan == m_comps_in_frame;
+}
+
+
+bool jpeg_decoder::decode_parallel(const jpgd_writer& writer)
+{
+    if ((m_error_code) || (!m_ready_flag)) return false;
+
+    const auto count = TaskScheduler::threads() + 1;
+    const int total_rows = m_mcus_per_col;
+    auto rows = total_rows;
+
+    //the short restart segments are decoded on the workers, the images with the longer ones are pipelined like the others.
+    const auto segmented = !m_progressive_flag && m_restart_interval && m_restart_interval <= m_mcus_per_row * JPGD_PARALLEL_BAND;
+    const int batch = segmented ? JPGD_MAX(1, m_mcus_per_row * JPGD_PARALLEL_BAND / m_restart_interval) : 0;  //the segments per task
+    const int window = batch * int(count);  //the segments decoded at once
+
+    //the baseline coefficients, the dc ones are at the first of the blocks
+    if (!m_progressive_flag) {
+        //the rows of the two windows in flight, one of them could be shared by both.
+        if (segmented) rows = JPGD_MIN(total_rows, 2 * ((window * m_restart_interval + m_mcus_per_row - 1) / m_mcus_per_row + 1));
+        else rows = JPGD_MIN(total_rows, int(count) * JPGD_PARALLEL_RING * JPGD_PARALLEL_BAND);
+        for (int i = 0; i < m_comps_in_frame; i++) {
+            m_ac_coeffs[i] = m_dc_coeffs[i] = coeff_buf_open(m_max_mcus_per_row * m_comp_h_samp[i], rows * m_comp_v_samp[i], 8, 8);
+        }
+    }
+
+    //the stream moves on to the reader, the entropy decoding errors don't free the shared tables there.
+    auto reader = fork();
+    delete(reader->m_pStream);
+    reader->m_pStream = m_pStream;
+    m_pStream = nullptr;
+
+    auto workers = new worker[count];
+    for (uint32_t i = 0; i < count; ++i) {
+        workers[i].decoder = fork();
+        if (writer.shift > 0) {
+            workers[i].pRow = tvg::malloc<uint8_t*>(writer.image_width * writer.req_comps);
+            workers[i].pSum = tvg::calloc<uint32_t*>(writer.dst_bpl, sizeof(uint32_t));
+        }
+    }
+
+    auto ok = true;
+    Array<row_task*> tasks;
+
+    if (segmented) {
+        /* The restart segments are independent. The workers decode a window of them while transforming the rows
+           completed by the previous windows, the reader splits the segments ahead. */
+        const int total = m_mcus_per_row * m_mcus_per_col;
+        const int cnt = (total + m_restart_interval - 1) / m_restart_interval;
+        const auto size = uint32_t(JPGD_MIN(total, batch * m_restart_interval)) * m_blocks_per_mcu * 16;
+        int segment = 0;
+        int transformed = 0;
+
+        while (ok && transformed < total_rows) {
+            auto complete = (segment >= cnt) ? total_rows : segment * m_restart_interval / m_mcus_per_row;
+            Array<segment_task*> segments;
+            Array<row_task*> bands;
+
+            for (auto last = JPGD_MIN(segment + window, cnt); segment < last && ok; ) {
+                auto task = new segment_task(workers, segment, rows, reader->m_bit_buf, reader->m_bits_left, size);
+                for (int i = 0; i < batch && segment < cnt; ++i, ++segment) {
+                    auto marker = reader->read_segment(task->data);
+                    task->ends.push(task->data.count);
+                    //every segment but the last ends with the next restart marker
+                    if (segment < cnt - 1 && marker != M_RST0 + (segment & 7)) {
+                        ok = false;
+                        break;
+                    }
+                }
+                segments.push(task);
+                if (ok) TaskScheduler::request(task);
+            }
+            for (; transformed < complete; transformed += JPGD_PARALLEL_BAND) {
+                auto task = new row_task(workers, &writer, transformed, JPGD_MIN(transformed + JPGD_PARALLEL_BAND, complete), rows);
+                bands.push(task);
+                TaskScheduler::request(task);
+            }
+            transformed = complete;
+
+            //take over the tasks not started yet
+            ARRAY_FOREACH(p, segments) {
+                if (ok) (*p)->decode(0);
+            }
+            ARRAY_FOREACH(p, bands) {
+                (*p)->transform(0);
+            }
+            ARRAY_FOREACH(p, segments) {
+                (*p)->done();
+                ok &= (*p)->ok;
+                delete(*p);
+            }
+            ARRAY_FOREACH(p, bands) {
+                (*p)->done();
+                delete(*p);
+            }
+        }
+    } else if (!m_progressive_flag) {
+        //the coefficient rows are reused once their transform is over.
+        const int ring = rows / JPGD_PARALLEL_BAND;
+        for (int row = 0; row < total_rows; row += JPGD_PARALLEL_BAND) {
+            if (int(tasks.count) >= ring) {
+                auto task = tasks[tasks.count - ring];
+                if (!task->transform(0)) task->done();
+            }
+            auto end = JPGD_MIN(row + JPGD_PARALLEL_BAND, total_rows);
+            if (!reader->decode_mcus(row * m_mcus_per_row, (end - row) * m_mcus_per_row, rows) || reader->m_error_code) {
+                ok = false;
+                break;
+            }
+            auto task = new row_task(workers, &writer, row, end, rows);
+            tasks.push(task);
+            TaskScheduler::request(task);
+        }
+    }
+
+    //the progressive coefficients are all ready
+    if (ok && m_progressive_flag) {
+        for (int row = 0; row < total_rows; row += JPGD_PARALLEL_BAND) {
+            auto task = new row_task(workers, &writer, row, JPGD_MIN(row + JPGD_PARALLEL_BAND, total_rows), rows);
+            tasks.push(task);
+            TaskScheduler::request(task);
+        }
+    }
+
+    //take over the tasks not started yet
+    ARRAY_FOREACH(p, tasks) {
+        if (ok) (*p)->transform(0);
+    }
+    ARRAY_FOREACH(p, tasks) {
+        (*p)->done();
+        delete(*p);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        delete(workers[i].decoder);
+        tvg::free(workers[i].pRow);
+        tvg::free(workers[i].pSum);
+    }
+    delete[](workers);
+    delete(reader);
+
+    m_total_lines_left = 0;
+    if (!ok) return stop_decoding(JPGD_DECODE_ERROR);
+    return true;
+}
+
+#endif //THORVG_THREAD_SUPPORT
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -2957,81 +3827,63 @@ void jpgdDelete(jpeg_decoder* decoder)
 }
 
 
-unsigned char* jpgdDecompress(jpeg_decoder* decoder)
+unsigned char* jpgdDecompress(jpeg_decoder* decoder, int shift, bool rgba)
 {
     if (!decoder) return nullptr;
 
     int req_comps = 4;  //TODO: fixed 4 channel components now?
     if ((req_comps != 1) && (req_comps != 3) && (req_comps != 4)) return nullptr;
+    if (shift < 0 || shift > 3 || (shift > 0 && req_comps != 4)) return nullptr;
 
     auto image_width = decoder->get_width();
     auto image_height = decoder->get_height();
     //auto actual_comps = decoder->get_num_components();
 
+    //1/8 scaling is done in the DCT domain, the others reduce the rows in the box filter.
+    decoder->set_dc_only(shift == 3);
+
     if (decoder->begin_decoding() != JPGD_SUCCESS) return nullptr;
 
-    const int dst_bpl = image_width * req_comps;
-    uint8_t *pImage_data = tvg::malloc<uint8_t*>(dst_bpl * image_height);
+    const int mask = (1 << shift) - 1;
+    const int dst_width = (image_width + mask) >> shift;
+    const int dst_height = (image_height + mask) >> shift;
+    const int src_bpl = image_width * req_comps;
+    const int dst_bpl = dst_width * req_comps;
+    uint8_t *pImage_data = tvg::malloc<uint8_t*>(dst_bpl * dst_height);
     if (!pImage_data) return nullptr;
 
+    jpgd_writer writer = {pImage_data, image_width, image_height, dst_width, dst_bpl, decoder->get_num_components(), req_comps, shift, rgba};
+
+#ifdef THORVG_THREAD_SUPPORT
+    if (decoder->parallel()) {
+        if (decoder->decode_parallel(writer)) return pImage_data;
+        tvg::free(pImage_data);
+        return nullptr;
+    }
+#endif
+
+    uint8_t* pRow = nullptr;       //the converted scan line to be reduced
+    uint32_t* pSum = nullptr;      //the channel sums of the reduced row
+    if (shift > 0) {
+        pRow = tvg::malloc<uint8_t*>(src_bpl);
+        pSum = tvg::calloc<uint32_t*>(dst_bpl, sizeof(uint32_t));
+    }
+
     for (int y = 0; y < image_height; y++) {
         const uint8_t* pScan_line = nullptr;
         uint32_t scan_line_len;
         if (decoder->decode((const void**)&pScan_line, &scan_line_len) != JPGD_SUCCESS) {
             tvg::free(pImage_data);
+            tvg::free(pRow);
+            tvg::free(pSum);
             return nullptr;
         }
+        if (writer.skip(y)) continue;
+        writer.write(pScan_line, y, pRow, pSum);
+    }
 
-        uint8_t *pDst = pImage_data + y * dst_bpl;
+    tvg::free(pRow);
+    tvg::free(pSum);
 
-        //Return as BGRA
-        if ((req_comps == 4) && (decoder->get_num_components() == 3)) {
-            for (int x = 0; x < image_width; x++) {
-                pDst[0] = pScan_line[x*4+2];
-                pDst[1] = pScan_line[x*4+1];
-                pDst[2] = pScan_line[x*4+0];
-                pDst[3] = 255;
-                pDst += 4;
-            }
-        } else if (((req_comps == 1) && (decoder->get_num_components() == 1)) || ((req_comps == 4) && (decoder->get_num_components() == 3))) {
-            memcpy(pDst, pScan_line, dst_bpl);
-        } else if (decoder->get_num_components() == 1) {
-            if (req_comps == 3) {
-                for (int x = 0; x < image_width; x++) {
-                    uint8_t luma = pScan_line[x];
-                    pDst[0] = luma;
-                    pDst[1] = luma;
-                    pDst[2] = luma;
-                    pDst += 3;
-                }
-            } else {
-                for (int x = 0; x < image_width; x++) {
-                    uint8_t luma = pScan_line[x];
-                    pDst[0] = luma;
-                    pDst[1] = luma;
-                    pDst[2] = luma;
-                    pDst[3] = 255;
-                    pDst += 4;
-                }
-            }
-        } else if (decoder->get_num_components() == 3) {
-            if (req_comps == 1) {
-                const int YR = 19595, YG = 38470, YB = 7471;
-                for (int x = 0; x < image_width; x++) {
-                    int r = pScan_line[x*4+0];
-                    int g = pScan_line[x*4+1];
-                    int b = pScan_line[x*4+2];
-                    *pDst++ = static_cast<uint8_t>((r * YR + g * YG + b * YB + 32768) >> 16);
-                }
-            } else {
-                for (int x = 0; x < image_width; x++) {
-                    pDst[0] = pScan_line[x*4+0];
-                    pDst[1] = pScan_line[x*4+1];
-                    pDst[2] = pScan_line[x*4+2];
-                    pDst += 3;
-                }
-            }
-        }
-    }
     return pImage_data;
 }
@@ -29,7 +29,7 @@ class jpeg_decoder;
 
 jpeg_decoder* jpgdHeader(const char* data, int size, int* width, int* height);
 jpeg_decoder* jpgdHeader(const char* filename, int* width, int* height);
-unsigned char* jpgdDecompress(jpeg_decoder* decoder);
+unsigned char* jpgdDecompress(jpeg_decoder* decoder, int shift = 0, bool rgba = false);  //the image is reduced to 1/2^shift (up to 3), in bgra or rgba order
 void jpgdDelete(jpeg_decoder* decoder);
 
 #endif //_TVG_JPGD_H_
@@ -0,0 +1,1296 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tvgStr.h"
+#include "tvgLottieModel.h"
+#include "tvgLottieBinary.h"
+
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+#define LOTTIE_BINARY_NONE 0xff        //tag of the absent object
+#define LOTTIE_BINARY_MAX_DEPTH 512    //nesting limit of the groups
+
+/* The reader and the writer share the same serialization routines below, each of them
+   visits the model fields in the identical order. The writer never modifies the model,
+   it might be rendered by the other instances meanwhile. */
+
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+
+struct LottieBinaryWriter
+{
+    static constexpr bool reading = false;
+
+    Array<uint8_t>& out;
+    LottieComposition* comp;
+    const char* dirName;
+    Array<LottieObject*> objects;      //object table, referred by the links
+    Array<LottieLayer*> layers;
+    Array<LottieExpression*> exps;
+    uint32_t last = 0;                 //the last interpolator found, the keyframes mostly share one in a row
+    uint32_t depth = 0;
+    bool failed = false;
+
+    LottieBinaryWriter(Array<uint8_t>& out, LottieComposition* comp, const char* dirName) : out(out), comp(comp), dirName(dirName) {}
+
+    void raw(const void* data, uint32_t size)
+    {
+        if (size == 0) return;
+        out.grow(size);
+        memcpy(out.end(), data, size);
+        out.count += size;
+    }
+
+    template<typename T>
+    void pod(T& v)
+    {
+        raw(&v, sizeof(T));
+    }
+
+    template<typename T>
+    void array(T*& data, uint32_t cnt)
+    {
+        raw(data, sizeof(T) * cnt);
+    }
+
+    uint32_t count(uint32_t cnt)
+    {
+        pod(cnt);
+        return cnt;
+    }
+
+    void flag(bool& v)
+    {
+        uint8_t b = v ? 1 : 0;
+        pod(b);
+    }
+
+    //djb2 ids, 64 bits regardless of the platform
+    void id(unsigned long& v)
+    {
+        uint64_t t = v;
+        pod(t);
+    }
+
+    void str(char*& s)
+    {
+        auto len = s ? uint32_t(strlen(s)) + 1 : 0;
+        pod(len);
+        if (len > 1) raw(s, len - 1);
+    }
+
+    void data(char*& data, uint32_t size)
+    {
+        raw(data, size);
+    }
+
+    //relative to the resource directory, thus the resources can be moved along with
+    void path(char*& path)
+    {
+        auto len = dirName ? strlen(dirName) : 0;
+        uint8_t relative = (path && len > 0 && !strncmp(path, dirName, len) && path[len] == '/') ? 1 : 0;
+        pod(relative);
+        auto p = relative ? path + len + 1 : path;
+        str(p);
+    }
+
+    //index + 1, zero for none or the unknown one
+    template<typename T>
+    void ref(Array<T*>& table, T*& obj)
+    {
+        uint32_t idx = 0;
+        if (obj) {
+            for (uint32_t i = 0; i < table.count; ++i) {
+                if (table[i] == obj) {
+                    idx = i + 1;
+                    break;
+                }
+            }
+        }
+        pod(idx);
+    }
+
+    void interpolator(LottieInterpolator*& interpolator)
+    {
+        uint32_t idx = 0;
+        if (interpolator) {
+            auto& table = comp->interpolators;
+            if (last < table.count && table[last] == interpolator) idx = last + 1;
+            else {
+                for (uint32_t i = 0; i < table.count; ++i) {
+                    if (table[i] == interpolator) {
+                        last = i;
+                        idx = i + 1;
+                        break;
+                    }
+                }
+            }
+        }
+        pod(idx);
+    }
+
+    void expression(LottieProperty& prop)
+    {
+        auto code = prop.exp ? prop.exp->code : nullptr;
+        str(code);
+        if (code) exps.push(prop.exp);
+    }
+
+    LottieObject* tag(LottieObject* obj)
+    {
+        uint8_t type = obj ? obj->type : LOTTIE_BINARY_NONE;
+        pod(type);
+        return obj;
+    }
+
+    LottieEffect* tag(LottieEffect* effect)
+    {
+        uint8_t type = effect->type;
+        pod(type);
+        return effect;
+    }
+};
+
+#endif
+
+
+struct LottieBinaryReader
+{
+    static constexpr bool reading = true;
+
+    const uint8_t* p;
+    const uint8_t* end;
+    LottieComposition* comp;
+    const char* dirName;
+    Array<LottieObject*> objects;      //object table, in the order of the writer
+    Array<LottieLayer*> layers;
+    Array<LottieExpression*> exps;     //null if the expressions are not supported
+    uint32_t depth = 0;
+    bool expressions;
+    bool failed = false;
+
+    LottieBinaryReader(LottieComposition* comp, const char* data, uint32_t size, const char* dirName, bool expressions) : p((const uint8_t*)data), end((const uint8_t*)data + size), comp(comp), dirName(dirName ? dirName : "."), expressions(expressions) {}
+
+    uint32_t remains()
+    {
+        return uint32_t(end - p);
+    }
+
+    void raw(void* data, uint32_t size)
+    {
+        if (size == 0) return;
+        if (failed || size > remains()) {
+            failed = true;
+            memset(data, 0x00, size);
+            return;
+        }
+        memcpy(data, p, size);
+        p += size;
+    }
+
+    template<typename T>
+    void pod(T& v)
+    {
+        raw(&v, sizeof(T));
+    }
+
+    template<typename T>
+    void array(T*& data, uint32_t cnt)
+    {
+        data = nullptr;
+        if (cnt == 0) return;
+        if (sizeof(T) * cnt > remains()) {
+            failed = true;
+            return;
+        }
+        data = tvg::malloc<T*>(sizeof(T) * cnt);
+        raw(data, sizeof(T) * cnt);
+    }
+
+    //every element takes a byte at least, the broken count is rejected before any allocation
+    uint32_t count(TVG_UNUSED uint32_t cnt)
+    {
+        pod(cnt);
+        if (cnt > remains()) {
+            failed = true;
+            return 0;
+        }
+        return cnt;
+    }
+
+    void flag(bool& v)
+    {
+        uint8_t b = 0;
+        pod(b);
+        v = (b != 0);
+    }
+
+    void id(unsigned long& v)
+    {
+        uint64_t t = 0;
+        pod(t);
+        v = static_cast<unsigned long>(t);
+    }
+
+    void str(char*& s)
+    {
+        s = nullptr;
+        uint32_t len = 0;
+        pod(len);
+        if (len == 0) return;
+        if (len - 1 > remains()) {
+            failed = true;
+            return;
+        }
+        s = tvg::malloc<char*>(len);
+        raw(s, len - 1);
+        s[len - 1] = '\0';
+    }
+
+    void data(char*& data, uint32_t size)
+    {
+        data = nullptr;
+        if (size == 0) return;
+        if (size > remains()) {
+            failed = true;
+            return;
+        }
+        data = tvg::malloc<char*>(size + 1);
+        raw(data, size);
+        data[size] = '\0';
+    }
+
+    void path(char*& path)
+    {
+        uint8_t relative = 0;
+        pod(relative);
+        str(path);
+        if (!relative || !path) return;
+
+        auto len = strlen(dirName) + strlen(path) + 2;
+        auto full = tvg::malloc<char*>(len);
+        snprintf(full, len, "%s/%s", dirName, path);
+        tvg::free(path);
+        path = full;
+    }
+
+    template<typename T>
+    void ref(Array<T*>& table, T*& obj)
+    {
+        uint32_t idx = 0;
+        pod(idx);
+        if (idx > table.count) {
+            failed = true;
+            idx = 0;
+        }
+        obj = idx ? table[idx - 1] : nullptr;
+    }
+
+    void interpolator(LottieInterpolator*& interpolator)
+    {
+        uint32_t idx = 0;
+        pod(idx);
+        if (idx > comp->interpolators.count) {
+            failed = true;
+            idx = 0;
+        }
+        interpolator = idx ? comp->interpolators[idx - 1] : nullptr;
+    }
+
+    //its targets are linked later, see _links()
+    void expression(LottieProperty& prop)
+    {
+        char* code;
+        str(code);
+        if (!code) return;
+
+        if (!expressions) {
+            tvg::free(code);
+            exps.push(nullptr);
+            return;
+        }
+
+        auto exp = new LottieExpression;
+        exp->code = code;
+        exp->comp = comp;
+        exp->layer = nullptr;
+        exp->object = nullptr;
+        exp->property = &prop;
+        prop.exp = exp;
+        comp->expressions = true;
+        exps.push(exp);
+    }
+
+    LottieObject* tag(TVG_UNUSED LottieObject* obj)
+    {
+        uint8_t type = LOTTIE_BINARY_NONE;
+        pod(type);
+
+        switch (type) {
+            case LottieObject::Layer: obj = new LottieLayer; break;
+            case LottieObject::Group: obj = new LottieGroup; break;
+            case LottieObject::Transform: obj = new LottieTransform; break;
+            case LottieObject::SolidFill: obj = new LottieSolidFill; break;
+            case LottieObject::SolidStroke: obj = new LottieSolidStroke; break;
+            case LottieObject::GradientFill: obj = new LottieGradientFill; break;
+            case LottieObject::GradientStroke: obj = new LottieGradientStroke; break;
+            case LottieObject::Rect: obj = new LottieRect; break;
+            case LottieObject::Ellipse: obj = new LottieEllipse; break;
+            case LottieObject::Path: obj = new LottiePath; break;
+            case LottieObject::Polystar: obj = new LottiePolyStar; break;
+            case LottieObject::Image: obj = new LottieImage; break;
+            case LottieObject::Trimpath: obj = new LottieTrimpath; break;
+            case LottieObject::Text: obj = new LottieText; break;
+            case LottieObject::Repeater: obj = new LottieRepeater; break;
+            case LottieObject::RoundedCorner: obj = new LottieRoundedCorner; break;
+            case LottieObject::OffsetPath: obj = new LottieOffsetPath; break;
+            case LOTTIE_BINARY_NONE: return nullptr;
+            default: {
+                failed = true;
+                return nullptr;
+            }
+        }
+        obj->type = static_cast<LottieObject::Type>(type);
+        return obj;
+    }
+
+    LottieEffect* tag(TVG_UNUSED LottieEffect* effect)
+    {
+        uint8_t type = 0;
+        pod(type);
+
+        switch (type) {
+            case LottieEffect::Custom: return new LottieFxCustom;
+            case LottieEffect::Tint: return new LottieFxTint;
+            case LottieEffect::Fill: return new LottieFxFill;
+            case LottieEffect::Stroke: return new LottieFxStroke;
+            case LottieEffect::Tritone: return new LottieFxTritone;
+            case LottieEffect::DropShadow: return new LottieFxDropShadow;
+            case LottieEffect::GaussianBlur: return new LottieFxGaussianBlur;
+            default: {
+                failed = true;
+                return nullptr;
+            }
+        }
+    }
+};
+
+
+template<typename IO> static void _object(IO& io, LottieObject* obj);
+template<typename IO> static void _children(IO& io, Array<LottieObject*>& children);
+
+
+//restore the keyframes in a block
+template<typename Frame>
+static void _reserve(Array<Frame>* frames, uint32_t cnt)
+{
+    frames->reserve(cnt);
+    memset((void*)frames->data, 0x00, sizeof(Frame) * cnt);
+    frames->count = cnt;
+}
+
+
+template<typename IO, typename T>
+static void _value(IO& io, T& value)
+{
+    io.pod(value);
+}
+
+
+template<typename IO>
+static void _value(IO& io, PathSet& path)
+{
+    io.pod(path.ptsCnt);
+    io.pod(path.cmdsCnt);
+    io.array(path.pts, path.ptsCnt);
+    io.array(path.cmds, path.cmdsCnt);
+}
+
+
+//the populated color stops, see LottieGradient::populate()
+template<typename IO>
+static void _value(IO& io, ColorStop& color, uint16_t count)
+{
+    uint8_t populated = color.data ? 1 : 0;
+    io.pod(populated);
+    if (populated) io.array(color.data, count);
+}
+
+
+template<typename IO>
+static void _value(IO& io, TextDocument& doc)
+{
+    io.str(doc.text);
+    io.str(doc.name);
+    io.pod(doc.height);
+    io.pod(doc.shift);
+    io.pod(doc.color);
+    io.pod(doc.bbox.pos);
+    io.pod(doc.bbox.size);
+    io.pod(doc.stroke.color);
+    io.pod(doc.stroke.width);
+    io.flag(doc.stroke.below);
+    io.pod(doc.size);
+    io.pod(doc.tracking);
+    io.pod(doc.justify);
+    io.pod(doc.caps);
+}
+
+
+template<typename IO>
+static void _value(IO& io, LottieBitmap& bitmap)
+{
+    io.pod(bitmap.ix);
+    io.pod(bitmap.size);
+    io.flag(bitmap.encoded);
+    if (bitmap.size > 0) io.data(bitmap.b64Data, bitmap.size);
+    else io.path(bitmap.path);
+    io.str(bitmap.mimeType);
+    io.pod(bitmap.width);
+    io.pod(bitmap.height);
+}
+
+
+template<typename IO, typename T>
+static void _frame(IO& io, LottieScalarFrame<T>& frame)
+{
+    _value(io, frame.value);
+    io.pod(frame.no);
+    io.interpolator(frame.interpolator);
+    io.flag(frame.hold);
+}
+
+
+template<typename IO, typename T>
+static void _frame(IO& io, LottieVectorFrame<T>& frame)
+{
+    _value(io, frame.value);
+    io.pod(frame.no);
+    io.interpolator(frame.interpolator);
+    io.pod(frame.outTangent);
+    io.pod(frame.inTangent);
+    io.pod(frame.length);
+    io.flag(frame.hasTangent);
+    io.flag(frame.hold);
+}
+
+
+template<typename IO, typename Frame, typename Value, LottieProperty::Type PType, bool Scalar>
+static void _property(IO& io, LottieGenericProperty<Frame, Value, PType, Scalar>& prop)
+{
+    io.pod(prop.ix);
+    io.expression(prop);
+    _value(io, prop.value);
+
+    auto cnt = io.count(prop.frames ? prop.frames->count : 0);
+    if (cnt == 0) return;
+    if (IO::reading) _reserve(prop.frames = new Array<Frame>, cnt);
+    ARRAY_FOREACH(p, *prop.frames) _frame(io, *p);
+}
+
+
+template<typename IO>
+static void _property(IO& io, LottiePathSet& prop)
+{
+    using Frames = Array<LottieScalarFrame<PathSet>>;
+
+    io.pod(prop.ix);
+    io.expression(prop);
+    _value(io, prop.value);
+
+    auto cnt = io.count(prop.frames ? prop.frames->count : 0);
+    if (cnt == 0) return;
+    if (IO::reading) _reserve(prop.frames = tvg::calloc<Frames*>(1, sizeof(Frames)), cnt);
+    ARRAY_FOREACH(p, *prop.frames) _frame(io, *p);
+}
+
+
+template<typename IO>
+static void _property(IO& io, LottieColorStop& prop)
+{
+    using Frames = Array<LottieScalarFrame<ColorStop>>;
+
+    io.pod(prop.ix);
+    io.expression(prop);
+    io.pod(prop.count);
+    io.flag(prop.populated);
+    _value(io, prop.value, prop.count);
+
+    auto cnt = io.count(prop.frames ? prop.frames->count : 0);
+    if (cnt == 0) return;
+    if (IO::reading) _reserve(prop.frames = tvg::calloc<Frames*>(1, sizeof(Frames)), cnt);
+    ARRAY_FOREACH(p, *prop.frames) {
+        _value(io, p->value, prop.count);
+        io.pod(p->no);
+        io.interpolator(p->interpolator);
+        io.flag(p->hold);
+    }
+}
+
+
+template<typename IO>
+static void _property(IO& io, LottieTextDoc& prop)
+{
+    io.pod(prop.ix);
+    io.expression(prop);
+    _value(io, prop.value);
+
+    auto cnt = io.count(prop.frames ? prop.frames->count : 0);
+    if (cnt == 0) return;
+    if (IO::reading) _reserve(prop.frames = new Array<LottieScalarFrame<TextDocument>>, cnt);
+    ARRAY_FOREACH(p, *prop.frames) _frame(io, *p);
+}
+
+
+template<typename IO>
+static void _stroke(IO& io, LottieStroke* stroke)
+{
+    _property(io, stroke->width);
+    io.pod(stroke->miterLimit);
+    io.pod(stroke->cap);
+    io.pod(stroke->join);
+
+    uint8_t dash = stroke->dashattr ? 1 : 0;
+    io.pod(dash);
+    if (!dash) return;
+
+    _property(io, IO::reading ? stroke->dashOffset() : stroke->dashattr->offset);
+    uint8_t cnt = IO::reading ? 0 : stroke->dashattr->size;
+    io.pod(cnt);
+    for (uint8_t i = 0; i < cnt; ++i) {
+        _property(io, IO::reading ? stroke->dashValue() : stroke->dashattr->values[i]);
+    }
+}
+
+
+template<typename IO>
+static void _solid(IO& io, LottieSolid* solid)
+{
+    _property(io, solid->color);
+    _property(io, solid->opacity);
+}
+
+
+template<typename IO>
+static void _gradient(IO& io, LottieGradient* gradient)
+{
+    _property(io, gradient->start);
+    _property(io, gradient->end);
+    _property(io, gradient->height);
+    _property(io, gradient->angle);
+    _property(io, gradient->opacity);
+    _property(io, gradient->colorStops);
+    io.pod(gradient->id);
+    io.flag(gradient->opaque);
+}
+
+
+template<typename IO>
+static void _transform(IO& io, LottieTransform* transform)
+{
+    _property(io, transform->position);
+    _property(io, transform->rotation);
+    _property(io, transform->scale);
+    _property(io, transform->anchor);
+    _property(io, transform->opacity);
+    _property(io, transform->skewAngle);
+    _property(io, transform->skewAxis);
+
+    uint8_t extensions = (transform->coords ? 1 : 0) | (transform->rotationEx ? 2 : 0);
+    io.pod(extensions);
+
+    if (extensions & 1) {
+        auto coords = IO::reading ? transform->separateCoord() : transform->coords;
+        _property(io, coords->x);
+        _property(io, coords->y);
+    }
+    if (extensions & 2) {
+        if (IO::reading) transform->rotationEx = new LottieTransform::RotationEx;
+        _property(io, transform->rotationEx->x);
+        _property(io, transform->rotationEx->y);
+    }
+}
+
+
+template<typename IO>
+static void _range(IO& io, LottieTextRange* range)
+{
+    auto& style = range->style;
+    _property(io, style.fillColor);
+    _property(io, style.strokeColor);
+    _property(io, style.position);
+    _property(io, style.scale);
+    _property(io, style.letterSpacing);
+    _property(io, style.lineSpacing);
+    _property(io, style.strokeWidth);
+    _property(io, style.rotation);
+    _property(io, style.fillOpacity);
+    _property(io, style.strokeOpacity);
+    _property(io, style.opacity);
+
+    uint8_t flags = (style.flags.fillColor ? 1 : 0) | (style.flags.strokeColor ? 2 : 0) | (style.flags.strokeWidth ? 4 : 0);
+    io.pod(flags);
+    if (IO::reading) {
+        style.flags.fillColor = flags & 1;
+        style.flags.strokeColor = flags & 2;
+        style.flags.strokeWidth = flags & 4;
+    }
+
+    _property(io, range->offset);
+    _property(io, range->maxEase);
+    _property(io, range->minEase);
+    _property(io, range->maxAmount);
+    _property(io, range->smoothness);
+    _property(io, range->start);
+    _property(io, range->end);
+
+    //the easing curve is reset on every use, see LottieTextRange::factor()
+    uint8_t easing = range->interpolator ? 1 : 0;
+    io.pod(easing);
+    if (IO::reading && easing) range->interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
+
+    io.pod(range->based);
+    io.pod(range->shape);
+    io.pod(range->rangeUnit);
+    io.pod(range->random);
+    io.flag(range->expressible);
+}
+
+
+template<typename IO>
+static void _text(IO& io, LottieText* text)
+{
+    io.pod(text->alignOption.grouping);
+    _property(io, text->alignOption.anchor);
+    _property(io, text->doc);
+
+    uint8_t follow = text->followPath ? 1 : 0;
+    io.pod(follow);
+    if (follow) {
+        if (IO::reading) text->followPath = new LottieTextFollowPath;
+        _property(io, text->followPath->firstMargin);
+        io.pod(text->followPath->maskIdx);
+    }
+
+    auto cnt = io.count(text->ranges.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        if (IO::reading) text->ranges.push(new LottieTextRange);
+        _range(io, text->ranges[i]);
+    }
+}
+
+
+template<typename IO>
+static void _effect(IO& io, LottieEffect* effect)
+{
+    io.id(effect->nm);
+    io.id(effect->mn);
+    io.pod(effect->ix);
+    io.flag(effect->enable);
+
+    switch (effect->type) {
+        case LottieEffect::Custom: {
+            auto custom = static_cast<LottieFxCustom*>(effect);
+            io.str(custom->name);
+            auto cnt = io.count(custom->props.count);
+            for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+                auto type = IO::reading ? LottieProperty::Type::Invalid : custom->props[i].property->type;
+                io.pod(type);
+                if (IO::reading) {
+                    LottieProperty* prop = nullptr;
+                    switch (type) {
+                        case LottieProperty::Type::Float: prop = new LottieFloat; break;
+                        case LottieProperty::Type::Color: prop = new LottieColor; break;
+                        case LottieProperty::Type::Vector: prop = new LottieVector; break;
+                        case LottieProperty::Type::Integer: prop = new LottieInteger; break;
+                        default: {
+                            io.failed = true;
+                            return;
+                        }
+                    }
+                    custom->props.push({prop});
+                }
+                auto& prop = custom->props[i];
+                io.id(prop.nm);
+                io.id(prop.mn);
+                switch (prop.property->type) {
+                    case LottieProperty::Type::Float: _property(io, *static_cast<LottieFloat*>(prop.property)); break;
+                    case LottieProperty::Type::Color: _property(io, *static_cast<LottieColor*>(prop.property)); break;
+                    case LottieProperty::Type::Vector: _property(io, *static_cast<LottieVector*>(prop.property)); break;
+                    case LottieProperty::Type::Integer: _property(io, *static_cast<LottieInteger*>(prop.property)); break;
+                    default: break;
+                }
+            }
+            break;
+        }
+        case LottieEffect::Tint: {
+            auto tint = static_cast<LottieFxTint*>(effect);
+            _property(io, tint->black);
+            _property(io, tint->white);
+            _property(io, tint->intensity);
+            break;
+        }
+        case LottieEffect::Fill: {
+            auto fill = static_cast<LottieFxFill*>(effect);
+            _property(io, fill->color);
+            _property(io, fill->opacity);
+            break;
+        }
+        case LottieEffect::Stroke: {
+            auto stroke = static_cast<LottieFxStroke*>(effect);
+            _property(io, stroke->mask);
+            _property(io, stroke->allMask);
+            _property(io, stroke->color);
+            _property(io, stroke->size);
+            _property(io, stroke->opacity);
+            _property(io, stroke->begin);
+            _property(io, stroke->end);
+            break;
+        }
+        case LottieEffect::Tritone: {
+            auto tritone = static_cast<LottieFxTritone*>(effect);
+            _property(io, tritone->bright);
+            _property(io, tritone->midtone);
+            _property(io, tritone->dark);
+            _property(io, tritone->blend);
+            break;
+        }
+        case LottieEffect::DropShadow: {
+            auto shadow = static_cast<LottieFxDropShadow*>(effect);
+            _property(io, shadow->color);
+            _property(io, shadow->opacity);
+            _property(io, shadow->angle);
+            _property(io, shadow->distance);
+            _property(io, shadow->blurness);
+            break;
+        }
+        case LottieEffect::GaussianBlur: {
+            auto blur = static_cast<LottieFxGaussianBlur*>(effect);
+            _property(io, blur->blurness);
+            _property(io, blur->direction);
+            _property(io, blur->wrap);
+            break;
+        }
+        default: break;
+    }
+}
+
+
+template<typename IO>
+static void _group(IO& io, LottieGroup* group, bool children = true)
+{
+    io.pod(group->blendMethod);
+
+    //the prepared states, see LottieGroup::prepare()
+    uint8_t flags = (group->reqFragment ? 1 : 0) | (group->trimpath ? 2 : 0) | (group->visible ? 4 : 0) | (group->allowMerge ? 8 : 0);
+    io.pod(flags);
+    if (IO::reading) {
+        group->reqFragment = flags & 1;
+        group->trimpath = flags & 2;
+        group->visible = flags & 4;
+        group->allowMerge = flags & 8;
+    }
+
+    if (++io.depth > LOTTIE_BINARY_MAX_DEPTH) io.failed = true;
+    else if (children) _children(io, group->children);
+    else io.count(0);
+    --io.depth;
+}
+
+
+template<typename IO>
+static void _layer(IO& io, LottieLayer* layer)
+{
+    io.layers.push(layer);
+
+    io.str(layer->name);
+    io.pod(layer->type);
+    io.id(layer->rid);
+    io.pod(layer->timeStretch);
+    io.pod(layer->w);
+    io.pod(layer->h);
+    io.pod(layer->inFrame);
+    io.pod(layer->outFrame);
+    io.pod(layer->startFrame);
+    io.pod(layer->mix);
+    io.pod(layer->pix);
+    io.pod(layer->ix);
+    io.pod(layer->matteType);
+    io.flag(layer->autoOrient);
+    io.flag(layer->matteSrc);
+    _property(io, layer->timeRemap);
+
+    if (auto transform = io.tag(layer->transform)) {
+        if (transform->type != LottieObject::Transform) {
+            if (IO::reading) delete(transform);
+            io.failed = true;
+            return;
+        }
+        layer->transform = static_cast<LottieTransform*>(transform);
+        _object(io, transform);
+    }
+
+    auto cnt = io.count(layer->masks.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        if (IO::reading) layer->masks.push(new LottieMask);
+        auto mask = layer->masks[i];
+        _property(io, mask->pathset);
+        _property(io, mask->expand);
+        _property(io, mask->opacity);
+        io.pod(mask->method);
+        io.flag(mask->inverse);
+    }
+
+    cnt = io.count(layer->effects.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        auto effect = io.tag(IO::reading ? nullptr : layer->effects[i]);
+        if (!effect) return;
+        if (IO::reading) layer->effects.push(effect);
+        _effect(io, effect);
+    }
+
+    //the clipper of the precomp or the solid fill, see LottieLayer::prepare()
+    uint8_t statical = 0;
+    uint8_t color[3] = {0, 0, 0};
+    if (!IO::reading && layer->statical) {
+        if (layer->type == LottieLayer::Precomp) statical = 1;
+        else {
+            statical = 2;
+            layer->statical->fill(color, color + 1, color + 2);
+        }
+    }
+    io.pod(statical);
+    if (statical == 2) io.pod(color);
+
+    if (IO::reading && statical > 0) {
+        auto shape = Shape::gen();
+        shape->appendRect(0.0f, 0.0f, layer->w, layer->h);
+        if (statical == 2) shape->fill(color[0], color[1], color[2]);
+        shape->ref();
+        layer->statical = shape;
+    }
+
+    //the precomp and the image layers share the children of the asset, it's resolved by the build.
+    auto shared = layer->rid && (layer->type == LottieLayer::Precomp || layer->type == LottieLayer::Image);
+    //the reference of the others is meaningless, but it'd leave their children unowned.
+    if (IO::reading && !shared) layer->rid = 0;
+    _group(io, layer, !shared);
+
+    //a precomposition consists of the layers only, the builder relies on it.
+    if (IO::reading && layer->type == LottieLayer::Precomp) {
+        ARRAY_FOREACH(p, layer->children) {
+            if ((*p)->type != LottieObject::Layer) io.failed = true;
+        }
+    }
+}
+
+
+template<typename IO>
+static void _object(IO& io, LottieObject* obj)
+{
+    io.objects.push(obj);
+    io.id(obj->id);
+    io.flag(obj->hidden);
+
+    switch (obj->type) {
+        case LottieObject::Layer: {
+            _layer(io, static_cast<LottieLayer*>(obj));
+            break;
+        }
+        case LottieObject::Group: {
+            _group(io, static_cast<LottieGroup*>(obj));
+            break;
+        }
+        case LottieObject::Transform: {
+            _transform(io, static_cast<LottieTransform*>(obj));
+            break;
+        }
+        case LottieObject::SolidFill: {
+            auto fill = static_cast<LottieSolidFill*>(obj);
+            _solid(io, fill);
+            io.pod(fill->rule);
+            break;
+        }
+        case LottieObject::SolidStroke: {
+            auto stroke = static_cast<LottieSolidStroke*>(obj);
+            _solid(io, stroke);
+            _stroke(io, stroke);
+            break;
+        }
+        case LottieObject::GradientFill: {
+            auto fill = static_cast<LottieGradientFill*>(obj);
+            _gradient(io, fill);
+            io.pod(fill->rule);
+            break;
+        }
+        case LottieObject::GradientStroke: {
+            auto stroke = static_cast<LottieGradientStroke*>(obj);
+            _gradient(io, stroke);
+            _stroke(io, stroke);
+            break;
+        }
+        case LottieObject::Rect: {
+            auto rect = static_cast<LottieRect*>(obj);
+            io.flag(rect->clockwise);
+            _property(io, rect->position);
+            _property(io, rect->size);
+            _property(io, rect->radius);
+            break;
+        }
+        case LottieObject::Ellipse: {
+            auto ellipse = static_cast<LottieEllipse*>(obj);
+            io.flag(ellipse->clockwise);
+            _property(io, ellipse->position);
+            _property(io, ellipse->size);
+            break;
+        }
+        case LottieObject::Path: {
+            auto path = static_cast<LottiePath*>(obj);
+            io.flag(path->clockwise);
+            _property(io, path->pathset);
+            break;
+        }
+        case LottieObject::Polystar: {
+            auto star = static_cast<LottiePolyStar*>(obj);
+            io.flag(star->clockwise);
+            _property(io, star->position);
+            _property(io, star->innerRadius);
+            _property(io, star->outerRadius);
+            _property(io, star->innerRoundness);
+            _property(io, star->outerRoundness);
+            _property(io, star->rotation);
+            _property(io, star->ptsCnt);
+            io.pod(star->type);
+            break;
+        }
+        case LottieObject::Image: {
+            auto image = static_cast<LottieImage*>(obj);
+            _value(io, image->data);
+            if (IO::reading) image->prepare();
+            break;
+        }
+        case LottieObject::Trimpath: {
+            auto trim = static_cast<LottieTrimpath*>(obj);
+            _property(io, trim->start);
+            _property(io, trim->end);
+            _property(io, trim->offset);
+            io.pod(trim->type);
+            break;
+        }
+        case LottieObject::Text: {
+            _text(io, static_cast<LottieText*>(obj));
+            break;
+        }
+        case LottieObject::Repeater: {
+            auto repeater = static_cast<LottieRepeater*>(obj);
+            _property(io, repeater->copies);
+            _property(io, repeater->offset);
+            _property(io, repeater->position);
+            _property(io, repeater->rotation);
+            _property(io, repeater->scale);
+            _property(io, repeater->anchor);
+            _property(io, repeater->startOpacity);
+            _property(io, repeater->endOpacity);
+            io.flag(repeater->inorder);
+            break;
+        }
+        case LottieObject::RoundedCorner: {
+            _property(io, static_cast<LottieRoundedCorner*>(obj)->radius);
+            break;
+        }
+        case LottieObject::OffsetPath: {
+            auto offset = static_cast<LottieOffsetPath*>(obj);
+            _property(io, offset->offset);
+            _property(io, offset->miterLimit);
+            io.pod(offset->join);
+            break;
+        }
+        default: {
+            io.failed = true;
+            break;
+        }
+    }
+}
+
+
+template<typename IO>
+static void _children(IO& io, Array<LottieObject*>& children)
+{
+    auto cnt = io.count(children.count);
+    if (IO::reading) children.reserve(cnt);
+
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        auto obj = io.tag(IO::reading ? nullptr : children[i]);
+        if (!obj) {
+            io.failed = true;
+            return;
+        }
+        if (IO::reading) children.push(obj);
+        _object(io, obj);
+    }
+}
+
+
+template<typename IO>
+static void _font(IO& io, LottieFont* font)
+{
+    io.str(font->name);
+    io.str(font->family);
+    io.str(font->style);
+    io.pod(font->data.size);
+    io.data(font->data.b64src, font->data.size);
+    io.pod(font->ascent);
+    io.pod(font->origin);
+
+    auto cnt = io.count(font->chars.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        if (IO::reading) font->chars.push(new LottieGlyph);
+        auto glyph = font->chars[i];
+        io.str(glyph->code);
+        io.pod(glyph->size);
+        io.pod(glyph->width);
+        _children(io, glyph->children);
+        if (IO::reading) {
+            if (glyph->code) glyph->prepare();
+            else io.failed = true;
+        }
+    }
+
+    if (IO::reading && !io.failed) font->prepare();
+}
+
+
+template<typename IO>
+static void _interpolators(IO& io, LottieComposition* comp)
+{
+    auto cnt = io.count(comp->interpolators.count);
+
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        char* key = nullptr;
+        Point in{}, out{};
+        if (!IO::reading) {
+            auto interpolator = comp->interpolators[i];
+            key = interpolator->key;
+            in = interpolator->inTangent;
+            out = interpolator->outTangent;
+        }
+        io.str(key);
+        io.pod(in);
+        io.pod(out);
+        if (!IO::reading) continue;
+
+        auto interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
+        interpolator->set(nullptr, in, out);
+        interpolator->key = key;
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+        interpolator->bake();
+#endif
+        comp->interpolators.push(interpolator);
+    }
+}
+
+
+template<typename IO>
+static void _slots(IO& io, LottieComposition* comp)
+{
+    auto cnt = io.count(comp->slots.count);
+
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        auto slot = IO::reading ? nullptr : comp->slots[i];
+        auto sid = slot ? slot->sid : nullptr;
+        auto type = slot ? slot->type : LottieProperty::Type::Invalid;
+        auto layer = slot ? slot->context.layer : nullptr;
+        auto parent = slot ? slot->context.parent : nullptr;
+
+        io.str(sid);
+        io.pod(type);
+        io.ref(io.layers, layer);
+        io.ref(io.objects, parent);
+
+        //the overridden values are written as the defaults, the backups are not.
+        auto pairs = io.count(slot ? slot->pairs.count : 0);
+        for (uint32_t j = 0; j < pairs; ++j) {
+            auto obj = IO::reading ? nullptr : slot->pairs[j].obj;
+            io.ref(io.objects, obj);
+            if (!IO::reading || !obj) continue;
+            if (slot) slot->pairs.push({obj});
+            else comp->slots.push(slot = new LottieSlot(layer, parent, sid, obj, type));
+        }
+        if (IO::reading && !slot) tvg::free(sid);
+    }
+}
+
+
+template<typename IO>
+static void _links(IO& io, LottieComposition* comp)
+{
+    //the precompositions of the layers
+    ARRAY_FOREACH(p, io.layers) io.ref(io.layers, (*p)->comp);
+
+    //the contexts of the expressions
+    ARRAY_FOREACH(p, io.exps) {
+        auto exp = *p;
+        auto layer = exp ? exp->layer : nullptr;
+        auto object = exp ? exp->object : nullptr;
+        io.ref(io.layers, layer);
+        io.ref(io.objects, object);
+        if (IO::reading && exp) {
+            exp->layer = layer;
+            exp->object = object;
+        }
+    }
+
+    _slots(io, comp);
+}
+
+
+template<typename IO>
+static void _composition(IO& io, LottieComposition* comp)
+{
+    _interpolators(io, comp);
+
+    io.str(comp->version);
+    io.str(comp->name);
+    io.pod(comp->w);
+    io.pod(comp->h);
+    io.pod(comp->frameRate);
+
+    //the precomp layers and the images
+    auto cnt = io.count(comp->assets.count);
+    if (IO::reading) comp->assets.reserve(cnt);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        auto asset = io.tag(IO::reading ? nullptr : comp->assets[i]);
+        if (!asset) {
+            io.failed = true;
+            return;
+        }
+        if (IO::reading) comp->assets.push(asset);
+        if (asset->type != LottieObject::Layer && asset->type != LottieObject::Image) {
+            io.failed = true;
+            return;
+        }
+        _object(io, asset);
+    }
+
+    auto root = io.tag(comp->root);
+    if (!root || root->type != LottieObject::Layer) {
+        if (IO::reading) delete(root);
+        io.failed = true;
+        return;
+    }
+    comp->root = static_cast<LottieLayer*>(root);
+    _object(io, root);
+
+    cnt = io.count(comp->fonts.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        if (IO::reading) comp->fonts.push(new LottieFont);
+        _font(io, comp->fonts[i]);
+    }
+
+    cnt = io.count(comp->markers.count);
+    for (uint32_t i = 0; i < cnt && !io.failed; ++i) {
+        if (IO::reading) comp->markers.push(new LottieMarker);
+        auto marker = comp->markers[i];
+        io.str(marker->name);
+        io.pod(marker->time);
+        io.pod(marker->duration);
+    }
+
+    _links(io, comp);
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+bool LottieBinary::header(const char* data, uint32_t size, LottieBinaryHeader* header)
+{
+    if (!data || size < LOTTIE_BINARY_HEADER_SIZE || memcmp(data, LOTTIE_BINARY_MAGIC, sizeof(LottieBinaryHeader::magic))) return false;
+
+    LottieBinaryHeader info;
+    memcpy(&info, data, LOTTIE_BINARY_HEADER_SIZE);
+
+    if (info.version != LOTTIE_BINARY_VERSION || info.bom != LOTTIE_BINARY_BOM || info.size > size - LOTTIE_BINARY_HEADER_SIZE) {
+        TVGERR("LOTTIE", "Incompatible compiled lottie, version = %d", info.version);
+        return false;
+    }
+
+    if (header) *header = info;
+    return true;
+}
+
+
+LottieComposition* LottieBinary::read(const char* data, uint32_t size, const char* dirName, bool expressions)
+{
+    LottieBinaryHeader info;
+    if (!header(data, size, &info)) return nullptr;
+
+    auto comp = new LottieComposition;
+
+    LottieBinaryReader io(comp, data + LOTTIE_BINARY_HEADER_SIZE, info.size, dirName, expressions);
+    _composition(io, comp);
+
+    if (io.failed) {
+        TVGERR("LOTTIE", "Broken compiled lottie!");
+        delete(comp);
+        return nullptr;
+    }
+
+    return comp;
+}
+
+
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+
+bool LottieBinary::write(LottieComposition* comp, const char* dirName, Array<uint8_t>& out)
+{
+    if (!comp || !comp->root) return false;
+
+    //the header is filled at last
+    out.clear();
+    out.grow(LOTTIE_BINARY_HEADER_SIZE);
+    out.count = LOTTIE_BINARY_HEADER_SIZE;
+
+    LottieBinaryWriter io(out, comp, dirName);
+    _composition(io, comp);
+    if (io.failed) return false;
+
+    LottieBinaryHeader info;
+    memcpy(info.magic, LOTTIE_BINARY_MAGIC, sizeof(info.magic));
+    info.version = LOTTIE_BINARY_VERSION;
+    info.bom = LOTTIE_BINARY_BOM;
+    info.reserved = 0;
+    info.frameRate = comp->frameRate;
+    info.startFrame = comp->root->inFrame;
+    info.endFrame = comp->root->outFrame;
+    info.w = comp->w;
+    info.h = comp->h;
+    info.size = out.count - LOTTIE_BINARY_HEADER_SIZE;
+    memcpy(out.data, &info, LOTTIE_BINARY_HEADER_SIZE);
+
+    return true;
+}
+
+#endif
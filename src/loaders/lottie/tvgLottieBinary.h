@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TVG_LOTTIE_BINARY_H_
+#define _TVG_LOTTIE_BINARY_H_
+
+#include "tvgCommon.h"
+#include "tvgArray.h"
+
+/* The compiled lottie (.lotb) is a snapshot of the parsed composition model. It's loaded
+   without the json parser: the keyframes, the interpolators and the path data are restored
+   as they are in the memory. The data is in the byte order of the host which wrote it, the
+   byte order mark rejects the others.
+
+   header | interpolators | composition | assets | root layer | fonts | markers | links
+
+   The links (the precomp of the layers, the targets of the expressions and the slots) are
+   written at the end as the indices of the object table, in the order of the serialization. */
+
+#define LOTTIE_BINARY_MAGIC "TVGLOTB"
+#define LOTTIE_BINARY_VERSION 3
+#define LOTTIE_BINARY_BOM 0xFEFF
+#define LOTTIE_BINARY_HEADER_SIZE 36
+
+struct LottieComposition;
+
+struct LottieBinaryHeader
+{
+    char magic[7];
+    uint8_t version;
+    uint16_t bom;
+    uint16_t reserved;
+    //the animation info, it's available without loading the body
+    float frameRate;
+    float startFrame;
+    float endFrame;
+    float w, h;
+    uint32_t size;     //body size
+};
+
+struct LottieBinary
+{
+    static bool header(const char* data, uint32_t size, LottieBinaryHeader* header = nullptr);
+    static LottieComposition* read(const char* data, uint32_t size, const char* dirName, bool expressions);
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+    static bool write(LottieComposition* comp, const char* dirName, Array<uint8_t>& out);
+#endif
+};
+
+#endif //_TVG_LOTTIE_BINARY_H_
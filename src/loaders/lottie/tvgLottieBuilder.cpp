@@ -24,7 +24,9 @@
 #include "tvgCommon.h"
 #include "tvgMath.h"
 #include "tvgScene.h"
+#include "tvgTaskScheduler.h"
 #include "tvgLottieModel.h"
+#include "tvgLottieParser.h"
 #include "tvgLottieBuilder.h"
 #include "tvgLottieExpressions.h"
 
@@ -34,7 +36,9 @@
 /************************************************************************/
 
 static bool _buildComposition(LottieComposition* comp, LottieLayer* parent);
-static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx);
+static void _buildReference(LottieComposition* comp, LottieLayer* layer, bool resolve = false);
+static void _resolve(LottieComposition* comp, LottieLayer* layer);
+static bool _draw(LottieRenderData* data, LottieGroup* parent, LottieShape* shape, RenderContext* ctx);
 
 
 static void _rotate(LottieTransform* transform, float frameNo, Matrix& m, float angle, Tween& tween, LottieExpressions* exps)
@@ -140,20 +144,24 @@ static bool _updateTransform(LottieTransform* transform, float frameNo, Matrix&
 
 void LottieBuilder::updateTransform(LottieLayer* layer, float frameNo)
 {
-    if (!layer || (!tweening() && tvg::equal(layer->cache.frameNo, frameNo))) return;
+    if (!layer) return;
+
+    auto& cache = data->layer(layer)->cache;
+    if (!tweening() && tvg::equal(cache.frameNo, frameNo)) return;
 
     auto transform = layer->transform;
     auto parent = layer->parent;
 
     if (parent) updateTransform(parent, frameNo);
 
-    auto& matrix = layer->cache.matrix;
+    auto& matrix = cache.matrix;
 
-    _updateTransform(transform, frameNo, matrix, layer->cache.opacity, layer->autoOrient, tween, exps);
+    _updateTransform(transform, frameNo, matrix, cache.opacity, layer->autoOrient, tween, exps);
 
-    if (parent) layer->cache.matrix = parent->cache.matrix * matrix;
+    if (parent) cache.matrix = data->layer(parent)->cache.matrix * matrix;
 
-    layer->cache.frameNo = frameNo;
+    //the tweened result is transient, don't reuse it after the tweening
+    cache.frameNo = tweening() ? -1.0f : frameNo;
 }
 
 
@@ -198,21 +206,22 @@ void LottieBuilder::updateGroup(LottieGroup* parent, LottieObject** child, float
     if (!group->visible) return;
 
     //Prepare render data
+    auto rd = data->object(group);
+    auto pscene = data->object(parent)->scene;
+
     if (group->blendMethod == parent->blendMethod) {
-        group->scene = parent->scene;
+        rd->scene = pscene;
     } else {
-        group->scene = tvg::Scene::gen();
-        group->scene->blend(group->blendMethod);
-        parent->scene->push(group->scene);
+        rd->scene = tvg::Scene::gen();
+        rd->scene->blend(group->blendMethod);
+        pscene->push(rd->scene);
     }
 
-    group->reqFragment |= ctx->reqFragment;
-
     //generate a merging shape to consolidate partial shapes into a single entity
-    if (group->mergeable()) _draw(group, nullptr, ctx);
+    if (group->mergeable()) _draw(data, group, nullptr, ctx);
 
     Inlist<RenderContext> contexts;
-    auto propagator = group->mergeable() ? ctx->propagator : static_cast<Shape*>(PAINT(ctx->propagator)->duplicate(group->pooling()));
+    auto propagator = group->mergeable() ? ctx->propagator : static_cast<Shape*>(PAINT(ctx->propagator)->duplicate(rd->pooler.pooling()));
     contexts.back(new RenderContext(*ctx, propagator, group->mergeable()));
 
     updateChildren(group, frameNo, contexts);
@@ -241,7 +250,7 @@ bool LottieBuilder::fragmented(LottieGroup* parent, LottieObject** child, Inlist
     if (ctx->fragment) return true;
     if (!ctx->reqFragment) return false;
 
-    contexts.back(new RenderContext(*ctx, (Shape*)(PAINT(ctx->propagator)->duplicate(parent->pooling()))));
+    contexts.back(new RenderContext(*ctx, (Shape*)(PAINT(ctx->propagator)->duplicate(data->object(parent)->pooler.pooling()))));
 
     contexts.tail->begin = child - 1;
     ctx->fragment = fragment;
@@ -326,24 +335,24 @@ bool LottieBuilder::updateGradientFill(LottieGroup* parent, LottieObject** child
 }
 
 
-static bool _draw(LottieGroup* parent, LottieShape* shape, RenderContext* ctx)
+static bool _draw(LottieRenderData* data, LottieGroup* parent, LottieShape* shape, RenderContext* ctx)
 {
     if (ctx->merging) return false;
 
     if (shape) {
-        ctx->merging = shape->pooling();
+        ctx->merging = data->object(shape)->pooler.pooling();
         PAINT(ctx->propagator)->duplicate(ctx->merging);
     } else {
         ctx->merging = static_cast<Shape*>(ctx->propagator->duplicate());
     }
 
-    parent->scene->push(ctx->merging);
+    data->object(parent)->scene->push(ctx->merging);
 
     return true;
 }
 
 
-static void _repeat(LottieGroup* parent, Shape* path, RenderContext* ctx)
+static void _repeat(Scene* scene, Shape* path, RenderContext* ctx)
 {
     Array<Shape*> propagators;
     propagators.push(ctx->propagator);
@@ -379,12 +388,12 @@ static void _repeat(LottieGroup* parent, Shape* path, RenderContext* ctx)
         //push repeat shapes in order.
         if (repeater->inorder) {
             ARRAY_FOREACH(p, shapes) {
-                parent->scene->push(*p);
+                scene->push(*p);
                 propagators.push(*p);
             }
         } else if (!shapes.empty()) {
             ARRAY_REVERSE_FOREACH(shape, shapes) {
-                parent->scene->push(*shape);
+                scene->push(*shape);
                 propagators.push(*shape);
             }
         }
@@ -427,13 +436,13 @@ void LottieBuilder::updateRect(LottieGroup* parent, LottieObject** child, float
     }
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, rect, ctx);
+        _draw(data, parent, rect, ctx);
         appendRect(ctx->merging, pos, size, r, rect->clockwise, ctx);
     } else {
-        auto shape = rect->pooling();
+        auto shape = data->object(rect)->pooler.pooling();
         shape->reset();
         appendRect(shape, pos, size, r, rect->clockwise, ctx);
-        _repeat(parent, shape, ctx);
+        _repeat(data->object(parent)->scene, shape, ctx);
     }
 }
 
@@ -461,13 +470,13 @@ void LottieBuilder::updateEllipse(LottieGroup* parent, LottieObject** child, flo
     auto size = ellipse->size(frameNo, tween, exps) * 0.5f;
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, ellipse, ctx);
+        _draw(data, parent, ellipse, ctx);
         _appendCircle(ctx->merging, pos, size, ellipse->clockwise, ctx);
     } else {
-        auto shape = ellipse->pooling();
+        auto shape = data->object(ellipse)->pooler.pooling();
         shape->reset();
         _appendCircle(shape, pos, size, ellipse->clockwise, ctx);
-        _repeat(parent, shape, ctx);
+        _repeat(data->object(parent)->scene, shape, ctx);
     }
 }
 
@@ -477,15 +486,15 @@ void LottieBuilder::updatePath(LottieGroup* parent, LottieObject** child, float
     auto path = static_cast<LottiePath*>(*child);
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, path, ctx);
+        _draw(data, parent, path, ctx);
         if (path->pathset(frameNo, SHAPE(ctx->merging)->rs.path, ctx->transform, tween, exps, ctx->modifier)) {
             PAINT(ctx->merging)->mark(RenderUpdateFlag::Path);
         }
     } else {
-        auto shape = path->pooling();
+        auto shape = data->object(path)->pooler.pooling();
         shape->reset();
         path->pathset(frameNo, SHAPE(shape)->rs.path, ctx->transform, tween, exps, ctx->modifier);
-        _repeat(parent, shape, ctx);
+        _repeat(data->object(parent)->scene, shape, ctx);
     }
 }
 
@@ -520,7 +529,7 @@ void LottieBuilder::updateStar(LottiePolyStar* star, float frameNo, Matrix* tran
 
     Shape* shape;
     if (roundedCorner || ctx->offset) {
-        shape = star->pooling();
+        shape = data->object(star)->pooler.pooling();
         shape->reset();
     } else {
         shape = merging;
@@ -632,7 +641,7 @@ void LottieBuilder::updatePolygon(LottieGroup* parent, LottiePolyStar* star, flo
 
     Shape* shape;
     if (roundedCorner || ctx->offset) {
-        shape = star->pooling();
+        shape = data->object(star)->pooler.pooling();
         shape->reset();
     } else {
         shape = merging;
@@ -696,16 +705,16 @@ void LottieBuilder::updatePolystar(LottieGroup* parent, LottieObject** child, fl
     auto identity = tvg::identity((const Matrix*)&matrix);
 
     if (ctx->repeaters.empty()) {
-        _draw(parent, star, ctx);
+        _draw(data, parent, star, ctx);
         if (star->type == LottiePolyStar::Star) updateStar(star, frameNo, (identity ? nullptr : &matrix), ctx->merging, ctx, tween, exps);
         else updatePolygon(parent, star, frameNo, (identity  ? nullptr : &matrix), ctx->merging, ctx, tween, exps);
         PAINT(ctx->merging)->mark(RenderUpdateFlag::Path);
     } else {
-        auto shape = star->pooling();
+        auto shape = data->object(star)->pooler.pooling();
         shape->reset();
         if (star->type == LottiePolyStar::Star) updateStar(star, frameNo, (identity ? nullptr : &matrix), shape, ctx, tween, exps);
         else updatePolygon(parent, star, frameNo, (identity  ? nullptr : &matrix), shape, ctx, tween, exps);
-        _repeat(parent, shape, ctx);
+        _repeat(data->object(parent)->scene, shape, ctx);
     }
 }
 
@@ -857,15 +866,18 @@ void LottieBuilder::updatePrecomp(LottieComposition* comp, LottieLayer* precomp,
 
     frameNo = precomp->remap(comp, frameNo, exps);
 
+    auto rd = data->object(precomp);
+
     ARRAY_REVERSE_FOREACH(c, precomp->children) {
         auto child = static_cast<LottieLayer*>(*c);
-        if (!child->matteSrc) updateLayer(comp, precomp->scene, child, frameNo);
+        if (!child->matteSrc) updateLayer(comp, rd->scene, child, frameNo);
     }
 
     //clip the layer viewport
-    auto clipper = precomp->statical.pooling(true);
-    clipper->transform(precomp->cache.matrix);
-    precomp->scene->clip(clipper);
+    auto ld = data->layer(precomp);
+    auto clipper = ld->statical.pooling(precomp->statical);
+    clipper->transform(ld->cache.matrix);
+    rd->scene->clip(clipper);
 }
 
 
@@ -883,16 +895,26 @@ void LottieBuilder::updatePrecomp(LottieComposition* comp, LottieLayer* precomp,
 
 void LottieBuilder::updateSolid(LottieLayer* layer)
 {
-    auto solidFill = layer->statical.pooling(true);
-    solidFill->opacity(layer->cache.opacity);
-    layer->scene->push(solidFill);
+    auto ld = data->layer(layer);
+    auto solidFill = ld->statical.pooling(layer->statical);
+    solidFill->opacity(ld->cache.opacity);
+    data->object(layer)->scene->push(solidFill);
 }
 
 
-void LottieBuilder::updateImage(LottieGroup* layer)
+void LottieBuilder::updateImage(LottieComposition* comp, LottieLayer* layer)
 {
+    //no such image asset
+    if (layer->children.empty()) return;
+
     auto image = static_cast<LottieImage*>(layer->children.first());
-    layer->scene->push(image->pooling(true));
+
+    //the image is shared by the instances, whoever comes first loads it
+    if (!image->loaded) {
+        ScopedLock lock(comp->sharing.key);
+        image->load();
+    }
+    data->object(layer)->scene->push(data->layer(layer)->pictures.pooling(image->picture));
 }
 
 
@@ -934,6 +956,7 @@ static void _fontText(TextDocument& doc, Scene* scene)
 
 void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
 {
+    auto rd = data->object(layer);
     auto text = static_cast<LottieText*>(layer->children.first());
     auto textGrouping = text->alignOption.grouping;
     auto& doc = text->doc(frameNo, exps);
@@ -942,7 +965,7 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
     if (!p || !text->font) return;
 
     if (text->font->origin != LottieFont::Origin::Local || text->font->chars.empty()) {
-        _fontText(doc, layer->scene);
+        _fontText(doc, rd->scene);
         return;
     }
 
@@ -956,7 +979,8 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
     auto lineSpacing = 0.0f;
     auto totalLineSpacing = 0.0f;
     auto followPath = (text->followPath && ((uint32_t)text->followPath->maskIdx < layer->masks.count)) ? text->followPath : nullptr;
-    auto firstMargin = followPath ? followPath->prepare(layer->masks[followPath->maskIdx], frameNo, scale, tween, exps) : 0.0f;
+    LottieTextFollowPath::Cursor pathCursor;
+    auto firstMargin = followPath ? followPath->prepare(pathCursor, layer->masks[followPath->maskIdx], frameNo, scale, tween, exps) : 0.0f;
 
     //text string
     int idx = 0;
@@ -981,7 +1005,7 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
             scene->translate(layout.x, layout.y);
             scene->scale(scale);
 
-            layer->scene->push(scene);
+            rd->scene->push(scene);
             scene = nullptr;
 
             if (*p == '\0') break;
@@ -1034,7 +1058,7 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
                 }
 
                 auto& textGroupMatrix = textGroup->transform();
-                auto shape = text->pooling();
+                auto shape = data->object(text)->pooler.pooling();
                 shape->reset();
                 ARRAY_FOREACH(p, glyph->children) {
                     auto group = static_cast<LottieGroup*>(*p);
@@ -1141,7 +1165,7 @@ void LottieBuilder::updateText(LottieLayer* layer, float frameNo)
                         tvg::identity(&matrix);
                         auto angle = 0.0f;
                         auto halfGlyphWidth = glyph->width * 0.5f;
-                        auto position = followPath->position(cursor.x + halfGlyphWidth + firstMargin, angle);
+                        auto position = pathCursor.position(cursor.x + halfGlyphWidth + firstMargin, angle);
                         matrix.e11 = matrix.e22 = capScale;
                         matrix.e13 = position.x - halfGlyphWidth * matrix.e11;
                         matrix.e23 = position.y - halfGlyphWidth * matrix.e21;
@@ -1181,11 +1205,13 @@ void LottieBuilder::updateMasks(LottieLayer* layer, float frameNo)
 {
     if (layer->masks.count == 0) return;
 
+    auto rd = data->object(layer);
+
     //Introduce an intermediate scene for embracing matte + masking or precomp clipping + masking replaced by clipping
     if (layer->matteTarget || layer->type == LottieLayer::Precomp) {
         auto scene = Scene::gen();
-        scene->push(layer->scene);
-        layer->scene = scene;
+        scene->push(rd->scene);
+        rd->scene = scene;
     }
 
     Shape* pShape = nullptr;
@@ -1202,26 +1228,26 @@ void LottieBuilder::updateMasks(LottieLayer* layer, float frameNo)
 
         //the first mask
         if (!pShape) {
-            pShape = layer->pooling();
+            pShape = data->object(layer)->pooler.pooling();
             SHAPE(pShape)->reset();
             auto compMethod = (method == MaskMethod::Subtract || method == MaskMethod::InvAlpha) ? MaskMethod::InvAlpha : MaskMethod::Alpha;
             //Cheaper. Replace the masking with a clipper
             if (layer->masks.count == 1 && compMethod == MaskMethod::Alpha) {
-                layer->scene->opacity(MULTIPLY(layer->scene->opacity(), opacity));
-                layer->scene->clip(pShape);
+                rd->scene->opacity(MULTIPLY(rd->scene->opacity(), opacity));
+                rd->scene->clip(pShape);
             } else {
-                layer->scene->mask(pShape, compMethod);
+                rd->scene->mask(pShape, compMethod);
             }
         //Chain mask composition
         } else if (pMethod != method || pOpacity != opacity || (method != MaskMethod::Subtract && method != MaskMethod::Difference)) {
-            auto shape = layer->pooling();
+            auto shape = data->object(layer)->pooler.pooling();
             SHAPE(shape)->reset();
             pShape->mask(shape, method);
             pShape = shape;
         }
 
         pShape->fill(255, 255, 255, opacity);
-        pShape->transform(layer->cache.matrix);
+        pShape->transform(data->layer(layer)->cache.matrix);
 
         //Default Masking
         if (expand == 0.0f) {
@@ -1245,12 +1271,13 @@ bool LottieBuilder::updateMatte(LottieComposition* comp, float frameNo, Scene* s
 
     updateLayer(comp, scene, target, frameNo);
 
-    if (target->scene) {
-        layer->scene->mask(target->scene, layer->matteType);
+    auto rd = data->object(layer);
+    if (auto mscene = data->object(target)->scene) {
+        rd->scene->mask(mscene, layer->matteType);
     } else if (layer->matteType == MaskMethod::Alpha || layer->matteType == MaskMethod::Luma) {
         //matte target is not exist. alpha blending definitely bring an invisible result
-        delete(layer->scene);
-        layer->scene = nullptr;
+        delete(rd->scene);
+        rd->scene = nullptr;
         return false;
     }
     return true;
@@ -1261,7 +1288,7 @@ void LottieBuilder::updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effec
 {
     if (layer->masks.count == 0) return;
 
-    auto shape = layer->pooling();
+    auto shape = data->object(layer)->pooler.pooling();
     shape->reset();
 
     //FIXME: all mask
@@ -1276,7 +1303,7 @@ void LottieBuilder::updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effec
         layer->masks[idx]->pathset(frameNo, SHAPE(shape)->rs.path, nullptr, tween, exps);
     }
 
-    shape->transform(layer->cache.matrix);
+    shape->transform(data->layer(layer)->cache.matrix);
     shape->trimpath(effect->begin(frameNo) * 0.01f, effect->end(frameNo) * 0.01f);
     shape->strokeFill(255, 255, 255, (int)(effect->opacity(frameNo) * 255.0f));
     shape->strokeJoin(StrokeJoin::Round);
@@ -1302,11 +1329,11 @@ void LottieBuilder::updateStrokeEffect(LottieLayer* layer, LottieFxStroke* effec
             }
             return true;
         };
-        accessor->set(layer->scene, f, nullptr);
+        accessor->set(data->object(layer)->scene, f, nullptr);
         delete(accessor);
     }
 
-    layer->scene->mask(shape, MaskMethod::Alpha);
+    data->object(layer)->scene->mask(shape, MaskMethod::Alpha);
 }
 
 
@@ -1317,6 +1344,8 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
 
     if (layer->effects.count == 0) return;
 
+    auto scene = data->object(layer)->scene;
+
     ARRAY_FOREACH(p, layer->effects) {
         if (!(*p)->enable) continue;
         switch ((*p)->type) {
@@ -1324,13 +1353,13 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
                 auto effect = static_cast<LottieFxTint*>(*p);
                 auto black = effect->black(frameNo);
                 auto white = effect->white(frameNo);
-                layer->scene->push(SceneEffect::Tint, black.r, black.g, black.b, white.r, white.g, white.b, (double)effect->intensity(frameNo));
+                scene->push(SceneEffect::Tint, black.r, black.g, black.b, white.r, white.g, white.b, (double)effect->intensity(frameNo));
                 break;
             }
             case LottieEffect::Fill: {
                 auto effect = static_cast<LottieFxFill*>(*p);
                 auto color = effect->color(frameNo);
-                layer->scene->push(SceneEffect::Fill, color.r, color.g, color.b, (int)(255.0f * effect->opacity(frameNo)));
+                scene->push(SceneEffect::Fill, color.r, color.g, color.b, (int)(255.0f * effect->opacity(frameNo)));
                 break;
             }
             case LottieEffect::Stroke: {
@@ -1343,19 +1372,19 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
                 auto dark = effect->dark(frameNo);
                 auto midtone = effect->midtone(frameNo);
                 auto bright = effect->bright(frameNo);
-                layer->scene->push(SceneEffect::Tritone, dark.r, dark.g, dark.b, midtone.r, midtone.g, midtone.b, bright.r, bright.g, bright.b, (int)effect->blend(frameNo));
+                scene->push(SceneEffect::Tritone, dark.r, dark.g, dark.b, midtone.r, midtone.g, midtone.b, bright.r, bright.g, bright.b, (int)effect->blend(frameNo));
                 break;
             }
             case LottieEffect::DropShadow: {
                 auto effect = static_cast<LottieFxDropShadow*>(*p);
                 auto color = effect->color(frameNo);
                 //seems the opacity range in dropshadow is 0 ~ 256
-                layer->scene->push(SceneEffect::DropShadow, color.r, color.g, color.b, std::min(255, (int)effect->opacity(frameNo)), (double)effect->angle(frameNo), double(effect->distance(frameNo) * 0.5f), (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), QUALITY);
+                scene->push(SceneEffect::DropShadow, color.r, color.g, color.b, std::min(255, (int)effect->opacity(frameNo)), (double)effect->angle(frameNo), double(effect->distance(frameNo) * 0.5f), (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), QUALITY);
                 break;
             }
             case LottieEffect::GaussianBlur: {
                 auto effect = static_cast<LottieFxGaussianBlur*>(*p);
-                layer->scene->push(SceneEffect::GaussianBlur, (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), effect->direction(frameNo) - 1, effect->wrap(frameNo), QUALITY);
+                scene->push(SceneEffect::GaussianBlur, (double)(effect->blurness(frameNo) * BLUR_TO_SIGMA), effect->direction(frameNo) - 1, effect->wrap(frameNo), QUALITY);
                 break;
             }
             default: break;
@@ -1366,29 +1395,34 @@ void LottieBuilder::updateEffect(LottieLayer* layer, float frameNo)
 
 void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLayer* layer, float frameNo)
 {
-    layer->scene = nullptr;
+    auto rd = data->object(layer);
+    rd->scene = nullptr;
 
     //visibility
     if (frameNo < layer->inFrame || frameNo >= layer->outFrame) return;
 
     updateTransform(layer, frameNo);
 
+    auto& cache = data->layer(layer)->cache;
+
     //full transparent scene. no need to perform
-    if (layer->type != LottieLayer::Null && layer->cache.opacity == 0) return;
+    if (layer->type != LottieLayer::Null && cache.opacity == 0) return;
 
     //Prepare render data
-    layer->scene = Scene::gen();
-    layer->scene->id = layer->id;
+    rd->scene = Scene::gen();
+    rd->scene->id = layer->id;
 
     //ignore opacity when Null layer?
-    if (layer->type != LottieLayer::Null) layer->scene->opacity(layer->cache.opacity);
+    if (layer->type != LottieLayer::Null) rd->scene->opacity(cache.opacity);
 
-    layer->scene->transform(layer->cache.matrix);
+    rd->scene->transform(cache.matrix);
 
     if (!updateMatte(comp, frameNo, scene, layer)) return;
 
     switch (layer->type) {
         case LottieLayer::Precomp: {
+            //the layers of the deferred asset are needed from now on.
+            if (layer->unresolved) _resolve(comp, layer);
             if (!tweening()) updatePrecomp(comp, layer, frameNo);
             else updatePrecomp(comp, layer, frameNo, tween);
             break;
@@ -1398,7 +1432,7 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
             break;
         }
         case LottieLayer::Image: {
-            updateImage(layer);
+            updateImage(comp, layer);
             break;
         }
         case LottieLayer::Text: {
@@ -1408,7 +1442,7 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
         default: {
             if (!layer->children.empty()) {
                 Inlist<RenderContext> contexts;
-                contexts.back(new RenderContext(layer->pooling()));
+                contexts.back(new RenderContext(rd->pooler.pooling()));
                 updateChildren(layer, frameNo, contexts);
                 contexts.free();
             }
@@ -1418,29 +1452,71 @@ void LottieBuilder::updateLayer(LottieComposition* comp, Scene* scene, LottieLay
 
     updateMasks(layer, frameNo);
 
-    layer->scene->blend(layer->blendMethod);
+    rd->scene->blend(layer->blendMethod);
 
     updateEffect(layer, frameNo);
 
-    if (!layer->matteSrc) scene->push(layer->scene);
+    if (scene && !layer->matteSrc) scene->push(rd->scene);
+}
+
+
+static bool _parseDeferred(LottieComposition* comp, LottieLayer* asset)
+{
+    LottieParser parser(comp->source.data, nullptr, false);
+    parser.comp = comp;
+    auto ret = parser.parse(asset);
+
+    //broken asset, drop the half-parsed layers rather than building them
+    if (!ret) {
+        TVGERR("LOTTIE", "Failed to parse the precomp asset(%lu)", asset->id);
+        ARRAY_FOREACH(p, asset->children) delete(*p);
+        asset->children.reset();
+    }
+
+    //all assets are ready, the source is no more necessary
+    if (--comp->source.deferred == 0) {
+        tvg::free(comp->source.data);
+        comp->source.data = nullptr;
+    }
+    return ret;
 }
 
 
-static void _buildReference(LottieComposition* comp, LottieLayer* layer)
+//resolve: parse the deferred precomp asset, otherwise leave it until the layer is visible.
+static void _buildReference(LottieComposition* comp, LottieLayer* layer, bool resolve)
 {
     ARRAY_FOREACH(p, comp->assets) {
         if (layer->rid != (*p)->id) continue;
         if (layer->type == LottieLayer::Precomp) {
+            if ((*p)->type != LottieObject::Layer) break;
             auto assetLayer = static_cast<LottieLayer*>(*p);
+            if (assetLayer->deferred.begin) {
+                if (!resolve) {
+                    layer->unresolved = true;
+                    break;
+                }
+                if (!_parseDeferred(comp, assetLayer)) break;
+            }
             if (_buildComposition(comp, assetLayer)) {
                 layer->children = assetLayer->children;
                 layer->reqFragment = assetLayer->reqFragment;
             }
         } else if (layer->type == LottieLayer::Image) {
-            layer->children.push(*p);
+            if ((*p)->type == LottieObject::Image) layer->children.push(*p);
         }
         break;
     }
+
+    //resolved once, even if the asset turns out empty or broken
+    if (resolve) layer->unresolved = false;
+}
+
+
+//the deferred asset is parsed by whichever instance comes first, the others wait for it.
+static void _resolve(LottieComposition* comp, LottieLayer* layer)
+{
+    ScopedLock lock(comp->sharing.key);
+    if (layer->unresolved) _buildReference(comp, layer, true);
 }
 
 
@@ -1488,6 +1564,35 @@ static void _attachFont(LottieComposition* comp, LottieLayer* parent)
 }
 
 
+//number the objects having the render data of the instances, see LottieRenderData
+static void _index(LottieComposition* comp, LottieGroup* group)
+{
+    group->idx = comp->objects++;
+
+    ARRAY_FOREACH(p, group->children) {
+        auto child = *p;
+        switch (child->type) {
+            case LottieObject::Group: {
+                //the fragmenting requirement is inherited to the children, see updateChildren()
+                auto sub = static_cast<LottieGroup*>(child);
+                sub->reqFragment |= group->reqFragment;
+                _index(comp, sub);
+                break;
+            }
+            case LottieObject::Rect:
+            case LottieObject::Ellipse:
+            case LottieObject::Path:
+            case LottieObject::Polystar:
+            case LottieObject::Text: {
+                child->idx = comp->objects++;
+                break;
+            }
+            default: break;
+        }
+    }
+}
+
+
 static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
 {
     if (parent->children.count == 0) return false;
@@ -1497,6 +1602,8 @@ static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
     ARRAY_FOREACH(p, parent->children) {
         auto child = static_cast<LottieLayer*>(*p);
 
+        _index(comp, child);
+
         //attach the precomp layer.
         if (child->rid) _buildReference(comp, child);
 
@@ -1530,7 +1637,7 @@ static bool _buildComposition(LottieComposition* comp, LottieLayer* parent)
 /* External Class Implementation                                        */
 /************************************************************************/
 
-bool LottieBuilder::update(LottieComposition* comp, float frameNo)
+bool LottieBuilder::update(LottieComposition* comp, Scene* scene, float frameNo)
 {
     if (comp->root->children.empty()) return false;
 
@@ -1542,33 +1649,253 @@ bool LottieBuilder::update(LottieComposition* comp, float frameNo)
         if (equal(frameNo, tween.frameNo)) offTween();
     }
 
-    if (exps && comp->expressions) exps->update(comp->timeAtFrame(frameNo));
+    if (exps && comp->expressions) exps->update(comp->timeAtFrame(frameNo), data);
+
+    if (concurrent(comp, scene, frameNo)) return true;
 
     //update children layers
     ARRAY_REVERSE_FOREACH(child, comp->root->children) {
         auto layer = static_cast<LottieLayer*>(*child);
-        if (!layer->matteSrc) updateLayer(comp, comp->root->scene, layer, frameNo);
+        if (!layer->matteSrc) updateLayer(comp, scene, layer, frameNo);
     }
 
     return true;
 }
 
 
+/* Update a group of the root layers. Either the requester or a worker updates it,
+   whoever comes first. The worker side has its own builder for the scratch data. */
+struct LottieBuilder::UpdateTask : Task
+{
+    LottieBuilder builder;
+    LottieComposition* comp = nullptr;
+    Array<LottieLayer*> layers;
+    Array<unsigned long> rids;        //the resources touched by the layers
+    float frameNo = 0.0f;
+    atomic<bool> claimed{false};
+    atomic<bool> finished{false};     //popped out of the queue
+    bool requested = false;
+
+    UpdateTask(LottieComposition* comp, LottieRenderData* data) : builder(nullptr, data), comp(comp) {}
+
+    bool update()
+    {
+        if (claimed.exchange(true)) return false;
+        ARRAY_FOREACH(p, layers) builder.updateLayer(comp, nullptr, *p, frameNo);
+        return true;
+    }
+
+    bool shares(const Array<unsigned long>& rhs)
+    {
+        ARRAY_FOREACH(p, rids) {
+            ARRAY_FOREACH(q, rhs) {
+                if (*p == *q) return true;
+            }
+        }
+        return false;
+    }
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        update();
+        finished = true;
+    }
+};
+
+
+//the text and image layers might share the fonts or the image loaders under the hood.
+#define LOTTIE_SHARED_RESOURCE (~0UL)
+
+static void _footprint(LottieComposition* comp, LottieLayer* layer, Array<unsigned long>& rids)
+{
+    if (layer->type == LottieLayer::Text || layer->type == LottieLayer::Image) {
+        rids.push(LOTTIE_SHARED_RESOURCE);
+    } else if (layer->type == LottieLayer::Precomp && layer->rid) {
+        ARRAY_FOREACH(p, rids) {
+            if (*p == layer->rid) return;
+        }
+        rids.push(layer->rid);
+        //the deferred assets are resolved in advance, they must not be parsed on the workers.
+        if (layer->unresolved) _resolve(comp, layer);
+        ARRAY_FOREACH(p, layer->children) {
+            _footprint(comp, static_cast<LottieLayer*>(*p), rids);
+        }
+    }
+    if (layer->matteTarget) _footprint(comp, layer->matteTarget, rids);
+}
+
+
+/* The root layers are independent of each other unless they reach the same assets
+   (the precomp instances share the layers of the asset) or the shared resources.
+   Group them by their footprints, each group is updated on its own. */
+void LottieBuilder::partition(LottieComposition* comp)
+{
+    partitioned = true;
+
+    ARRAY_REVERSE_FOREACH(child, comp->root->children) {
+        auto layer = static_cast<LottieLayer*>(*child);
+        if (layer->matteSrc) continue;
+
+        auto task = new UpdateTask(comp, data);
+        _footprint(comp, layer, task->rids);
+
+        //merge the groups sharing the resources with this, keeping the update order of the layers
+        Array<UpdateTask*> others;
+        ARRAY_FOREACH(p, tasks) {
+            if ((*p)->shares(task->rids)) {
+                task->layers.push((*p)->layers);
+                task->rids.push((*p)->rids);
+                delete(*p);
+            } else others.push(*p);
+        }
+        task->layers.push(layer);
+        others.push(task);
+        tasks.clear();
+        tasks.push(others);
+    }
+
+    //too fine-grained tasks are not worth, bundle them up to a few per thread.
+    auto cnt = TaskScheduler::threads() * 4;
+    if (tasks.count <= cnt) return;
+
+    for (uint32_t i = cnt; i < tasks.count; ++i) {
+        auto bundle = tasks[i % cnt];
+        bundle->layers.push(tasks[i]->layers);
+        bundle->rids.push(tasks[i]->rids);
+        delete(tasks[i]);
+    }
+    tasks.count = cnt;
+}
+
+
+bool LottieBuilder::concurrent(LottieComposition* comp, Scene* scene, float frameNo)
+{
+    if (TaskScheduler::threads() < 2 || tweening() || comp->expressions) return false;
+
+    if (!partitioned) partition(comp);
+    if (tasks.count < 2) return false;
+
+    //release the retired tasks that left the queues
+    Array<UpdateTask*> queued;
+    ARRAY_FOREACH(p, retired) {
+        if ((*p)->finished) {
+            (*p)->done();
+            delete(*p);
+        } else queued.push(*p);
+    }
+    retired.clear();
+    retired.push(queued);
+
+    //the render data of the objects is accessed by the workers from now on
+    {
+        ScopedLock lock(comp->sharing.key);
+        data->reserve(comp->objects);
+    }
+
+    //the parent transforms are referred across the groups, resolve them in advance.
+    ARRAY_FOREACH(p, comp->root->children) {
+        auto layer = static_cast<LottieLayer*>(*p);
+        if (frameNo >= layer->inFrame && frameNo < layer->outFrame) updateTransform(layer, frameNo);
+    }
+
+    ARRAY_FOREACH(p, tasks) {
+        auto task = *p;
+        //still in a queue since the last frame, leave it and replace with a new one.
+        if (task->requested && !task->finished) {
+            retired.push(task);
+            *p = new UpdateTask(comp, data);
+            (*p)->layers = task->layers;
+            (*p)->rids = task->rids;
+            task = *p;
+        } else task->done();
+        task->frameNo = frameNo;
+        task->claimed = false;
+        task->finished = false;
+        task->requested = true;
+        TaskScheduler::request(task);
+    }
+
+    /* Update the groups not started yet in the meantime. Wait only for the groups running
+       on the workers: the rest might stay in the queue of this worker thread. */
+    Array<bool> started(tasks.count);
+    ARRAY_FOREACH(p, tasks) started.push(!(*p)->update());
+
+    for (uint32_t i = 0; i < tasks.count; ++i) {
+        if (started[i]) tasks[i]->done();
+    }
+
+    ARRAY_REVERSE_FOREACH(child, comp->root->children) {
+        auto layer = static_cast<LottieLayer*>(*child);
+        auto rd = data->object(layer);
+        if (!layer->matteSrc && rd->scene) scene->push(rd->scene);
+    }
+
+    return true;
+}
+
+
+LottieBuilder::LottieBuilder() : data(new LottieRenderData)
+{
+    exps = LottieExpressions::instance();
+}
+
+
+LottieBuilder::~LottieBuilder()
+{
+    //the tasks might be still in the queues
+    ARRAY_FOREACH(p, tasks) {
+        (*p)->done();
+        delete(*p);
+    }
+    ARRAY_FOREACH(p, retired) {
+        (*p)->done();
+        delete(*p);
+    }
+    if (exps) LottieExpressions::retrieve(exps);
+    if (!worker) delete(data);
+}
+
+
+//drop the render data built from the overridden properties
+void LottieBuilder::reset()
+{
+    data->clear();
+}
+
+
 void LottieBuilder::build(LottieComposition* comp)
 {
     if (!comp) return;
 
-    comp->root->scene = Scene::gen();
-
     _buildComposition(comp, comp->root);
+}
+
+
+//parse all the deferred precomp assets in advance, the caller must hold the sharing key.
+void LottieBuilder::resolve(LottieComposition* comp)
+{
+    ARRAY_FOREACH(p, comp->assets) {
+        if (comp->source.deferred == 0) break;
+        if ((*p)->type != LottieObject::Layer) continue;
+        auto asset = static_cast<LottieLayer*>(*p);
+        if (asset->deferred.begin) _parseDeferred(comp, asset);
+    }
+}
+
 
-    if (!update(comp, 0)) return;
+Scene* LottieBuilder::instantiate(LottieComposition* comp)
+{
+    auto scene = Scene::gen();
+
+    if (!update(comp, scene, 0)) return scene;
 
     //viewport clip
     auto clip = Shape::gen();
     clip->appendRect(0, 0, comp->w, comp->h);
-    comp->root->scene->clip(clip);
+    scene->clip(clip);
 
     //turn off partial rendering for children
-    SCENE(comp->root->scene)->size({comp->w, comp->h});
-}
\ No newline at end of file
+    SCENE(scene)->size({comp->w, comp->h});
+
+    return scene;
+}
@@ -30,6 +30,7 @@
 #include "tvgLottieModifier.h"
 
 struct LottieComposition;
+struct LottieRenderData;
 
 struct RenderRepeater
 {
@@ -106,15 +107,8 @@ struct RenderContext
 
 struct LottieBuilder
 {
-    LottieBuilder()
-    {
-        exps = LottieExpressions::instance();
-    }
-
-    ~LottieBuilder()
-    {
-        LottieExpressions::retrieve(exps);
-    }
+    LottieBuilder();
+    ~LottieBuilder();
 
     bool expressions()
     {
@@ -138,10 +132,19 @@ struct LottieBuilder
         return tween.active;
     }
 
-    bool update(LottieComposition* comp, float progress);
+    bool update(LottieComposition* comp, Scene* scene, float frameNo);
     void build(LottieComposition* comp);
+    void resolve(LottieComposition* comp);
+    Scene* instantiate(LottieComposition* comp);
+    void reset();
 
 private:
+    struct UpdateTask;
+
+    LottieBuilder(LottieExpressions* exps, LottieRenderData* data) : exps(exps), data(data), worker(true) {}
+
+    void partition(LottieComposition* comp);
+    bool concurrent(LottieComposition* comp, Scene* scene, float frameNo);
     void appendRect(Shape* shape, Point& pos, Point& size, float r, bool clockwise, RenderContext* ctx);
     bool fragmented(LottieGroup* parent, LottieObject** child, Inlist<RenderContext>& contexts, RenderContext* ctx, RenderFragment fragment);
 
@@ -152,7 +155,7 @@ private:
     void updatePrecomp(LottieComposition* comp, LottieLayer* precomp, float frameNo);
     void updatePrecomp(LottieComposition* comp, LottieLayer* precomp, float frameNo, Tween& tween);
     void updateSolid(LottieLayer* layer);
-    void updateImage(LottieGroup* layer);
+    void updateImage(LottieComposition* comp, LottieLayer* layer);
     void updateText(LottieLayer* layer, float frameNo);
     void updateMasks(LottieLayer* layer, float frameNo);
     void updateTransform(LottieLayer* layer, float frameNo);
@@ -176,7 +179,12 @@ private:
 
     RenderPath buffer;   //resusable path
     LottieExpressions* exps;
+    LottieRenderData* data;       //the render data of this instance, see LottieRenderData
     Tween tween;
+    Array<UpdateTask*> tasks;     //the independent root layer groups, see partition()
+    Array<UpdateTask*> retired;   //the tasks which might be still in the queues
+    bool partitioned = false;
+    bool worker = false;          //the builder of an UpdateTask, it doesn't own the data
 };
 
 #endif //_TVG_LOTTIE_BUILDER_H
\ No newline at end of file
@@ -52,20 +52,20 @@ struct ColorStop
 struct TextDocument
 {
     char* text = nullptr;
-    float height;
-    float shift;
-    RGB32 color;
+    float height = 0.0f;
+    float shift = 0.0f;
+    RGB32 color = {0, 0, 0};
     struct {
-        Point pos;
-        Point size;
+        Point pos = {0.0f, 0.0f};
+        Point size = {0.0f, 0.0f};
     } bbox;
     struct {
-        RGB32 color;
-        float width;
+        RGB32 color = {0, 0, 0};
+        float width = 0.0f;
         bool below = false;
     } stroke;
     char* name = nullptr;
-    float size;
+    float size = 0.0f;
     float tracking = 0.0f;
     float justify = 0.0f;    //horizontal alignment
     uint8_t caps = 0;        //0: Regular, 1: AllCaps, 2: SmallCaps
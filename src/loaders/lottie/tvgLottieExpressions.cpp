@@ -174,7 +174,7 @@ static unsigned long _idByName(jerry_value_t args)
 static jerry_value_t _toComp(const jerry_call_info_t* info, const jerry_value_t args[], const jerry_length_t argsCnt)
 {
     auto layer = static_cast<LottieLayer*>(jerry_object_get_native_ptr(info->function, nullptr));
-    return _point2d(_point2d(args[0]) * layer->cache.matrix);
+    return _point2d(_point2d(args[0]) * exps->data->layer(layer)->cache.matrix);
 }
 
 
@@ -1443,8 +1443,10 @@ LottieExpressions::LottieExpressions()
 }
 
 
-void LottieExpressions::update(float curTime)
+void LottieExpressions::update(float curTime, LottieRenderData* data)
 {
+    this->data = data;
+
     //time, #current time in seconds
     auto time = jerry_number(curTime);
     jerry_object_set_sz(global, EXP_TIME, time);
@@ -30,6 +30,7 @@ struct LottieExpression;
 struct LottieComposition;
 struct LottieLayer;
 struct LottieModifier;
+struct LottieRenderData;
 
 #ifdef THORVG_LOTTIE_EXPRESSIONS_SUPPORT
 
@@ -125,7 +126,9 @@ public:
         return true;
     }
 
-    void update(float curTime);
+    void update(float curTime, LottieRenderData* data);
+
+    LottieRenderData* data = nullptr;   //the render data of the instance being updated
 
     //singleton (no thread safety)
     static LottieExpressions* instance();
@@ -164,7 +167,7 @@ struct LottieExpressions
     template<typename Property> bool result(TVG_UNUSED float, TVG_UNUSED Fill*, TVG_UNUSED LottieExpression*) { return false; }
     template<typename Property> bool result(TVG_UNUSED float, TVG_UNUSED RenderPath&, TVG_UNUSED Matrix*, TVG_UNUSED LottieModifier*, TVG_UNUSED LottieExpression*) { return false; }
     bool result(TVG_UNUSED float, TVG_UNUSED TextDocument& doc, TVG_UNUSED LottieExpression*) { return false; }
-    void update(TVG_UNUSED float) {}
+    void update(TVG_UNUSED float, TVG_UNUSED LottieRenderData*) {}
     static LottieExpressions* instance() { return nullptr; }
     static void retrieve(TVG_UNUSED LottieExpressions* instance) {}
 };
@@ -37,6 +37,7 @@
 #define NEWTON_ITERATIONS 4
 #define SUBDIVISION_PRECISION 0.0000001f
 #define SUBDIVISION_MAX_ITERATIONS 10
+#define EASING_TABLE_PRECISION 0.0001f
 
 
 static inline float _constA(float aA1, float aA2) { return 1.0f - 3.0f * aA2 + 3.0f * aA1; }
@@ -113,6 +114,12 @@ float LottieInterpolator::NewtonRaphsonIterate(float aX, float aGuessT)
 }
 
 
+float LottieInterpolator::evaluate(float t)
+{
+    return _calcBezier(getTForX(t), outTangent.y, inTangent.y);
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -120,8 +127,42 @@ float LottieInterpolator::NewtonRaphsonIterate(float aX, float aGuessT)
 float LottieInterpolator::progress(float t)
 {
     if (outTangent.x == outTangent.y && inTangent.x == inTangent.y) return t;
-    return _calcBezier(getTForX(t), outTangent.y, inTangent.y);
+
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+    if (baked && t >= 0.0f && t <= 1.0f) {
+        auto pos = t * EASING_TABLE_SIZE;
+        auto idx = static_cast<int>(pos);
+        if (idx == EASING_TABLE_SIZE) return values[idx];
+        return tvg::lerp(values[idx], values[idx + 1], pos - idx);
+    }
+#endif
+    return evaluate(t);
+}
+
+
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+/* Bake the easing curve into a directly indexed table to skip the root finding of getTForX()
+   in every frame. The table is abandoned if the linear interpolation of its entries doesn't
+   satisfy the precision, i.e. with the extremely steep curves. It's done once at the parsing,
+   the table is read-only while the instances are updating the frames. */
+bool LottieInterpolator::bake()
+{
+    if (outTangent.x == outTangent.y && inTangent.x == inTangent.y) return false;
+
+    for (int i = 0; i <= EASING_TABLE_SIZE; ++i) {
+        values[i] = evaluate(float(i) / EASING_TABLE_SIZE);
+    }
+
+    //verify the error in the middle of the entries, where it's the largest
+    for (int i = 0; i < EASING_TABLE_SIZE; ++i) {
+        auto mid = evaluate((float(i) + 0.5f) / EASING_TABLE_SIZE);
+        if (fabsf(mid - (values[i] + values[i + 1]) * 0.5f) > EASING_TABLE_PRECISION) return false;
+    }
+
+    baked = true;
+    return true;
 }
+#endif
 
 
 void LottieInterpolator::set(const char* key, Point& inTangent, Point& outTangent)
@@ -129,6 +170,9 @@ void LottieInterpolator::set(const char* key, Point& inTangent, Point& outTangen
     if (key) this->key = duplicate(key);
     this->inTangent = inTangent;
     this->outTangent = outTangent;
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+    this->baked = false;
+#endif
 
     if (outTangent.x == outTangent.y && inTangent.x == inTangent.y) return;
 
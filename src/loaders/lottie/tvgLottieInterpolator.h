@@ -24,6 +24,7 @@
 #define _TVG_LOTTIE_INTERPOLATOR_H_
 
 #define SPLINE_TABLE_SIZE 11
+#define EASING_TABLE_SIZE 256
 
 struct LottieInterpolator
 {
@@ -32,10 +33,19 @@ struct LottieInterpolator
 
     float progress(float t);
     void set(const char* key, Point& inTangent, Point& outTangent);
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+    bool bake();
+#endif
 
 private:
     static constexpr float SAMPLE_STEP_SIZE = 1.0f / float(SPLINE_TABLE_SIZE - 1);
     float samples[SPLINE_TABLE_SIZE];
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+    float values[EASING_TABLE_SIZE + 1];  //progress(t) baked in evenly spaced t, ~1KB per curve, see bake()
+    bool baked;
+#endif
+
+    float evaluate(float t);
 
     float getTForX(float aX);
     float binarySubdivide(float aX, float aA, float aB);
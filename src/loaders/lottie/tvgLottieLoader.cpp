@@ -21,40 +21,205 @@
  */
 
 #include "tvgStr.h"
+#include "tvgScene.h"
  #include "tvgLottieLoader.h"
 #include "tvgLottieModel.h"
 #include "tvgLottieParser.h"
 #include "tvgLottieBuilder.h"
+#include "tvgLottieBinary.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+//the parsed compositions which are shared among the loaders of the identical source
+static Inlist<LottieComposition> _shared;
+static Key _key;
+
+
+//a file, or the copied data identified by its content. the data not copied is never shared
+//since the parser consumes it in place and the users could reuse the memory for another one.
+static bool _shareable(LottieLoader* loader)
+{
+    return loader->hashpath || loader->copy;
+}
+
+
+static LottieComposition* _find(LottieLoader* loader)
+{
+    INLIST_FOREACH(_shared, comp) {
+        auto& sharing = comp->sharing;
+        if (loader->hashpath) {
+            if (sharing.path && !strcmp(sharing.path, loader->hashpath)) return comp;
+        } else if (!sharing.path && sharing.size == loader->size && !memcmp(sharing.digest, loader->digest, sizeof(sharing.digest)) && !strcmp(sharing.dir, loader->dirName)) {
+            return comp;
+        }
+    }
+    return nullptr;
+}
+
+
+static LottieComposition* _acquire(LottieLoader* loader)
+{
+    if (!_shareable(loader)) return nullptr;
+
+    ScopedLock lock(_key);
+    auto comp = _find(loader);
+    if (comp) ++comp->sharing.cnt;
+    return comp;
+}
+
+
+//return the registered one instead if the other loader has done it first.
+static LottieComposition* _register(LottieComposition* comp, LottieLoader* loader)
+{
+    if (!_shareable(loader) || !comp->shareable()) return comp;
+
+    ScopedLock lock(_key);
+    if (auto ret = _find(loader)) {
+        ++ret->sharing.cnt;
+        delete(comp);
+        return ret;
+    }
+    if (loader->hashpath) {
+        comp->sharing.path = duplicate(loader->hashpath);
+    } else {
+        comp->sharing.size = loader->size;
+        memcpy(comp->sharing.digest, loader->digest, sizeof(comp->sharing.digest));
+        comp->sharing.dir = duplicate(loader->dirName);
+    }
+    comp->sharing.cnt = 1;
+    _shared.back(comp);
+    return comp;
+}
+
+
+//the last one deletes it within the lock, no one can find a dying composition.
+static void _release(LottieComposition* comp)
+{
+    if (!comp) return;
+
+    ScopedLock lock(_key);
+    if (comp->sharing.cnt > 0) {
+        if (--comp->sharing.cnt > 0) return;
+        _shared.remove(comp);
+    }
+    delete(comp);
+}
+
+
+LottieComposition* LottieLoader::parse()
+{
+    //compiled lottie, restore the model without parsing
+    if (LottieBinary::header(content, size)) {
+        auto comp = LottieBinary::read(content, size, dirName, builder->expressions());
+        if (!comp) return nullptr;
+        builder->build(comp);
+        release();
+        return _register(comp, this);
+    }
+
+    LottieParser parser(content, dirName, builder->expressions());
+    parser.lazy = copy;  //the source must be kept to parse the precomp assets on demand
+    if (!parser.parse()) return nullptr;
+
+    //hand over the source to the composition
+    if (parser.deferred > 0) {
+        parser.comp->source.data = const_cast<char*>(content);
+        parser.comp->source.size = size;
+        parser.comp->source.deferred = parser.deferred;
+        content = nullptr;
+    }
+
+    if (parser.slots) {
+        {
+            ScopedLock lock(key);
+            comp = parser.comp;
+        }
+        override(parser.slots, true);
+        parser.slots = nullptr;
+    }
+    builder->build(parser.comp);
+
+    release();
+
+    return _register(parser.comp, this);
+}
+
+
 void LottieLoader::run(unsigned tid)
 {
     //update frame
     if (comp) {
-        builder->update(comp, frameNo);
+        if (rebuild) builder->reset();
+        builder->update(comp, root, frameNo);
     //initial loading
     } else {
-        LottieParser parser(content, dirName, builder->expressions());
-        if (!parser.parse()) return;
+        auto comp = shared ? shared : parse();
+        if (!comp) return;
         {
             ScopedLock lock(key);
-            comp = parser.comp;
+            this->comp = comp;
         }
-        if (parser.slots) {
-            override(parser.slots, true);
-            parser.slots = nullptr;
-        }
-        builder->build(comp);
-
-        release();
+        root = builder->instantiate(comp);
     }
     rebuild = false;
 }
 
 
+void LottieLoader::clear()
+{
+    if (!root) return;
+
+    //clear synchronously
+    root->remove();
+
+    //release the outdated look-ahead as well
+    if (ahead.scene) ahead.scene->remove();
+    ahead.frameNo = -1.0f;
+}
+
+
+//replace the current scene tree with the look-ahead one
+void LottieLoader::present()
+{
+    root->remove();
+
+    auto& paints = SCENE(ahead.scene)->paints;
+    for (auto paint : paints) {
+        PAINT(paint)->unref(false);
+        root->push(paint);
+    }
+    paints.clear();
+    ahead.frameNo = -1.0f;
+}
+
+
+void LottieLoader::lookahead()
+{
+    if (!ahead.sequential || TaskScheduler::threads() == 0 || !comp || comp->expressions || builder->tweening()) return;
+
+    auto next = frameNo + ahead.step;
+    if (next < startFrame() || next - startFrame() > totalFrame()) return;
+
+    //requested already
+    if (fabsf(ahead.frameNo - next) <= 0.0009f) return;
+
+    ahead.done();
+    if (!ahead.scene) ahead.scene = Scene::gen();
+    ahead.frameNo = next;
+
+    TaskScheduler::request(&ahead);
+}
+
+
+void LottieLoader::Lookahead::run(TVG_UNUSED unsigned tid)
+{
+    scene->remove();
+    loader->builder->update(loader->comp, scene, frameNo);
+}
+
+
 void LottieLoader::release()
 {
     if (copy) {
@@ -68,7 +233,7 @@ void LottieLoader::release()
 /* External Class Implementation                                        */
 /************************************************************************/
 
-LottieLoader::LottieLoader() : FrameModule(FileType::Lot), builder(new LottieBuilder)
+LottieLoader::LottieLoader() : FrameModule(FileType::Lot), builder(new LottieBuilder), ahead(this)
 {
 
 }
@@ -77,12 +242,14 @@ LottieLoader::LottieLoader() : FrameModule(FileType::Lot), builder(new LottieBui
 LottieLoader::~LottieLoader()
 {
     done();
+    ahead.done();
 
     release();
 
-    //TODO: correct position?
-    delete(comp);
+    if (root && !initiated) delete(root);
+    delete(ahead.scene);
     delete(builder);
+    _release(comp ? comp : shared);
 
     tvg::free(dirName);
 }
@@ -90,6 +257,19 @@ LottieLoader::~LottieLoader()
 
 bool LottieLoader::header()
 {
+    //the identical source has been parsed already.
+    if (shared) {
+        w = shared->w;
+        h = shared->h;
+        segmentEnd = frameCnt = shared->frameCnt();
+        frameRate = shared->frameRate;
+        return true;
+    }
+
+    //compiled lottie, its header tells the animation info.
+    LottieBinaryHeader binary;
+    auto compiled = LottieBinary::header(content, size, &binary);
+
     //A single thread doesn't need to perform intensive tasks.
     if (TaskScheduler::threads() == 0) {
         LoadModule::read();
@@ -105,6 +285,15 @@ bool LottieLoader::header()
         }
     }
 
+    if (compiled) {
+        if (binary.frameRate < FLOAT_EPSILON) return false;
+        w = binary.w;
+        h = binary.h;
+        frameRate = binary.frameRate;
+        segmentEnd = frameCnt = (binary.endFrame - binary.startFrame);
+        return true;
+    }
+
     //Quickly validate the given Lottie file without parsing in order to get the animation info.
     auto startFrame = 0.0f;
     auto endFrame = 0.0f;
@@ -199,19 +388,25 @@ bool LottieLoader::header()
 
 bool LottieLoader::open(const char* data, uint32_t size, const char* rpath, bool copy)
 {
-    if (copy) {
-        content = tvg::malloc<char*>(size + 1);
-        if (!content) return false;
-        memcpy((char*)content, data, size);
-        const_cast<char*>(content)[size] = '\0';
-    } else content = data;
-
     this->size = size;
     this->copy = copy;
 
     if (!rpath) this->dirName = duplicate(".");
     else this->dirName = duplicate(rpath);
 
+    //no need to copy and parse the data if the identical one has been parsed already
+    if (copy) {
+        sha256(reinterpret_cast<const uint8_t*>(data), size, digest);
+        if ((shared = _acquire(this))) return header();
+
+        content = tvg::malloc<char*>(size + 1);
+        if (!content) return false;
+        memcpy((char*)content, data, size);
+        const_cast<char*>(content)[size] = '\0';
+    } else {
+        content = data;
+    }
+
     return header();
 }
 
@@ -219,7 +414,13 @@ bool LottieLoader::open(const char* data, uint32_t size, const char* rpath, bool
 bool LottieLoader::open(const char* path)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
-    auto f = fopen(path, "r");
+    this->dirName = tvg::dirname(path);
+    this->hashpath = duplicate(path);
+
+    //no need to read the file if the parsed composition is available
+    if ((shared = _acquire(this))) return header();
+
+    auto f = fopen(path, "rb");
     if (!f) return false;
 
     fseek(f, 0, SEEK_END);
@@ -237,7 +438,6 @@ bool LottieLoader::open(const char* path)
 
     fclose(f);
 
-    this->dirName = tvg::dirname(path);
     this->content = content;
     this->copy = true;
 
@@ -270,7 +470,7 @@ bool LottieLoader::read()
     //the loading has been already completed
     if (!LoadModule::read()) return true;
 
-    if (!content || size == 0) return false;
+    if (!shared && (!content || size == 0)) return false;
 
     TaskScheduler::request(this);
 
@@ -282,9 +482,9 @@ Paint* LottieLoader::paint()
 {
     done();
 
-    if (!comp) return nullptr;
-    comp->initiated = true;
-    return comp->root->scene;
+    if (!root) return nullptr;
+    initiated = true;
+    return root;
 }
 
 
@@ -292,6 +492,10 @@ bool LottieLoader::override(const char* slots, bool byDefault)
 {
     if (!ready() || comp->slots.count == 0) return false;
 
+    //the look-ahead frame is outdated
+    ahead.done();
+    ahead.frameNo = -1.0f;
+
     //override slots
     if (slots) {
         //Copy the input data because the JSON parser will encode the data immediately.
@@ -342,12 +546,24 @@ bool LottieLoader::frame(float no)
     if (!builder->tweening() && fabsf(this->frameNo - no) <= 0.0009f) return false;
 
     this->done();
+    ahead.done();
+
+    //keep track of the regular playback
+    auto step = no - this->frameNo;
+    ahead.sequential = !builder->tweening() && fabsf(step - ahead.step) <= 0.0009f;
+    ahead.step = step;
 
     this->frameNo = no;
 
     builder->offTween();
 
-    if (comp) comp->clear();     //clear synchronously
+    //the frame has been prepared in advance
+    if (ahead.scene && fabsf(ahead.frameNo - no) <= 0.0009f) {
+        present();
+        return true;
+    }
+
+    clear();
 
     TaskScheduler::request(this);
 
@@ -383,7 +599,12 @@ void LottieLoader::sync()
 {
     done();
 
-    if (rebuild) run(0);
+    if (rebuild) {
+        ahead.done();
+        run(0);
+    }
+
+    lookahead();
 }
 
 
@@ -442,6 +663,19 @@ bool LottieLoader::ready()
 }
 
 
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+
+bool LottieLoader::compile(Array<uint8_t>& out)
+{
+    //the deferred assets are parsed in advance, the shared model is guarded meanwhile.
+    ScopedLock lock(comp->sharing.key);
+    builder->resolve(comp);
+    return LottieBinary::write(comp, dirName, out);
+}
+
+#endif
+
+
 bool LottieLoader::tween(float from, float to, float progress)
 {
     //tweening is not necessary
@@ -449,12 +683,13 @@ bool LottieLoader::tween(float from, float to, float progress)
     else if (tvg::equal(progress, 1.0f)) return frame(to);
 
     done();
+    ahead.done();
 
     frameNo = shorten(from);
 
     builder->onTween(shorten(to), progress);
 
-    if (comp) comp->clear();     //clear synchronously
+    clear();
 
     TaskScheduler::request(this);
 
@@ -33,20 +33,38 @@ struct LottieBuilder;
 class LottieLoader : public FrameModule, public Task
 {
 public:
+    //builds the next frame of the regular playback in advance while the current one is being drawn
+    struct Lookahead : Task
+    {
+        LottieLoader* loader;
+        Scene* scene = nullptr;        //the scene tree of the next frame
+        float frameNo = -1.0f;         //the frame number of the scene
+        float step = 0.0f;             //the last frame step
+        bool sequential = false;       //the frames are stepping regularly
+
+        Lookahead(LottieLoader* loader) : loader(loader) {}
+        void run(unsigned tid) override;
+    };
+
     const char* content = nullptr;      //lottie file data
     uint32_t size = 0;                  //lottie data size
+    uint8_t digest[32];                 //sha-256 of the lottie data, only for the copied data
     float frameNo = 0.0f;               //current frame number
     float frameCnt = 0.0f;
     float frameRate = 0.0f;
 
     LottieBuilder* builder;
     LottieComposition* comp = nullptr;
+    LottieComposition* shared = nullptr;  //the parsed composition of the identical source
+    Scene* root = nullptr;                 //the scene tree of this instance
+    Lookahead ahead;
 
     Key key;
     char* dirName = nullptr;            //base resource directory
     bool copy = false;                  //"content" is owned by this loader
     bool overridden = false;            //overridden properties with slots
     bool rebuild = false;               //require building the lottie scene
+    bool initiated = false;             //the scene tree is handed over to the picture
 
     LottieLoader();
     ~LottieLoader();
@@ -74,11 +92,17 @@ public:
     float shorten(float frameNo);  //Reduce the accuracy for performance
     bool tween(float from, float to, float progress);
     bool assign(const char* layer, uint32_t ix, const char* var, float val);
+    bool ready();
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+    bool compile(Array<uint8_t>& out);
+#endif
 
 private:
-    bool ready();
     bool header();
     void clear();
+    void present();
+    void lookahead();
+    LottieComposition* parse();
     float startFrame();
     void run(unsigned tid) override;
     void release();
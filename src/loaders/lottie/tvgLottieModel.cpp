@@ -22,6 +22,7 @@
 
 #include "tvgMath.h"
 #include "tvgTaskScheduler.h"
+#include "tvgPicture.h"
 #include "tvgLottieModel.h"
 #include "tvgCompressor.h"
 
@@ -30,7 +31,7 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-Point LottieTextFollowPath::split(float dLen, float lenSearched, float& angle)
+Point LottieTextFollowPath::Cursor::split(float dLen, float lenSearched, float& angle)
 {
     switch (*cmds) {
         case PathCommand::MoveTo: {
@@ -61,24 +62,23 @@ Point LottieTextFollowPath::split(float dLen, float lenSearched, float& angle)
 /* External Class Implementation                                        */
 /************************************************************************/
 
-float LottieTextFollowPath::prepare(LottieMask* mask, float frameNo, float scale, Tween& tween, LottieExpressions* exps)
+float LottieTextFollowPath::prepare(Cursor& cursor, LottieMask* mask, float frameNo, float scale, Tween& tween, LottieExpressions* exps)
 {
-    this->mask = mask;
     Matrix m{1.0f / scale, 0.0f, 0.0f, 0.0f, 1.0f / scale, 0.0f, 0.0f, 0.0f, 1.0f};
-    path.clear();
-    mask->pathset(frameNo, path, &m, tween, exps);
+    cursor.path.clear();
+    mask->pathset(frameNo, cursor.path, &m, tween, exps);
 
-    pts = path.pts.data;
-    cmds = path.cmds.data;
-    cmdsCnt = path.cmds.count;
-    totalLen = tvg::length(cmds, cmdsCnt, pts, path.pts.count);
-    currentLen = 0.0f;
-    start = pts;
+    cursor.pts = cursor.path.pts.data;
+    cursor.cmds = cursor.path.cmds.data;
+    cursor.cmdsCnt = cursor.path.cmds.count;
+    cursor.totalLen = tvg::length(cursor.cmds, cursor.cmdsCnt, cursor.pts, cursor.path.pts.count);
+    cursor.currentLen = 0.0f;
+    cursor.start = cursor.pts;
 
     return firstMargin(frameNo, tween, exps) / scale;
 }
 
-Point LottieTextFollowPath::position(float lenSearched, float& angle)
+Point LottieTextFollowPath::Cursor::position(float lenSearched, float& angle)
 {
     //position before the start of the curve
     if (lenSearched <= 0.0f) {
@@ -356,27 +356,36 @@ void LottieImage::prepare()
 {
     LottieObject::type = LottieObject::Image;
 
-    auto picture = Picture::gen();
-
-    //force to load a picture on the same thread
-    if (data.size > 0) picture->load((const char*)data.b64Data, data.size, data.mimeType);
-    else picture->load(data.path);
-
-    picture->size(data.width, data.height);
+    //the image data is loaded on its first use, see load()
+    picture = Picture::gen();
     picture->ref();
+}
+
 
-    pooler.push(picture);
+void LottieImage::load()
+{
+    if (loaded) return;
+    update();
 }
 
 
 void LottieImage::update()
 {
-    //Update the picture data
-    ARRAY_FOREACH(p, pooler) {
-        if (data.size > 0) (*p)->load((const char*)data.b64Data, data.size, data.mimeType);
-        else (*p)->load(data.path);
-        (*p)->size(data.width, data.height);
-    }
+    data.decode();
+
+    //load the picture on this thread, it might be a worker that waits for it
+    auto async = TaskScheduler::async(false);
+
+    if (data.size > 0) picture->load((const char*)data.b64Data, data.size, data.mimeType);
+    else picture->load(data.path);
+    picture->size(data.width, data.height);
+
+    //realize the data now, the instances only read it while copying the picture
+    PICTURE(picture)->load();
+
+    TaskScheduler::async(async);
+
+    loaded = true;
 }
 
 
@@ -647,6 +656,8 @@ LottieLayer::~LottieLayer()
 
     delete(transform);
     tvg::free(name);
+
+    if (statical) statical->unref();
 }
 
 
@@ -676,14 +687,14 @@ void LottieLayer::prepare(RGB32* color)
         auto clipper = Shape::gen();
         clipper->appendRect(0.0f, 0.0f, w, h);
         clipper->ref();
-        statical.pooler.push(clipper);
+        statical = clipper;
     //prepare solid fill in advance if it is a layer type.
     } else if (color && type == LottieLayer::Solid) {
         auto solidFill = Shape::gen();
         solidFill->appendRect(0, 0, static_cast<float>(w), static_cast<float>(h));
         solidFill->fill(color->r, color->g, color->b);
         solidFill->ref();
-        statical.pooler.push(solidFill);
+        statical = solidFill;
     }
 
     LottieGroup::prepare(LottieObject::Layer);
@@ -717,9 +728,10 @@ bool LottieLayer::assign(const char* layer, uint32_t ix, const char* var, float
 
 LottieComposition::~LottieComposition()
 {
-    if (!initiated && root) delete(root->scene);
-
     delete(root);
+    tvg::free(sharing.path);
+    tvg::free(sharing.dir);
+    tvg::free(source.data);
     tvg::free(version);
     tvg::free(name);
 
@@ -23,10 +23,13 @@
 #ifndef _TVG_LOTTIE_MODEL_H_
 #define _TVG_LOTTIE_MODEL_H_
 
+#include <atomic>
 #include "tvgCommon.h"
 #include "tvgStr.h"
 #include "tvgCompressor.h"
 #include "tvgRender.h"
+#include "tvgLock.h"
+#include "tvgInlist.h"
 #include "tvgLottieProperty.h"
 #include "tvgLottieRenderPooler.h"
 
@@ -87,9 +90,9 @@ struct LottieEffect
 
     virtual ~LottieEffect() {}
 
-    unsigned long nm;  //encoded by djb2
-    unsigned long mn;  //encoded by djb2
-    int16_t ix;
+    unsigned long nm = 0;  //encoded by djb2
+    unsigned long mn = 0;  //encoded by djb2
+    int16_t ix = 0;
     Type type;
     bool enable = false;
 };
@@ -286,6 +289,7 @@ struct LottieObject
     virtual LottieProperty* property(uint16_t ix) { return nullptr; }
 
     unsigned long id = 0;      //unique id by name generated by djb2 encoding
+    uint32_t idx = 0;          //index of the render data, see LottieRenderData
     Type type;
     bool hidden = false;       //remove?
 };
@@ -429,27 +433,31 @@ struct LottieMarker
 
 struct LottieTextFollowPath
 {
-private:
-    RenderPath path;
-    PathCommand* cmds;
-    uint32_t cmdsCnt;
-    Point* pts;
-    Point* start;
-    float totalLen;
-    float currentLen;
-    Point split(float dLen, float lenSearched, float& angle);
-
-public:
+    //the position along the mask path, it's prepared on every text update
+    struct Cursor
+    {
+        RenderPath path;
+        PathCommand* cmds;
+        uint32_t cmdsCnt;
+        Point* pts;
+        Point* start;
+        float totalLen;
+        float currentLen;
+
+        Point position(float lenSearched, float& angle);
+
+    private:
+        Point split(float dLen, float lenSearched, float& angle);
+    };
+
     LottieFloat firstMargin = 0.0f;
-    LottieMask* mask;
     int8_t maskIdx = -1;
 
-    Point position(float lenSearched, float& angle);
-    float prepare(LottieMask* mask, float frameNo, float scale, Tween& tween, LottieExpressions* exps);
+    float prepare(Cursor& cursor, LottieMask* mask, float frameNo, float scale, Tween& tween, LottieExpressions* exps);
 };
 
 
-struct LottieText : LottieObject, LottieRenderPooler<tvg::Shape>
+struct LottieText : LottieObject
 {
     struct AlignOption
     {
@@ -520,7 +528,7 @@ struct LottieTrimpath : LottieObject
 };
 
 
-struct LottieShape : LottieObject, LottieRenderPooler<tvg::Shape>
+struct LottieShape : LottieObject
 {
     bool clockwise = true;   //clockwise or counter-clockwise
 
@@ -866,18 +874,26 @@ struct LottieGradientStroke : LottieGradient, LottieStroke
 };
 
 
-struct LottieImage : LottieObject, LottieRenderPooler<tvg::Picture>
+struct LottieImage : LottieObject
 {
     LottieBitmap data;
+    tvg::Picture* picture = nullptr;  //the origin of the copies in the scenes
+    atomic<bool> loaded{false};        //the picture is ready to be copied
+
+    ~LottieImage()
+    {
+        if (picture) picture->unref();
+    }
 
     void override(LottieProperty* prop, bool shallow, bool release = false) override
     {
         if (release) data.release();
         data.copy(*static_cast<LottieBitmap*>(prop), shallow);
-        update();
+        if (loaded) update();
     }
 
     void prepare();
+    void load();
     void update();
 };
 
@@ -929,7 +945,7 @@ struct LottieOffsetPath : LottieObject
 };
 
 
-struct LottieGroup : LottieObject, LottieRenderPooler<tvg::Shape>
+struct LottieGroup : LottieObject
 {
     LottieGroup();
 
@@ -956,7 +972,6 @@ struct LottieGroup : LottieObject, LottieRenderPooler<tvg::Shape>
         return nullptr;
     }
 
-    Scene* scene = nullptr;
     Array<LottieObject*> children;
     BlendMethod blendMethod = BlendMethod::Normal;
 
@@ -989,7 +1004,7 @@ struct LottieLayer : LottieGroup
     Array<LottieEffect*> effects;
     LottieLayer* matteTarget = nullptr;
 
-    LottieRenderPooler<tvg::Shape> statical;  //static pooler for solid fill and clipper
+    tvg::Shape* statical = nullptr;   //the origin of the solid fill or the clipper copies
 
     float timeStretch = 1.0f;
     float w = 0.0f, h = 0.0f;
@@ -1001,16 +1016,17 @@ struct LottieLayer : LottieGroup
     int16_t pix = -1;           //index of the parent layer.
     int16_t ix = -1;            //index of the current layer.
 
+    //unparsed layers range of the precomp asset in the source, see LottieParser::parseLayers()
     struct {
-        float frameNo = -1.0f;
-        Matrix matrix;
-        uint8_t opacity;
-    } cache;
+        const char* begin = nullptr;
+        const char* end = nullptr;
+    } deferred;
 
     MaskMethod matteType = MaskMethod::None;
     Type type = Null;
     bool autoOrient = false;
     bool matteSrc = false;
+    atomic<bool> unresolved{false};   //referring to a deferred precomp asset, see _buildReference()
 
     LottieEffect* effectById(unsigned long id)
     {
@@ -1088,11 +1104,14 @@ struct LottieSlot
 
 struct LottieComposition
 {
+    INLIST_ITEM(LottieComposition);
+
     ~LottieComposition();
 
-    void clear()
+    //slots and expressions allow an instance to modify the model.
+    bool shareable() const
     {
-        if (root && root->scene) root->scene->remove();
+        return slots.count == 0 && !expressions;
     }
 
     float duration() const
@@ -1143,8 +1162,99 @@ struct LottieComposition
     Array<LottieFont*> fonts;
     Array<LottieSlot*> slots;
     Array<LottieMarker*> markers;
+    uint32_t objects = 0;          //the number of the objects having the render data
     bool expressions = false;
-    bool initiated = false;
+
+    //source data of the deferred precomp assets, see LottieLoader
+    struct {
+        char* data = nullptr;
+        uint32_t size = 0;
+        uint32_t deferred = 0;     //the number of the assets to be parsed
+    } source;
+
+    //sharing among the loaders of the identical source, see LottieLoader
+    struct {
+        Key key;                     //guards the model updates on demand (deferred assets, images)
+        uint32_t size = 0;           //source data size
+        uint8_t digest[32];          //sha-256 of the source data
+        char* dir = nullptr;         //resource directory of the source data
+        char* path = nullptr;        //source file path
+        uint16_t cnt = 0;            //reference count
+    } sharing;
+};
+
+
+/* The render data of the composition objects for an instance. The composition is shared among
+   the loaders of the identical source, each of them renders its own scene tree with this. */
+struct LottieRenderData
+{
+    //a shape, a text, a group or a layer
+    struct Object
+    {
+        LottieRenderPooler<tvg::Shape> pooler;
+        Scene* scene = nullptr;    //groups and layers, valid during a frame update
+    };
+
+    //a layer in addition
+    struct Layer
+    {
+        LottieRenderPooler<tvg::Shape> statical;     //the copies of the solid fill or the clipper
+        LottieRenderPooler<tvg::Picture> pictures;   //the copies of the image
+        struct {
+            float frameNo = -1.0f;
+            Matrix matrix;
+            uint8_t opacity;
+        } cache;
+    };
+
+    Array<Object*> objects;    //indexed by LottieObject::idx
+    Array<Layer*> layers;      //the same, only for the layers
+
+    ~LottieRenderData()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        ARRAY_FOREACH(p, objects) delete(*p);
+        ARRAY_FOREACH(p, layers) delete(*p);
+        objects.reset();
+        layers.reset();
+    }
+
+    //the slots must be ready before the workers access them concurrently
+    void reserve(uint32_t cnt)
+    {
+        if (cnt <= objects.count) return;
+        expand(objects, cnt);
+        expand(layers, cnt);
+    }
+
+    Object* object(LottieObject* obj)
+    {
+        if (obj->idx >= objects.count) reserve(obj->idx * 2 + 1);
+        auto& p = objects[obj->idx];
+        if (!p) p = new Object;
+        return p;
+    }
+
+    Layer* layer(LottieLayer* layer)
+    {
+        if (layer->idx >= layers.count) reserve(layer->idx * 2 + 1);
+        auto& p = layers[layer->idx];
+        if (!p) p = new Layer;
+        return p;
+    }
+
+private:
+    template<typename T>
+    void expand(Array<T*>& arr, uint32_t cnt)
+    {
+        arr.reserve(cnt);
+        memset(arr.data + arr.count, 0x00, sizeof(T*) * (cnt - arr.count));
+        arr.count = cnt;
+    }
 };
 
 #endif //_TVG_LOTTIE_MODEL_H_
@@ -372,19 +372,20 @@ LottieInterpolator* LottieParser::getInterpolator(const char* key, Point& in, Po
         key = buf;
     }
 
-    LottieInterpolator* interpolator = nullptr;
-
-    //get a cached interpolator if it has any.
+    //get a cached interpolator if it has any. the identical tangents are shared regardless of the key.
     ARRAY_FOREACH(p, comp->interpolators) {
-        if (!strncmp((*p)->key, key, sizeof(buf))) interpolator = *p;
+        auto interpolator = *p;
+        if (!strncmp(interpolator->key, key, sizeof(buf))) return interpolator;
+        if (interpolator->inTangent == in && interpolator->outTangent == out) return interpolator;
     }
 
     //new interpolator
-    if (!interpolator) {
-        interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
-        interpolator->set(key, in, out);
-        comp->interpolators.push(interpolator);
-    }
+    auto interpolator = tvg::malloc<LottieInterpolator*>(sizeof(LottieInterpolator));
+    interpolator->set(key, in, out);
+#ifdef THORVG_LOTTIE_EASING_TABLE_SUPPORT
+    interpolator->bake();
+#endif
+    comp->interpolators.push(interpolator);
 
     return interpolator;
 }
@@ -894,10 +895,12 @@ void LottieParser::parseImage(LottieImage* image, const char* data, const char*
         auto mimeType = data + 11;
         auto needle = strstr(mimeType, ";");
         image->data.mimeType = duplicate(mimeType, needle - mimeType);
-        //b64 data
+        //b64 data, keep it encoded until the image is actually demanded
         auto b64Data = strstr(data, ",") + 1;
         size_t length = strlen(data) - (b64Data - data);
-        image->data.size = b64Decode(b64Data, length, &image->data.b64Data);
+        image->data.b64Data = duplicate(b64Data, length);
+        image->data.size = length;
+        image->data.encoded = true;
     //external image resource
     } else {
         auto len = strlen(dirName) + strlen(subPath) + strlen(data) + 2;
@@ -935,7 +938,7 @@ LottieObject* LottieParser::parseAsset()
                 id = _int2str(getInt());
             }
         }
-        else if (KEY_AS("layers")) obj = parseLayers(comp->root);
+        else if (KEY_AS("layers")) obj = parseLayers(comp->root, lazy);
         else if (KEY_AS("u")) subPath = getString();
         else if (KEY_AS("p")) data = getString();
         else if (KEY_AS("w")) width = getFloat();
@@ -1489,19 +1492,32 @@ LottieLayer* LottieParser::parseLayer(LottieLayer* precomp)
 }
 
 
-LottieLayer* LottieParser::parseLayers(LottieLayer* root)
+void LottieParser::parseChildren(LottieLayer* precomp)
+{
+    enterArray();
+    while (nextArrayValue()) {
+        precomp->children.push(parseLayer(precomp));
+    }
+
+    precomp->prepare();
+}
+
+
+LottieLayer* LottieParser::parseLayers(LottieLayer* root, bool deferrable)
 {
     auto precomp = new LottieLayer;
 
+    precomp->LottieObject::type = LottieObject::Layer;   //typed in advance, the deferred one is prepared later
     precomp->type = LottieLayer::Precomp;
     precomp->comp = root;
 
-    enterArray();
-    while (nextArrayValue()) {
-        precomp->children.push(parseLayer(precomp));
+    //skip it until it's required, see parse(LottieLayer*)
+    if (deferrable && defer(precomp->deferred.begin, precomp->deferred.end, expressions)) {
+        ++deferred;
+        return precomp;
     }
 
-    precomp->prepare();
+    parseChildren(precomp);
     return precomp;
 }
 
@@ -1694,3 +1710,19 @@ bool LottieParser::parse()
 
     return true;
 }
+
+
+//parse the deferred layers of the precomp asset
+bool LottieParser::parse(LottieLayer* precomp)
+{
+    if (!precomp->deferred.begin) return false;
+
+    resume(precomp->deferred.begin, precomp->deferred.end);
+    precomp->deferred.begin = precomp->deferred.end = nullptr;
+
+    if (!parseNext()) return false;
+
+    parseChildren(precomp);
+
+    return !Invalid();
+}
@@ -37,6 +37,7 @@ public:
     }
 
     bool parse();
+    bool parse(LottieLayer* precomp);
     bool apply(LottieSlot* slot, bool byDefault);
     const char* sid(bool first = false);
     void captureSlots(const char* key);
@@ -46,6 +47,8 @@ public:
     const char* dirName = nullptr;       //base resource directory
     char* slots = nullptr;
     bool expressions = false;            //support expressions?
+    bool lazy = false;                   //defer the parsing of the precomp assets?
+    uint32_t deferred = 0;               //the number of the deferred precomp assets
 
 private:
     RGB32 getColor(const char *str);
@@ -90,7 +93,8 @@ private:
     LottiePolyStar* parsePolyStar();
     LottieRoundedCorner* parseRoundedCorner();
     LottieGradientFill* parseGradientFill();
-    LottieLayer* parseLayers(LottieLayer* root);
+    LottieLayer* parseLayers(LottieLayer* root, bool deferrable = false);
+    void parseChildren(LottieLayer* precomp);
     LottieMask* parseMask();
     LottieTrimpath* parseTrimpath();
     LottieRepeater* parseRepeater();
@@ -46,6 +46,44 @@
 #include "tvgLottieParserHandler.h"
 
 
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+static const char* _skipWhitespace(const char* p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') ++p;
+    return p;
+}
+
+
+//find the end of the array without tokenizing, nullptr if it has any slots or expressions.
+static const char* _scan(const char* p, bool expressions)
+{
+    auto depth = 1;
+    while (*p) {
+        if (*p == '"') {
+            auto str = ++p;
+            while (*p != '"') {
+                if (*p == '\0') return nullptr;
+                if (*p == '\\' && p[1]) ++p;
+                ++p;
+            }
+            auto len = p - str;
+            auto next = _skipWhitespace(++p);
+            if (*next != ':') continue;
+            if (len == 3 && !strncmp(str, "sid", 3)) return nullptr;
+            if (expressions && len == 1 && *str == 'x' && *_skipWhitespace(next + 1) == '"') return nullptr;
+            continue;
+        }
+        if (*p == '[' || *p == '{') ++depth;
+        else if ((*p == ']' || *p == '}') && --depth == 0) return p;
+        ++p;
+    }
+    return nullptr;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -226,4 +264,36 @@ void LookaheadParserHandler::skip()
 char* LookaheadParserHandler::getPos()
 {
     return iss.src_;
-}
\ No newline at end of file
+}
+
+
+/* Skip the entered array with a raw scan, it can be parsed later on by resume().
+   The slots and expressions must be known in advance, so it doesn't if any. */
+bool LookaheadParserHandler::defer(const char*& begin, const char*& end, bool expressions)
+{
+    if (state != kEnteringArray) return false;
+
+    auto p = _scan(iss.src_, expressions);
+    if (!p) return false;
+    begin = iss.src_ - 1;
+    end = p + 1;
+    iss.src_ = const_cast<char*>(p);
+
+    //exit the array
+    parseNext();
+    parseNext();
+
+    return true;
+}
+
+
+//parse the range given by defer(), the rest of the data must have been consumed.
+void LookaheadParserHandler::resume(const char* begin, const char* end)
+{
+    state = kInit;
+
+    //terminate the array
+    *const_cast<char*>(end) = '\0';
+    iss = InsituStringStream(const_cast<char*>(begin));
+    reader.IterativeParseInit();
+}
@@ -198,6 +198,8 @@ struct LookaheadParserHandler
     void skipOut(int depth);
     int peekType();
     char* getPos();
+    bool defer(const char*& begin, const char*& end, bool expressions);
+    void resume(const char* begin, const char* end);
 };
 
 #endif //_TVG_LOTTIE_PARSER_HANDLER_H_
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include "tvgMath.h"
 #include "tvgStr.h"
+#include "tvgCompressor.h"
 #include "tvgLottieData.h"
 #include "tvgLottieInterpolator.h"
 #include "tvgLottieExpressions.h"
@@ -190,7 +191,7 @@ struct LottieProperty
 
     LottieExpression* exp = nullptr;
     Type type;
-    uint8_t ix;  //property index
+    uint8_t ix = 0;  //property index
 
     LottieProperty(Type type = Type::Invalid) : type(type) {}
     virtual ~LottieProperty() {}
@@ -325,7 +326,7 @@ struct LottieGenericProperty : LottieProperty
 
     //Property has an either keyframes or single value.
     Array<Frame>* frames = nullptr;
-    Value value;
+    Value value{};
 
     LottieGenericProperty(Value v) : LottieProperty(PType), value(v) {}
 
@@ -955,6 +956,7 @@ struct LottieBitmap : LottieProperty
     uint32_t size = 0;
     float width = 0.0f;
     float height = 0.0f;
+    bool encoded = false;  //b64Data still holds the base64 text, see decode()
 
     LottieBitmap() : LottieProperty(LottieProperty::Type::Image) {}
 
@@ -975,6 +977,19 @@ struct LottieBitmap : LottieProperty
 
         b64Data = nullptr;
         mimeType = nullptr;
+        encoded = false;
+    }
+
+    //decode the embedded data when it's actually demanded
+    void decode()
+    {
+        if (!encoded) return;
+        char* decoded = nullptr;
+        auto len = b64Decode(b64Data, size, &decoded);
+        tvg::free(b64Data);
+        b64Data = decoded;
+        size = len;
+        encoded = false;
     }
 
     uint32_t frameCnt() override { return 0; }
@@ -993,12 +1008,17 @@ struct LottieBitmap : LottieProperty
         } else {
             //TODO: optimize here by avoiding data copy
             TVGLOG("LOTTIE", "Shallow copy of the image data!");
-            b64Data = duplicate(rhs.b64Data);
+            if (rhs.size > 0) {
+                b64Data = tvg::malloc<char*>(rhs.size + 1);
+                memcpy(b64Data, rhs.b64Data, rhs.size);
+                b64Data[rhs.size] = '\0';
+            } else b64Data = duplicate(rhs.b64Data);
             if (rhs.mimeType) mimeType = duplicate(rhs.mimeType);
         }
         size = rhs.size;
         width = rhs.width;
         height = rhs.height;
+        encoded = rhs.encoded;
     }
 };
 
@@ -40,7 +40,8 @@ struct LottieRenderPooler
         }
     }
 
-    T* pooling(bool copy = false)
+    //origin: generate a copy of it if no one is available
+    T* pooling(T* origin = nullptr)
     {
         //return available one.
         ARRAY_FOREACH(p, pooler) {
@@ -48,7 +49,7 @@ struct LottieRenderPooler
         }
 
         //no empty, generate a new one.
-        auto p = copy ? static_cast<T*>(pooler[0]->duplicate()) : T::gen();
+        auto p = origin ? static_cast<T*>(origin->duplicate()) : T::gen();
         p->ref();
         pooler.push(p);
         return p;
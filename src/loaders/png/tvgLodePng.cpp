@@ -47,6 +47,14 @@
 #include "tvgCommon.h"
 #include "tvgLodePng.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+    #include <immintrin.h>
+    #define LODEPNG_VECTOR_SUPPORT
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define LODEPNG_VECTOR_SUPPORT
+#endif
+
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -2074,6 +2082,203 @@ static void Adam7_getpassvalues(unsigned passw[7], unsigned passh[7], size_t fil
 /* / PNG Decoder                                                            / */
 /* ////////////////////////////////////////////////////////////////////////// */
 
+#ifdef LODEPNG_VECTOR_SUPPORT
+
+/* The Sub, Average and Paeth filters depend on the previous pixel of the same scanline, so they reconstruct
+   one pixel at a time with all its channels in one vector. Only for the 3 and 4 bytes per pixel images. */
+
+/* single moves for the 3 and 4 bytes pixels, the branch is the same for the whole scanline */
+static LODEPNG_INLINE uint32_t readPixel(const unsigned char* p, size_t bytewidth)
+{
+    uint32_t v;
+    if (bytewidth == 4) memcpy(&v, p, 4);
+    else v = p[0] | (p[1] << 8) | (p[2] << 16);
+    return v;
+}
+
+
+static LODEPNG_INLINE void writePixel(unsigned char* p, uint32_t v, size_t bytewidth)
+{
+    if (bytewidth == 4) memcpy(p, &v, 4);
+    else {
+        p[0] = (unsigned char)v;
+        p[1] = (unsigned char)(v >> 8);
+        p[2] = (unsigned char)(v >> 16);
+    }
+}
+
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+
+static LODEPNG_INLINE __m128i loadPixel(const unsigned char* p, size_t bytewidth)
+{
+    return _mm_cvtsi32_si128(readPixel(p, bytewidth));
+}
+
+
+static LODEPNG_INLINE void storePixel(unsigned char* p, __m128i v, size_t bytewidth)
+{
+    writePixel(p, _mm_cvtsi128_si32(v), bytewidth);
+}
+
+
+static void unfilterUp(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t length)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(scanline + i));
+        __m128i p = _mm_loadu_si128((const __m128i*)(precon + i));
+        _mm_storeu_si128((__m128i*)(recon + i), _mm_add_epi8(s, p));
+    }
+    for (; i != length; ++i) recon[i] = scanline[i] + precon[i];
+}
+
+
+static LODEPNG_INLINE void unfilterSub(unsigned char* recon, const unsigned char* scanline, size_t bytewidth, size_t length)
+{
+    size_t i;
+    __m128i a = _mm_setzero_si128();
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        a = _mm_add_epi8(loadPixel(scanline + i, bytewidth), a);
+        storePixel(recon + i, a, bytewidth);
+    }
+}
+
+
+static LODEPNG_INLINE void unfilterAverage(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, size_t length)
+{
+    size_t i;
+    __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        __m128i b = loadPixel(precon + i, bytewidth);
+        /* avg_epu8 rounds up, the filter rounds down */
+        __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(loadPixel(scanline + i, bytewidth), avg);
+        storePixel(recon + i, a, bytewidth);
+    }
+}
+
+
+static LODEPNG_INLINE void unfilterPaeth(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, size_t length)
+{
+    size_t i;
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = zero, c = zero; /* left and upper left pixels, widened to 16 bits */
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        __m128i b = _mm_unpacklo_epi8(loadPixel(precon + i, bytewidth), zero);
+        __m128i pa = _mm_sub_epi16(b, c);
+        __m128i pb = _mm_sub_epi16(a, c);
+        __m128i pc = _mm_abs_epi16(_mm_add_epi16(pa, pb));
+        pa = _mm_abs_epi16(pa);
+        pb = _mm_abs_epi16(pb);
+        /* the same priority as paethPredictor() if equal: a, b, then c */
+        __m128i smallest = _mm_min_epi16(_mm_min_epi16(pa, pb), pc);
+        __m128i pred = _mm_blendv_epi8(c, b, _mm_cmpeq_epi16(smallest, pb));
+        pred = _mm_blendv_epi8(pred, a, _mm_cmpeq_epi16(smallest, pa));
+        __m128i x = _mm_add_epi8(loadPixel(scanline + i, bytewidth), _mm_packus_epi16(pred, pred));
+        storePixel(recon + i, x, bytewidth);
+        a = _mm_unpacklo_epi8(x, zero);
+        c = b;
+    }
+}
+
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+
+static LODEPNG_INLINE uint8x8_t loadPixel(const unsigned char* p, size_t bytewidth)
+{
+    return vreinterpret_u8_u32(vdup_n_u32(readPixel(p, bytewidth)));
+}
+
+
+static LODEPNG_INLINE void storePixel(unsigned char* p, uint8x8_t v, size_t bytewidth)
+{
+    writePixel(p, vget_lane_u32(vreinterpret_u32_u8(v), 0), bytewidth);
+}
+
+
+static void unfilterUp(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t length)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8(recon + i, vaddq_u8(vld1q_u8(scanline + i), vld1q_u8(precon + i)));
+    }
+    for (; i != length; ++i) recon[i] = scanline[i] + precon[i];
+}
+
+
+static LODEPNG_INLINE void unfilterSub(unsigned char* recon, const unsigned char* scanline, size_t bytewidth, size_t length)
+{
+    size_t i;
+    uint8x8_t a = vdup_n_u8(0);
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        a = vadd_u8(loadPixel(scanline + i, bytewidth), a);
+        storePixel(recon + i, a, bytewidth);
+    }
+}
+
+
+static LODEPNG_INLINE void unfilterAverage(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, size_t length)
+{
+    size_t i;
+    uint8x8_t a = vdup_n_u8(0);
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        a = vadd_u8(loadPixel(scanline + i, bytewidth), vhadd_u8(a, loadPixel(precon + i, bytewidth)));
+        storePixel(recon + i, a, bytewidth);
+    }
+}
+
+
+static LODEPNG_INLINE void unfilterPaeth(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, size_t length)
+{
+    size_t i;
+    uint8x8_t a = vdup_n_u8(0), c = a; /* left and upper left pixels */
+    for (i = 0; i + bytewidth <= length; i += bytewidth) {
+        uint8x8_t b = loadPixel(precon + i, bytewidth);
+        int16x8_t pa = vreinterpretq_s16_u16(vsubl_u8(b, c));
+        int16x8_t pb = vreinterpretq_s16_u16(vsubl_u8(a, c));
+        uint16x8_t pc = vreinterpretq_u16_s16(vabsq_s16(vaddq_s16(pa, pb)));
+        uint16x8_t ua = vreinterpretq_u16_s16(vabsq_s16(pa));
+        uint16x8_t ub = vreinterpretq_u16_s16(vabsq_s16(pb));
+        /* the same priority as paethPredictor() if equal: a, b, then c */
+        uint16x8_t smallest = vminq_u16(vminq_u16(ua, ub), pc);
+        uint8x8_t pred = vbsl_u8(vmovn_u16(vceqq_u16(smallest, ub)), b, c);
+        pred = vbsl_u8(vmovn_u16(vceqq_u16(smallest, ua)), a, pred);
+        a = vadd_u8(loadPixel(scanline + i, bytewidth), pred);
+        storePixel(recon + i, a, bytewidth);
+        c = b;
+    }
+}
+
+#endif
+
+
+/* returns 1 if the scanline was unfiltered here, 0 to fall back to the generic filters */
+static unsigned unfilterScanlineVector(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, unsigned char filterType, size_t length)
+{
+    if (filterType == 2 && precon) {
+        unfilterUp(recon, scanline, precon, length);
+        return 1;
+    }
+    if (bytewidth != 3 && bytewidth != 4) return 0;
+    if (filterType == 1) {
+        unfilterSub(recon, scanline, bytewidth, length);
+        return 1;
+    }
+    if (!precon) return 0;
+    if (filterType == 3) {
+        unfilterAverage(recon, scanline, precon, bytewidth, length);
+        return 1;
+    }
+    if (filterType == 4) {
+        unfilterPaeth(recon, scanline, precon, bytewidth, length);
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* LODEPNG_VECTOR_SUPPORT */
+
+
 static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scanline, const unsigned char* precon, size_t bytewidth, unsigned char filterType, size_t length)
 {
     /* For PNG filter method 0
@@ -2083,6 +2288,10 @@ static unsigned unfilterScanline(unsigned char* recon, const unsigned char* scan
        the incoming scanlines do NOT include the filtertype byte, that one is given in the parameter filterType instead
        recon and scanline MAY be the same memory address! precon must be disjoint. */
 
+#ifdef LODEPNG_VECTOR_SUPPORT
+    if (unfilterScanlineVector(recon, scanline, precon, bytewidth, filterType, length)) return 0;
+#endif
+
     size_t i;
     switch (filterType) {
         case 0:
@@ -2312,6 +2521,58 @@ static unsigned postProcessScanlines(unsigned char* out, unsigned char* in, unsi
 }
 
 
+/* premultiplies the 8-bit RGBA pixels by their alpha and/or swaps their red and blue channels, as the settings ask */
+static void premultiplyPixels(unsigned char* buffer, size_t numpixels, const LodePNGDecoderSettings* settings)
+{
+    uint32_t* p = (uint32_t*)buffer;
+    uint32_t* end = p + numpixels;
+    for (; p < end; ++p) {
+        uint32_t c = *p;
+        if (settings->bgra) c = (c & 0xff00ff00) + ((c & 0x00ff0000) >> 16) + ((c & 0x000000ff) << 16);
+        if (settings->premultiply) {
+            uint32_t a = c >> 24;
+            if (a < 255) c = (c & 0xff000000) + ((((c >> 8) & 0xff) * a) & 0xff00) + ((((c & 0x00ff00ff) * a) >> 8) & 0x00ff00ff);
+        }
+        *p = c;
+    }
+}
+
+
+/* whether decodeGeneric() outputs the final 8-bit RGBA pixels by postProcessRows() */
+static unsigned decodeRows(const LodePNGState* state)
+{
+    return state->decoder.color_convert && state->info_png.interlace_method == 0 &&
+           state->info_raw.colortype == LCT_RGBA && state->info_raw.bitdepth == 8;
+}
+
+
+/* The non-interlaced alternative of postProcessScanlines() for the 8-bit RGBA output: every scanline is unfiltered
+   in place and then converted (and premultiplied) into its out row while it's still in the cache, so that no
+   intermediate image in the PNG color type is needed. The unfiltered rows are byte aligned, no padding bits to remove.
+   out must be big enough to contain the full RGBA image, in is overwritten
+   return value is error */
+static unsigned postProcessRows(unsigned char* out, unsigned char* in, unsigned w, unsigned h, const LodePNGInfo* info_png, const LodePNGDecoderSettings* settings)
+{
+    unsigned y;
+    unsigned char* prevline = 0;
+    unsigned bpp = lodepng_get_bpp_lct(info_png->color.colortype, info_png->color.bitdepth);
+    if (bpp == 0) return 31; /* error: invalid colortype */
+
+    size_t bytewidth = (bpp + 7u) / 8u;
+    size_t linebytes = lodepng_get_raw_size_idat(w, 1, bpp) - 1u;
+
+    for (y = 0; y < h; ++y) {
+        unsigned char* line = &in[(1 + linebytes) * y + 1];
+        unsigned char* row = &out[(size_t)w * 4u * y];
+        CERROR_TRY_RETURN(unfilterScanline(line, line, prevline, bytewidth, line[-1], linebytes));
+        getPixelColorsRGBA8(row, w, line, &info_png->color);
+        if (settings->premultiply || settings->bgra) premultiplyPixels(row, w, settings);
+        prevline = line;
+    }
+    return 0;
+}
+
+
 static unsigned readChunk_PLTE(LodePNGColorMode* color, const unsigned char* data, size_t chunkLength)
 {
     unsigned pos = 0, i;
@@ -2485,13 +2746,22 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h, LodePNG
     tvg::free(idat);
 
     if (!state->error) {
-        outsize = lodepng_get_raw_size(*w, *h, &state->info_png.color);
+        outsize = lodepng_get_raw_size(*w, *h, decodeRows(state) ? &state->info_raw : &state->info_png.color);
         *out = tvg::malloc<unsigned char*>(outsize);
         if (!*out) state->error = 83; /*alloc fail*/
     }
     if (!state->error) {
-        lodepng_memset(*out, 0, outsize);
-        state->error = postProcessScanlines(*out, scanlines, *w, *h, &state->info_png);
+        if (decodeRows(state)) {
+            state->error = postProcessRows(*out, scanlines, *w, *h, &state->info_png, &state->decoder);
+        } else {
+            lodepng_memset(*out, 0, outsize);
+            state->error = postProcessScanlines(*out, scanlines, *w, *h, &state->info_png);
+        }
+    }
+    /*no partial image*/
+    if (state->error) {
+        tvg::free(*out);
+        *out = 0;
     }
     tvg::free(scanlines);
 }
@@ -2500,6 +2770,8 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h, LodePNG
 static void lodepng_decoder_settings_init(LodePNGDecoderSettings* settings)
 {
     settings->color_convert = 1;
+    settings->premultiply = 0;
+    settings->bgra = 0;
     settings->ignore_crc = 0;
     settings->ignore_critical = 0;
     settings->ignore_end = 0;
@@ -2582,6 +2854,8 @@ unsigned lodepng_decode(unsigned char** out, unsigned* w, unsigned* h, LodePNGSt
     *out = 0;
     decodeGeneric(out, w, h, state, in, insize);
     if (state->error) return state->error;
+    /*already converted row by row*/
+    if (decodeRows(state)) return state->error;
     if (!state->decoder.color_convert || lodepng_color_mode_equal(&state->info_raw, &state->info_png.color)) {
         /*same color type, no copying or converting of data needed*/
         /*store the info_png color settings on the info_raw so that the info_raw still reflects what colortype
@@ -2608,6 +2882,9 @@ unsigned lodepng_decode(unsigned char** out, unsigned* w, unsigned* h, LodePNGSt
         else state->error = lodepng_convert(*out, data, &state->info_raw, &state->info_png.color, *w, *h);
         tvg::free(data);
     }
+    if (!state->error && (state->decoder.premultiply || state->decoder.bgra) && state->info_raw.colortype == LCT_RGBA && state->info_raw.bitdepth == 8) {
+        premultiplyPixels(*out, (size_t)(*w) * (*h), &state->decoder);
+    }
     return state->error;
 }
 
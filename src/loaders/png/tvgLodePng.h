@@ -155,6 +155,10 @@ struct LodePNGDecoderSettings
        in string keys, etc... */
 
     unsigned color_convert; /*whether to convert the PNG to the color type you want. Default: yes*/
+
+    /*only for the 8-bit RGBA output*/
+    unsigned premultiply; /*premultiply the color channels by the alpha. Default: no*/
+    unsigned bgra; /*swap the red and blue channels. Default: no*/
 };
 
 /*The settings, state and information for extended encoding and decoding.*/
@@ -29,22 +29,85 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-void PngLoader::run(unsigned tid)
+//Reduce the RGBA image to 1/2^shift by the box filter row by row in place, the result is premultiplied in RGBA or BGRA.
+static void _reduce(uint8_t* data, uint32_t w, uint32_t h, uint8_t shift, bool bgra)
+{
+    auto step = 1U << shift;
+    auto dw = (w + step - 1) >> shift;
+    auto dh = (h + step - 1) >> shift;
+    auto dst = data;
+
+    //the output never overtakes the source rows being read.
+    for (uint32_t y = 0; y < dh; ++y) {
+        auto rows = std::min(step, h - (y << shift));
+        for (uint32_t x = 0; x < dw; ++x, dst += 4) {
+            auto cols = std::min(step, w - (x << shift));
+            uint32_t r = 0, g = 0, b = 0, a = 0;
+            for (uint32_t i = 0; i < rows; ++i) {
+                auto src = data + (((y << shift) + i) * w + (x << shift)) * 4;
+                for (uint32_t j = 0; j < cols; ++j, src += 4) {
+                    r += src[0] * src[3];
+                    g += src[1] * src[3];
+                    b += src[2] * src[3];
+                    a += src[3];
+                }
+            }
+            auto cnt = rows * cols;
+            if (bgra) std::swap(r, b);
+            dst[0] = static_cast<uint8_t>((r + cnt * 127) / (cnt * 255));
+            dst[1] = static_cast<uint8_t>((g + cnt * 127) / (cnt * 255));
+            dst[2] = static_cast<uint8_t>((b + cnt * 127) / (cnt * 255));
+            dst[3] = static_cast<uint8_t>((a + cnt / 2) / cnt);
+        }
+    }
+}
+
+
+void PngLoader::run(TVG_UNUSED unsigned tid)
 {
     auto width = static_cast<unsigned>(w);
     auto height = static_cast<unsigned>(h);
 
+    auto bgra = (target == ColorSpace::ARGB8888 || target == ColorSpace::ARGB8888S);
+
     state.info_raw.colortype = LCT_RGBA;   //request this image format
 
+    //align to the requested colorspace while decoding, the reduction premultiplies by itself
+    if (shrink == 0 && target != ColorSpace::Unknown) {
+        state.decoder.premultiply = 1;
+        state.decoder.bgra = bgra;
+    }
+
     if (lodepng_decode(&surface.buf8, &width, &height, &state, data, size)) {
         TVGERR("PNG", "Failed to decode image");
     }
 
+    //the source isn't necessary anymore
+    if (freeData) tvg::free(data);
+    data = nullptr;
+    freeData = false;
+
+    surface.cs = ColorSpace::ABGR8888S;
+
+    if (surface.buf8) {
+        //reduce the decoded rows to the hinted size
+        if (shrink > 0) {
+            _reduce(surface.buf8, width, height, shrink, bgra);
+            auto mask = (1U << shrink) - 1;
+            width = (width + mask) >> shrink;
+            height = (height + mask) >> shrink;
+            surface.buf8 = tvg::realloc<uint8_t*>(surface.buf8, width * height * sizeof(uint32_t));
+            surface.premultiplied = true;
+        } else if (state.decoder.premultiply) {
+            surface.premultiplied = true;
+        }
+        if (surface.premultiplied) surface.cs = bgra ? ColorSpace::ARGB8888 : ColorSpace::ABGR8888;
+    }
+
     //setup the surface
     surface.stride = width;
     surface.w = width;
     surface.h = height;
-    surface.cs = ColorSpace::ABGR8888S;
     surface.channelSize = sizeof(uint32_t);
 }
 
@@ -132,20 +195,36 @@ bool PngLoader::open(const char* data, uint32_t size, TVG_UNUSED const char* rpa
 }
 
 
-bool PngLoader::read()
+uint8_t PngLoader::reduction(float w, float h) const
 {
-    if (!data || w == 0 || h == 0) return false;
+    return cover(w, h, 3);
+}
 
+
+bool PngLoader::read()
+{
     if (!LoadModule::read()) return true;
 
-    TaskScheduler::request(this);
+    if (!data || w == 0 || h == 0) return false;
+
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
     return true;
 }
 
 
-RenderSurface* PngLoader::bitmap()
+bool PngLoader::close()
 {
+    if (!LoadModule::close()) return false;
     this->done();
-    return ImageLoader::bitmap();
+    return true;
+}
+
+
+RenderSurface* PngLoader::bitmap(ColorSpace cs)
+{
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
 }
\ No newline at end of file
@@ -24,7 +24,6 @@
 #define _TVG_PNG_LOADER_H_
 
 #include "tvgLodePng.h"
-#include "tvgTaskScheduler.h"
 
 
 class PngLoader : public ImageLoader, public Task
@@ -43,9 +42,11 @@ public:
 
     bool open(const char* path) override;
     bool open(const char* data, uint32_t size, const char* rpath, bool copy) override;
+    uint8_t reduction(float w, float h) const override;
     bool read() override;
+    bool close() override;
 
-    RenderSurface* bitmap() override;
+    RenderSurface* bitmap(ColorSpace cs) override;
 };
 
 #endif //_TVG_PNG_LOADER_H_
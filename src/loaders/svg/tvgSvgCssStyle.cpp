@@ -21,12 +21,100 @@
  */
 
 #include "tvgStr.h"
+#include "tvgCompressor.h"
 #include "tvgSvgCssStyle.h"
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+//open addressing table of the style sheet rules keyed by their selectors (type + name)
+struct SvgCssIndex
+{
+    struct Slot
+    {
+        SvgNode* rule;
+        unsigned long hash;
+    };
+
+    Slot* slots = nullptr;
+    uint32_t size = 0;      //power of 2
+    uint32_t count = 0;     //occupied slots
+    uint32_t indexed = 0;   //the number of the style sheet rules registered in the table
+
+    ~SvgCssIndex()
+    {
+        tvg::free(slots);
+    }
+};
+
+
+static unsigned long _hash(const char* title, SvgNodeType type)
+{
+    return (djb2Encode(title) << 5) ^ static_cast<unsigned long>(type);
+}
+
+
+static bool _matched(const SvgNode* rule, const char* title, SvgNodeType type)
+{
+    if (rule->type != type) return false;
+    if (!title) return !rule->id;
+    return rule->id && !strcmp(rule->id, title);
+}
+
+
+static SvgCssIndex::Slot* _probe(SvgCssIndex* index, const char* title, SvgNodeType type, unsigned long hash)
+{
+    auto mask = index->size - 1;
+    auto i = static_cast<uint32_t>(hash) & mask;
+    while (true) {
+        auto slot = index->slots + i;
+        if (!slot->rule || (slot->hash == hash && _matched(slot->rule, title, type))) return slot;
+        i = (i + 1) & mask;
+    }
+}
+
+
+static void _insert(SvgCssIndex* index, SvgNode* rule)
+{
+    //keep the load factor under 1/2
+    if ((index->count + 1) * 2 > index->size) {
+        auto old = index->slots;
+        auto oldSize = index->size;
+        index->size = oldSize > 0 ? oldSize * 2 : 16;
+        index->slots = tvg::calloc<SvgCssIndex::Slot*>(index->size, sizeof(SvgCssIndex::Slot));
+        for (uint32_t i = 0; i < oldSize; ++i) {
+            if (!old[i].rule) continue;
+            *_probe(index, old[i].rule->id, old[i].rule->type, old[i].hash) = old[i];
+        }
+        tvg::free(old);
+    }
+    auto hash = _hash(rule->id, rule->type);
+    auto slot = _probe(index, rule->id, rule->type, hash);
+    //the first declared rule wins, just like the sequential lookup did
+    if (slot->rule) return;
+    slot->rule = rule;
+    slot->hash = hash;
+    ++index->count;
+}
+
+
+static SvgNode* _lookup(SvgNode* style, const char* title, SvgNodeType type)
+{
+    auto& index = style->node.cssStyle.index;
+    if (!index) index = new SvgCssIndex;
+
+    //the rules are appended while the style sheet is parsed. register the new comers
+    for (auto i = index->indexed; i < style->child.count; ++i) {
+        _insert(index, style->child[i]);
+    }
+    index->indexed = style->child.count;
+
+    if (index->count == 0) return nullptr;
+    return _probe(index, title, type, _hash(title, type))->rule;
+}
+
+
 static bool _isImportanceApplicable(SvgStyleFlags &toFlagsImportance, SvgStyleFlags fromFlagsImportance, SvgStyleFlags flag)
 {
     if (!(toFlagsImportance & flag) && (fromFlagsImportance & flag)) {
@@ -206,29 +294,24 @@ void cssCopyStyleAttr(SvgNode* to, const SvgNode* from)
 }
 
 
-SvgNode* cssFindStyleNode(const SvgNode* style, const char* title, SvgNodeType type)
+SvgNode* cssFindStyleNode(SvgNode* style, const char* title, SvgNodeType type)
 {
     if (!style) return nullptr;
-
-    ARRAY_FOREACH(p, style->child) {
-        if ((*p)->type == type) {
-            if ((!title && !(*p)->id) || (title && (*p)->id && !strcmp((*p)->id, title))) return *p;
-        }
-    }
-    return nullptr;
+    return _lookup(style, title, type);
 }
 
 
-SvgNode* cssFindStyleNode(const SvgNode* style, const char* title)
+SvgNode* cssFindStyleNode(SvgNode* style, const char* title)
 {
     if (!style || !title) return nullptr;
+    return _lookup(style, title, SvgNodeType::CssStyle);
+}
 
-    ARRAY_FOREACH(p, style->child) {
-        if ((*p)->type == SvgNodeType::CssStyle) {
-            if ((*p)->id && !strcmp((*p)->id, title)) return *p;
-        }
-    }
-    return nullptr;
+
+void cssFreeIndex(SvgNode* style)
+{
+    delete(style->node.cssStyle.index);
+    style->node.cssStyle.index = nullptr;
 }
 
 
@@ -26,8 +26,9 @@
 #include "tvgSvgLoaderCommon.h"
 
 void cssCopyStyleAttr(SvgNode* to, const SvgNode* from);
-SvgNode* cssFindStyleNode(const SvgNode* style, const char* title, SvgNodeType type);
-SvgNode* cssFindStyleNode(const SvgNode* style, const char* title);
+SvgNode* cssFindStyleNode(SvgNode* style, const char* title, SvgNodeType type);
+SvgNode* cssFindStyleNode(SvgNode* style, const char* title);
+void cssFreeIndex(SvgNode* style);
 void cssUpdateStyle(SvgNode* doc, SvgNode* style);
 void cssApplyStyleToPostponeds(Array<SvgNodeIdPair>& postponeds, SvgNode* style);
 
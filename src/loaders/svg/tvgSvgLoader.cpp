@@ -3220,9 +3220,11 @@ static void _copyAttr(SvgNode* to, const SvgNode* from)
             break;
         }
         case SvgNodeType::Path: {
+            //Share the path data with the origin node instead of copying it.
             if (from->node.path.path) {
                 tvg::free(to->node.path.path);
-                to->node.path.path = duplicate(from->node.path.path);
+                to->node.path.path = from->node.path.path;
+                to->node.path.origin = from->node.path.origin ? from->node.path.origin : const_cast<SvgNode*>(from);
             }
             break;
         }
@@ -3700,7 +3702,11 @@ static void _freeNode(SvgNode* node)
     _freeNodeStyle(node->style);
     switch (node->type) {
          case SvgNodeType::Path: {
-             tvg::free(node->node.path.path);
+             //the instances borrow the path data from the origin node
+             if (!node->node.path.origin) {
+                 tvg::free(node->node.path.path);
+                 delete(node->node.path.cache);
+             }
              break;
          }
          case SvgNodeType::Polygon: {
@@ -3733,6 +3739,10 @@ static void _freeNode(SvgNode* node)
              tvg::free(node->node.text.fontFamily);
              break;
          }
+         case SvgNodeType::CssStyle: {
+             cssFreeIndex(node);
+             break;
+         }
          default: {
              break;
          }
@@ -3812,6 +3822,12 @@ void SvgLoader::clear(bool all)
 
     if (!all) return;
 
+    ARRAY_FOREACH(p, loaderData.tasks) {
+        (*p)->done();
+        delete(*p);
+    }
+    loaderData.tasks.reset();
+
     ARRAY_FOREACH(p, loaderData.images) tvg::free(*p);
     loaderData.images.reset();
 
@@ -27,6 +27,8 @@
 #include "tvgArray.h"
 #include "tvgInlist.h"
 #include "tvgColor.h"
+#include "tvgRender.h"
+#include "tvgTaskScheduler.h"
 
 using SvgColor = tvg::RGB;
 
@@ -357,6 +359,8 @@ struct SvgImageNode
 struct SvgPathNode
 {
     char* path;
+    SvgNode* origin;     //the referenced path node if this is a <use> instance. the path data is shared with it.
+    RenderPath* cache;   //the converted path data of the origin, shared among its instances
 };
 
 struct SvgPolygonNode
@@ -375,8 +379,11 @@ struct SvgMaskNode
     bool userSpace;
 };
 
+struct SvgCssIndex;
+
 struct SvgCssStyleNode
 {
+    SvgCssIndex* index;   //selector lookup table of the style sheet
 };
 
 struct SvgTextNode
@@ -597,8 +604,10 @@ struct SvgLoaderData
     Array<SvgNodeIdPair> nodesToStyle;
     Array<char*> images;        //embedded images
     Array<FontFace> fonts;
+    Array<Task*> tasks;         //scene building tasks, released along with the loader
     int level = 0;
     bool result = false;
+    bool parallel = false;      //allow building the independent subtrees on the workers
     OpenedTagType openedTag = OpenedTagType::Other;
     SvgNode* currentGraphicsNode = nullptr;
 };
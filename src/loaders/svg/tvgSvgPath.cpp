@@ -350,6 +350,85 @@ static bool _processCommand(RenderPath& out, char cmd, float* arr, int count, Po
 }
 
 
+//Accumulate the path size of a command with its numbers, the numbers more than its own repeat it implicitly.
+static void _estimate(char cmd, uint32_t numbers, uint32_t& cmds, uint32_t& pts)
+{
+    auto count = _numberCount(cmd);
+    auto repeats = (count > 0 && numbers > (uint32_t) count) ? numbers / count : 1;
+
+    switch (cmd) {
+        case 'M': case 'm': case 'L': case 'l': case 'H': case 'h':
+        case 'V': case 'v': {
+            cmds += repeats;
+            pts += repeats;
+            break;
+        }
+        case 'C': case 'c': case 'S': case 's': case 'Q': case 'q':
+        case 'T': case 't': {
+            cmds += repeats;
+            pts += repeats * 3;
+            break;
+        }
+        //an arc is approximated with 4 cubics at most
+        case 'A': case 'a': {
+            cmds += repeats * 4;
+            pts += repeats * 12;
+            break;
+        }
+        case 'Z': case 'z': {
+            ++cmds;
+            break;
+        }
+        default: break;
+    }
+}
+
+
+//Estimate the path size by the commands and their numbers, so that the path arrays don't need to grow per command.
+static void _reserve(RenderPath& out, const char* path)
+{
+    uint32_t cmds = 0, pts = 0, numbers = 0;
+    char cmd = 0;
+    auto number = false;   //within a number
+    auto dot = false;      //the number has a fraction already
+
+    for (; *path; ++path) {
+        auto c = *path;
+        if (isdigit(c)) {
+            if (!number) ++numbers;
+            number = true;
+        } else if (c == '.') {
+            //".5.5" is two numbers
+            if (!number || dot) ++numbers;
+            number = dot = true;
+            continue;
+        } else if (c == '-' || c == '+') {
+            //the sign of an exponent belongs to the number
+            if (!(number && (path[-1] == 'e' || path[-1] == 'E'))) {
+                ++numbers;
+                number = true;
+                dot = false;
+            }
+            continue;
+        } else if (number && (c == 'e' || c == 'E')) {
+            continue;
+        } else {
+            number = false;
+            if (isalpha(c)) {
+                _estimate(cmd, numbers, cmds, pts);
+                cmd = c;
+                numbers = 0;
+            }
+        }
+        if (!number) dot = false;
+    }
+    _estimate(cmd, numbers, cmds, pts);
+
+    out.cmds.grow(cmds);
+    out.pts.grow(pts);
+}
+
+
 static char* _nextCommand(char* path, char* cmd, float* arr, int* count, bool* closed)
 {
     int large, sweep;
@@ -417,6 +496,8 @@ bool svgPathToShape(const char* svgPath, RenderPath& out)
     auto isQuadratic = false;
     auto closed = false;
 
+    _reserve(out, path);
+
     while ((path[0] != '\0')) {
         path = _nextCommand(path, &cmd, numberArray, &numberCount, &closed);
         if (!path) break;
@@ -450,11 +450,32 @@ static Paint* _applyProperty(SvgLoaderData& loaderData, SvgNode* node, Shape* vg
 }
 
 
+static RenderPath* _sharedPath(SvgNode* origin)
+{
+    auto& cache = origin->node.path.cache;
+    if (!cache) {
+        cache = new RenderPath;
+        if (!svgPathToShape(origin->node.path.path, *cache)) {
+            TVGERR("SVG", "Invalid path information.");
+            delete(cache);
+            cache = nullptr;
+        }
+    }
+    return cache;
+}
+
+
 static bool _recognizeShape(SvgNode* node, Shape* shape)
 {
     switch (node->type) {
         case SvgNodeType::Path: {
-            if (node->node.path.path) {
+            //<use> instance: convert the shared path data once and reuse it
+            if (auto origin = node->node.path.origin) {
+                auto cache = _sharedPath(origin);
+                if (!cache) return false;
+                SHAPE(shape)->rs.path.cmds.push(cache->cmds);
+                SHAPE(shape)->rs.path.pts.push(cache->pts);
+            } else if (node->node.path.path) {
                 if (!svgPathToShape(node->node.path.path, SHAPE(shape)->rs.path)) {
                     TVGERR("SVG", "Invalid path information.");
                     return false;
@@ -886,6 +907,149 @@ static Paint* _textBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, c
 }
 
 
+static Paint* _childBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, SvgNode* child, const Box& vBox, const string& svgPath, int depth)
+{
+    if (_isGroupType(child->type)) {
+        if (child->type == SvgNodeType::Use) return _useBuildHelper(loaderData, child, vBox, svgPath, depth + 1);
+        if (!(child->type == SvgNodeType::Symbol && node->type != SvgNodeType::Use)) return _sceneBuildHelper(loaderData, child, vBox, svgPath, false, depth + 1);
+        return nullptr;
+    }
+
+    Paint* paint = nullptr;
+    if (child->type == SvgNodeType::Image) paint = _imageBuildHelper(loaderData, child, vBox, svgPath);
+    else if (child->type == SvgNodeType::Text) paint = _textBuildHelper(loaderData, child, vBox, svgPath);
+    else if (child->type != SvgNodeType::Mask) paint = _shapeBuildHelper(loaderData, child, vBox, svgPath);
+    if (paint && child->id) paint->id = djb2Encode(child->id);
+    return paint;
+}
+
+
+#ifdef THORVG_THREAD_SUPPORT
+
+#define PARALLEL_BUILD_DEPTH 2          //the top levels to look for the independent subtrees
+#define PARALLEL_BUILD_NODES 128        //the minimum nodes of a subtree worth a worker
+
+struct SvgBuildTask : Task
+{
+    SvgLoaderData* loaderData;
+    const SvgNode* node;
+    SvgNode* child;
+    const Box* vBox;
+    const string* svgPath;
+    int depth;
+    Paint* paint = nullptr;
+    atomic<bool> claimed{false};
+
+    SvgBuildTask(SvgLoaderData* loaderData, const SvgNode* node, SvgNode* child, const Box* vBox, const string* svgPath, int depth)
+        : loaderData(loaderData), node(node), child(child), vBox(vBox), svgPath(svgPath), depth(depth) {}
+
+    //either the requester or a worker builds it, whoever comes first.
+    bool build()
+    {
+        if (claimed.exchange(true)) return false;
+        paint = _childBuildHelper(*loaderData, node, child, *vBox, *svgPath, depth);
+        return true;
+    }
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        build();
+    }
+};
+
+
+/* A subtree can be built on its own only if it doesn't touch the nodes shared with others:
+   the composition/filter sources and their references, and the images/texts which register
+   the resources to the loader. The path data shared among the <use> instances is converted here. */
+static bool _independent(SvgNode* node, uint32_t& count)
+{
+    switch (node->type) {
+        case SvgNodeType::Image:
+        case SvgNodeType::Text:
+        case SvgNodeType::ClipPath:
+        case SvgNodeType::Mask:
+        case SvgNodeType::Filter: return false;
+        case SvgNodeType::Path: {
+            if (node->node.path.origin) _sharedPath(node->node.path.origin);
+            break;
+        }
+        default: break;
+    }
+
+    if (node->style->clipPath.node || node->style->mask.node || node->style->filter.node) return false;
+
+    ++count;
+
+    ARRAY_FOREACH(p, node->child) {
+        if (!_independent(*p, count)) return false;
+    }
+    return true;
+}
+
+
+static bool _parallelBuild(SvgLoaderData& loaderData, const SvgNode* node, Scene* scene, const Box& vBox, const string& svgPath, int depth)
+{
+    Array<SvgBuildTask*> tasks(node->child.count);
+    auto cnt = 0;
+
+    ARRAY_FOREACH(p, node->child) {
+        auto child = *p;
+        uint32_t count = 0;
+        if (_isGroupType(child->type) && _independent(child, count) && count >= PARALLEL_BUILD_NODES) {
+            tasks.push(new SvgBuildTask(&loaderData, node, child, &vBox, &svgPath, depth));
+            ++cnt;
+        } else tasks.push(nullptr);
+    }
+
+    if (cnt < 2) {
+        ARRAY_FOREACH(p, tasks) delete(*p);
+        return false;
+    }
+
+    //one level of fan-out is enough
+    loaderData.parallel = false;
+
+    ARRAY_FOREACH(p, tasks) {
+        if (*p) TaskScheduler::request(*p);
+    }
+
+    /* Build the rest in the meantime, and take over the tasks not started yet.
+       Wait only for the tasks running on the workers: the ones taken over here might stay
+       in the queue of this worker thread and would never be picked up while waiting. */
+    Array<Paint*> paints(node->child.count);
+    Array<bool> started(node->child.count);
+    for (uint32_t i = 0; i < node->child.count; ++i) {
+        if (auto task = tasks[i]) {
+            started.push(!task->build());
+            paints.push(nullptr);
+        } else {
+            started.push(false);
+            paints.push(_childBuildHelper(loaderData, node, node->child[i], vBox, svgPath, depth));
+        }
+    }
+
+    for (uint32_t i = 0; i < node->child.count; ++i) {
+        auto child = node->child[i];
+        auto paint = paints[i];
+        if (auto task = tasks[i]) {
+            if (started[i]) task->done();
+            paint = task->paint;
+            //the task might be still queued, release it along with the loader.
+            loaderData.tasks.push(task);
+        }
+        if (_isGroupType(child->type)) {
+            scene->push(paint);
+            if (child->id) scene->id = djb2Encode(child->id);
+        } else if (paint) {
+            scene->push(paint);
+        }
+    }
+    return true;
+}
+
+#endif //THORVG_THREAD_SUPPORT
+
+
 static Scene* _sceneBuildHelper(SvgLoaderData& loaderData, const SvgNode* node, const Box& vBox, const string& svgPath, bool mask, int depth)
 {
     /* Exception handling: Prevent invalid SVG data input.
@@ -905,23 +1069,22 @@ static Scene* _sceneBuildHelper(SvgLoaderData& loaderData, const SvgNode* node,
 
     if (!node->style->display || node->style->opacity == 0) return scene;
 
+#ifdef THORVG_THREAD_SUPPORT
+    if (loaderData.parallel && !mask && depth <= PARALLEL_BUILD_DEPTH && _parallelBuild(loaderData, node, scene, vBox, svgPath, depth)) {
+        scene->opacity(node->style->opacity);
+        auto p = _applyFilter(loaderData, scene, node, vBox, svgPath);
+        return static_cast<Scene*>(_applyComposition(loaderData, p, node, vBox, svgPath));
+    }
+#endif
+
     ARRAY_FOREACH(p, node->child) {
         auto child = *p;
+        auto paint = _childBuildHelper(loaderData, node, child, vBox, svgPath, depth);
         if (_isGroupType(child->type)) {
-            if (child->type == SvgNodeType::Use)
-                scene->push(_useBuildHelper(loaderData, child, vBox, svgPath, depth + 1));
-            else if (!(child->type == SvgNodeType::Symbol && node->type != SvgNodeType::Use))
-                scene->push(_sceneBuildHelper(loaderData, child, vBox, svgPath, false, depth + 1));
+            scene->push(paint);
             if (child->id) scene->id = djb2Encode(child->id);
-        } else {
-            Paint* paint = nullptr;
-            if (child->type == SvgNodeType::Image) paint = _imageBuildHelper(loaderData, child, vBox, svgPath);
-            else if (child->type == SvgNodeType::Text) paint = _textBuildHelper(loaderData, child, vBox, svgPath);
-            else if (child->type != SvgNodeType::Mask) paint = _shapeBuildHelper(loaderData, child, vBox, svgPath);
-            if (paint) {
-                if (child->id) paint->id = djb2Encode(child->id);
-                scene->push(paint);
-            }
+        } else if (paint) {
+            scene->push(paint);
         }
     }
     scene->opacity(node->style->opacity);
@@ -998,6 +1161,8 @@ Scene* svgSceneBuild(SvgLoaderData& loaderData, Box vBox, float w, float h, Aspe
 
     _loadFonts(loaderData.fonts);
 
+    loaderData.parallel = (TaskScheduler::threads() > 0);
+
     auto docNode = _sceneBuildHelper(loaderData, loaderData.doc, vBox, svgPath, false, 0);
 
     if (!(viewFlag & SvgViewFlag::Viewbox)) _updateInvalidViewSize(docNode, vBox, w, h, viewFlag);
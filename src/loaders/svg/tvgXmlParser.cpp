@@ -24,11 +24,114 @@
 #include "tvgStr.h"
 #include "tvgXmlParser.h"
 
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+    #include <immintrin.h>
+    #define THORVG_XML_VECTOR_SUPPORT
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+    #include <arm_neon.h>
+    #define THORVG_XML_VECTOR_SUPPORT
+#endif
+
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+#ifdef THORVG_XML_VECTOR_SUPPORT
+
+/* The scanners below classify 16 bytes at once and convert the result into
+   a bitmask, then iterate over the set bits in the order of the input. */
+
+#define XML_VECTOR_SIZE 16
+
+#if defined(THORVG_AVX_VECTOR_SUPPORT)
+
+using XmlVector = __m128i;
+
+#define XML_VECTOR_LANE_SHIFT 0                 //1 bit per byte
+#define XML_VECTOR_FULL_MASK 0xffffULL
+
+static inline XmlVector _xmlLoad(const char* itr)
+{
+    return _mm_loadu_si128((const __m128i*)itr);
+}
+
+static inline XmlVector _xmlEqual(XmlVector v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+static inline XmlVector _xmlOr(XmlVector a, XmlVector b)
+{
+    return _mm_or_si128(a, b);
+}
+
+//isspace(): ' ', '\t', '\n', '\v', '\f', '\r'
+static inline XmlVector _xmlSpace(XmlVector v)
+{
+    auto ctrl = _mm_sub_epi8(v, _mm_set1_epi8(9));
+    auto inRange = _mm_cmpeq_epi8(_mm_min_epu8(ctrl, _mm_set1_epi8(4)), ctrl);
+    return _mm_or_si128(_xmlEqual(v, ' '), inRange);
+}
+
+static inline uint64_t _xmlMask(XmlVector v)
+{
+    return (uint64_t)(uint32_t)_mm_movemask_epi8(v);
+}
+
+#elif defined(THORVG_NEON_VECTOR_SUPPORT)
+
+using XmlVector = uint8x16_t;
+
+#define XML_VECTOR_LANE_SHIFT 2                 //4 bits per byte
+#define XML_VECTOR_FULL_MASK 0x1111111111111111ULL
+
+static inline XmlVector _xmlLoad(const char* itr)
+{
+    return vld1q_u8((const uint8_t*)itr);
+}
+
+static inline XmlVector _xmlEqual(XmlVector v, char c)
+{
+    return vceqq_u8(v, vdupq_n_u8((uint8_t)c));
+}
+
+static inline XmlVector _xmlOr(XmlVector a, XmlVector b)
+{
+    return vorrq_u8(a, b);
+}
+
+//isspace(): ' ', '\t', '\n', '\v', '\f', '\r'
+static inline XmlVector _xmlSpace(XmlVector v)
+{
+    auto inRange = vcleq_u8(vsubq_u8(v, vdupq_n_u8(9)), vdupq_n_u8(4));
+    return vorrq_u8(_xmlEqual(v, ' '), inRange);
+}
+
+//there is no movemask in neon, narrow each byte into a nibble and keep one bit of it.
+static inline uint64_t _xmlMask(XmlVector v)
+{
+    auto nibbles = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & XML_VECTOR_FULL_MASK;
+}
+
+#endif
+
+//index of the first classified byte, mask must not be zero
+static inline int _xmlFirst(uint64_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, mask);
+    return int(idx) >> XML_VECTOR_LANE_SHIFT;
+#else
+    return __builtin_ctzll(mask) >> XML_VECTOR_LANE_SHIFT;
+#endif
+}
+
+#endif //THORVG_XML_VECTOR_SUPPORT
+
+
 bool _unsupported(TVG_UNUSED const char* tagAttribute, TVG_UNUSED const char* tagValue)
 {
 #ifdef THORVG_LOG_ENABLED
@@ -61,6 +164,11 @@ bool _unsupported(TVG_UNUSED const char* tagAttribute, TVG_UNUSED const char* ta
 
 static const char* _xmlFindWhiteSpace(const char* itr, const char* itrEnd)
 {
+#ifdef THORVG_XML_VECTOR_SUPPORT
+    for (; itr + XML_VECTOR_SIZE <= itrEnd; itr += XML_VECTOR_SIZE) {
+        if (auto mask = _xmlMask(_xmlSpace(_xmlLoad(itr)))) return itr + _xmlFirst(mask);
+    }
+#endif
     for (; itr < itrEnd; itr++) {
         if (isspace((unsigned char)*itr)) break;
     }
@@ -70,6 +178,13 @@ static const char* _xmlFindWhiteSpace(const char* itr, const char* itrEnd)
 
 static const char* _xmlSkipWhiteSpace(const char* itr, const char* itrEnd)
 {
+#ifdef THORVG_XML_VECTOR_SUPPORT
+    //most of the runs are short, check the first byte before going wide
+    if (itr < itrEnd && !isspace((unsigned char)*itr)) return itr;
+    for (; itr + XML_VECTOR_SIZE <= itrEnd; itr += XML_VECTOR_SIZE) {
+        if (auto mask = ~_xmlMask(_xmlSpace(_xmlLoad(itr))) & XML_VECTOR_FULL_MASK) return itr + _xmlFirst(mask);
+    }
+#endif
     for (; itr < itrEnd; itr++) {
         if (!isspace((unsigned char)*itr)) break;
     }
@@ -158,6 +273,20 @@ static const char* _xmlFindStartTag(const char* itr, const char* itrEnd)
 static const char* _xmlFindEndTag(const char* itr, const char* itrEnd)
 {
     bool insideQuote[2] = {false, false}; // 0: ", 1: '
+#ifdef THORVG_XML_VECTOR_SUPPORT
+    //visit only the quotes and the tag brackets
+    for (; itr + XML_VECTOR_SIZE <= itrEnd; itr += XML_VECTOR_SIZE) {
+        auto v = _xmlLoad(itr);
+        auto mask = _xmlMask(_xmlOr(_xmlOr(_xmlEqual(v, '"'), _xmlEqual(v, '\'')), _xmlOr(_xmlEqual(v, '<'), _xmlEqual(v, '>'))));
+        while (mask) {
+            auto p = itr + _xmlFirst(mask);
+            if (*p == '"' && !insideQuote[1]) insideQuote[0] = !insideQuote[0];
+            else if (*p == '\'' && !insideQuote[0]) insideQuote[1] = !insideQuote[1];
+            else if (!insideQuote[0] && !insideQuote[1] && (*p == '>' || *p == '<')) return p;
+            mask &= mask - 1;
+        }
+    }
+#endif
     for (; itr < itrEnd; itr++) {
         if (*itr == '"' && !insideQuote[1]) insideQuote[0] = !insideQuote[0];
         if (*itr == '\'' && !insideQuote[0]) insideQuote[1] = !insideQuote[1];
@@ -172,6 +301,16 @@ static const char* _xmlFindEndTag(const char* itr, const char* itrEnd)
 
 static const char* _xmlFindEndCommentTag(const char* itr, const char* itrEnd)
 {
+#ifdef THORVG_XML_VECTOR_SUPPORT
+    for (; itr + XML_VECTOR_SIZE <= itrEnd; itr += XML_VECTOR_SIZE) {
+        auto mask = _xmlMask(_xmlEqual(_xmlLoad(itr), '-'));
+        while (mask) {
+            auto p = itr + _xmlFirst(mask);
+            if ((p + 2 < itrEnd) && (*(p + 1) == '-') && (*(p + 2) == '>')) return p + 2;
+            mask &= mask - 1;
+        }
+    }
+#endif
     for (; itr < itrEnd; itr++) {
         if ((*itr == '-') && ((itr + 1 < itrEnd) && (*(itr + 1) == '-')) && ((itr + 2 < itrEnd) && (*(itr + 2) == '>'))) return itr + 2;
     }
@@ -190,10 +329,7 @@ static const char* _xmlFindEndCdataTag(const char* itr, const char* itrEnd)
 
 static const char* _xmlFindDoctypeChildEndTag(const char* itr, const char* itrEnd)
 {
-    for (; itr < itrEnd; itr++) {
-        if (*itr == '>') return itr;
-    }
-    return nullptr;
+    return (const char*)memchr(itr, '>', itrEnd - itr);
 }
 
 
@@ -298,7 +434,17 @@ bool xmlParseAttributes(const char* buf, unsigned bufLength, xmlAttributeCb func
         if (p == itrEnd) goto success;
 
         key = p;
-        for (keyEnd = key; keyEnd < itrEnd; keyEnd++) {
+        keyEnd = key;
+#ifdef THORVG_XML_VECTOR_SUPPORT
+        for (; keyEnd + XML_VECTOR_SIZE <= itrEnd; keyEnd += XML_VECTOR_SIZE) {
+            auto v = _xmlLoad(keyEnd);
+            if (auto mask = _xmlMask(_xmlOr(_xmlEqual(v, '='), _xmlSpace(v)))) {
+                keyEnd += _xmlFirst(mask);
+                break;
+            }
+        }
+#endif
+        for (; keyEnd < itrEnd; keyEnd++) {
             if ((*keyEnd == '=') || (isspace((unsigned char)*keyEnd))) break;
         }
         if (keyEnd == itrEnd) goto error;
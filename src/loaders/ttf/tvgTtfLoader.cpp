@@ -22,6 +22,7 @@
 
 
 #include "tvgStr.h"
+#include "tvgShape.h"
 #include "tvgTtfLoader.h"
 
 #if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
@@ -196,6 +197,71 @@ static uint32_t* _codepoints(const char* text, size_t n)
 }
 
 
+static TtfGlyph** _probe(TtfGlyph** slots, uint32_t size, uint32_t idx)
+{
+    auto mask = size - 1;
+    auto i = (idx * 2654435761U) & mask;
+    while (slots[i] && slots[i]->idx != idx) i = (i + 1) & mask;
+    return slots + i;
+}
+
+
+static void _flush(TtfLoader* loader)
+{
+    auto& glyphs = loader->glyphs;
+    for (uint32_t i = 0; i < glyphs.size; ++i) {
+        delete(glyphs.slots[i]);
+        glyphs.slots[i] = nullptr;
+    }
+    glyphs.count = 0;
+}
+
+
+static TtfGlyph* _glyph(TtfLoader* loader, uint32_t idx)
+{
+    auto& glyphs = loader->glyphs;
+
+    if (glyphs.size > 0) {
+        if (auto glyph = *_probe(glyphs.slots, glyphs.size, idx)) return glyph;
+    }
+
+    auto glyph = new TtfGlyph;
+    glyph->idx = idx;
+    if (!loader->reader.glyphMetrics(idx, glyph->metrics)) {
+        delete(glyph);
+        return nullptr;
+    }
+    glyph->valid = loader->reader.convert(glyph->path, glyph->metrics, {0.0f, 0.0f}, {0.0f, 0.0f}, 1U);
+
+    //start over once full, the glyphs of the current layout are appended already
+    if (glyphs.count == TTF_GLYPH_CACHE_SIZE) _flush(loader);
+
+    //keep the load factor under 1/2
+    if ((glyphs.count + 1) * 2 > glyphs.size) {
+        auto old = glyphs.slots;
+        auto oldSize = glyphs.size;
+        glyphs.size = oldSize > 0 ? oldSize * 2 : 64;
+        glyphs.slots = tvg::calloc<TtfGlyph**>(glyphs.size, sizeof(TtfGlyph*));
+        for (uint32_t i = 0; i < oldSize; ++i) {
+            if (old[i]) *_probe(glyphs.slots, glyphs.size, old[i]->idx) = old[i];
+        }
+        tvg::free(old);
+    }
+    *_probe(glyphs.slots, glyphs.size, idx) = glyph;
+    ++glyphs.count;
+
+    return glyph;
+}
+
+
+static void _append(RenderPath& path, const RenderPath& outline, const Point& offset)
+{
+    path.cmds.push(outline.cmds);
+    path.pts.grow(outline.pts.count);
+    ARRAY_FOREACH(p, outline.pts) path.pts.push(*p + offset);
+}
+
+
 void TtfLoader::clear()
 {
     if (nomap) {
@@ -210,6 +276,13 @@ void TtfLoader::clear()
 #endif
     }
 
+    reader.clear();
+
+    _flush(this);
+    tvg::free(glyphs.slots);
+    glyphs.slots = nullptr;
+    glyphs.size = 0;
+
     tvg::free(name);
     name = nullptr;
     shape = nullptr;
@@ -286,8 +359,10 @@ bool TtfLoader::read(Shape* shape, char* text, FontMetrics& out)
     auto code = _codepoints(text, n);
     if (!code) return false;
 
-    //TODO: optimize with the texture-atlas?
-    TtfGlyphMetrics gmetrics;
+    //the glyph outlines are converted once, and reused by the next layouts.
+    ScopedLock lock(glyphs.key);
+
+    auto& path = SHAPE(shape)->rs.path;
     Point offset = {0.0f, reader.metrics.hhea.ascent};
     Point kerning = {0.0f, 0.0f};
     auto lglyph = INVALID_GLYPH;
@@ -295,10 +370,13 @@ bool TtfLoader::read(Shape* shape, char* text, FontMetrics& out)
 
     size_t idx = 0;
     while (code[idx] && idx < n) {
-        auto rglyph = reader.glyph(code[idx], gmetrics);
-        if (rglyph != INVALID_GLYPH) {
+        auto rglyph = reader.glyph(code[idx]);
+        auto glyph = (rglyph != INVALID_GLYPH) ? _glyph(this, rglyph) : nullptr;
+        if (glyph) {
+            auto& gmetrics = glyph->metrics;
             if (lglyph != INVALID_GLYPH) reader.kerning(lglyph, rglyph, kerning);
-            if (!reader.convert(shape, gmetrics, offset, kerning, 1U)) break;
+            _append(path, glyph->path, offset + kerning);
+            if (!glyph->valid) break;
             offset.x += (gmetrics.advanceWidth + kerning.x);
             lglyph = rglyph;
             //store the first glyph with outline min size for italic transform.
@@ -24,10 +24,24 @@
 #define _TVG_TTF_LOADER_H_
 
 #include "tvgLoader.h"
+#include "tvgLock.h"
 #include "tvgTaskScheduler.h"
 #include "tvgTtfReader.h"
 
 
+//max number of the cached glyphs per font
+#define TTF_GLYPH_CACHE_SIZE 512
+
+//the converted glyph outline in the font units, placed at the origin
+struct TtfGlyph
+{
+    RenderPath path;
+    TtfGlyphMetrics metrics;
+    uint32_t idx;     //glyph index
+    bool valid;       //the outline is converted successfully
+};
+
+
 struct TtfLoader : public FontLoader
 {
 #if defined(_WIN32) && (WINAPI_FAMILY == WINAPI_FAMILY_DESKTOP_APP)
@@ -39,6 +53,14 @@ struct TtfLoader : public FontLoader
     bool nomap = false;
     bool freeData = false;
 
+    //open addressing table of the glyphs keyed by their indices, bounded by TTF_GLYPH_CACHE_SIZE
+    struct {
+        TtfGlyph** slots = nullptr;
+        uint32_t size = 0;      //power of 2
+        uint32_t count = 0;
+        Key key;
+    } glyphs;
+
     TtfLoader();
     ~TtfLoader();
 
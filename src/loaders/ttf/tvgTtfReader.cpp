@@ -61,6 +61,22 @@ static int _cmpu32(const void *a, const void *b)
 }
 
 
+static int _cmpRange(const void *a, const void *b)
+{
+    auto l = static_cast<const TtfCodeRange*>(a)->first;
+    auto r = static_cast<const TtfCodeRange*>(b)->first;
+    return (l > r) - (l < r);
+}
+
+
+static int _cmpPair(const void *a, const void *b)
+{
+    auto l = static_cast<const TtfKernPair*>(a)->key;
+    auto r = static_cast<const TtfKernPair*>(b)->key;
+    return (l > r) - (l < r);
+}
+
+
 bool TtfReader::validate(uint32_t offset, uint32_t margin) const
 {
     if ((offset > size) || (size - offset < margin)) {
@@ -86,39 +102,71 @@ uint32_t TtfReader::table(const char* tag)
 }
 
 
-uint32_t TtfReader::cmap_12_13(uint32_t table, uint32_t codepoint, int fmt) const
+void TtfReader::cmap_12(uint32_t table)
 {
     //A minimal header is 16 bytes
     auto len = _u32(data, table + 4);
-    if (len < 16) return -1;
+    if (len < 16) return;
 
-    if (!validate(table, len)) return -1;
+    if (!validate(table, len)) return;
 
     auto entryCnt = _u32(data, table + 12);
+    if (entryCnt > (len - 16) / 12) entryCnt = (len - 16) / 12;
+
+    auto& ranges = codes.ranges;
+    ranges.reserve(entryCnt);
 
     for (uint32_t i = 0; i < entryCnt; ++i) {
         auto firstCode = _u32(data, table + (i * 12) + 16);
         auto lastCode = _u32(data, table + (i * 12) + 16 + 4);
-        if (codepoint < firstCode || codepoint > lastCode) continue;
         auto glyphOffset = _u32(data, table + (i * 12) + 16 + 8);
-        if (fmt == 12) return (codepoint - firstCode) + glyphOffset;
-        else return glyphOffset;
+        if (firstCode > lastCode) continue;
+        ranges.push({firstCode, lastCode, glyphOffset});
     }
-    return -1;
+
+    //the groups are sorted in the spec, but don't trust it.
+    for (uint32_t i = 1; i < ranges.count; ++i) {
+        if (ranges[i - 1].first > ranges[i].first) {
+            qsort(ranges.data, ranges.count, sizeof(TtfCodeRange), _cmpRange);
+            break;
+        }
+    }
+
+    //drop the groups overlapping the former ones, this keeps the BMP expansion within 64K codes.
+    uint32_t cnt = 0;
+    for (uint32_t i = 0; i < ranges.count; ++i) {
+        if (cnt > 0 && ranges[i].first <= ranges[cnt - 1].last) continue;
+        ranges[cnt++] = ranges[i];
+    }
+    ranges.count = cnt;
+
+    //expand the BMP part, and keep the rest as the ranges.
+    cnt = 0;
+    for (uint32_t i = 0; i < ranges.count; ++i) {
+        auto range = ranges[i];
+        for (auto code = range.first; code <= range.last && code <= 0xffff; ++code) {
+            auto glyph = (code - range.first) + range.glyph;
+            if (glyph < 0xffff) codes.bmp[code] = glyph;
+        }
+        if (range.last > 0xffff) {
+            if (range.first <= 0xffff) {
+                range.glyph += 0x10000 - range.first;
+                range.first = 0x10000;
+            }
+            ranges[cnt++] = range;
+        }
+    }
+    ranges.count = cnt;
 }
 
 
-uint32_t TtfReader::cmap_4(uint32_t table, uint32_t codepoint) const
+void TtfReader::cmap_4(uint32_t table)
 {
     //cmap format 4 only supports the Unicode BMP.
-    if (codepoint > 0xffff) return -1;
-
-    auto shortCode = static_cast<uint16_t>(codepoint);
-
-    if (!validate(table, 8)) return -1;
+    if (!validate(table, 8)) return;
 
     auto segmentCnt = _u16(data, table);
-    if ((segmentCnt & 1) || segmentCnt == 0) return -1;
+    if ((segmentCnt & 1) || segmentCnt == 0) return;
 
     //find starting positions of the relevant arrays.
     auto endCodes = table + 8;
@@ -126,65 +174,155 @@ uint32_t TtfReader::cmap_4(uint32_t table, uint32_t codepoint) const
     auto idDeltas = startCodes + segmentCnt;
     auto idRangeOffsets = idDeltas + segmentCnt;
 
-    if (!validate(idRangeOffsets, segmentCnt)) return -1;
-
-    //find the segment that contains shortCode by binary searching over the highest codes in the segments.
-    //binary search, but returns the next highest element if key could not be found.
-    uint8_t* segment = nullptr;
-    auto n = segmentCnt / 2;
-    if (n > 0) {
-        uint8_t key[2] = {(uint8_t)(codepoint >> 8), (uint8_t)codepoint};
-        auto bytes = data + endCodes;
-        auto low = 0;
-        auto high = n - 1;
-        while (low != high) {
-            auto mid = low + (high - low) / 2;
-            auto sample = bytes + mid * 2;
-            if (memcmp(key, sample, 2) > 0) {
-                low = mid + 1;
-            } else {
-                high = mid;
+    if (!validate(idRangeOffsets, segmentCnt)) return;
+
+    uint32_t code = 0;
+
+    for (uint32_t segmentIdx = 0; segmentIdx < segmentCnt; segmentIdx += 2) {
+        auto endCode = _u16(data, endCodes + segmentIdx);
+        auto startCode = _u16(data, startCodes + segmentIdx);
+        auto delta = _u16(data, idDeltas + segmentIdx);
+        auto idRangeOffset = _u16(data, idRangeOffsets + segmentIdx);
+
+        //the codes prior to the segment start are mapped to the missing glyph.
+        for (; code <= endCode && code < startCode; ++code) codes.bmp[code] = 0;
+
+        for (; code <= endCode; ++code) {
+            auto shortCode = static_cast<uint16_t>(code);
+            //intentional integer under- and overflow.
+            if (idRangeOffset == 0) {
+                codes.bmp[code] = (shortCode + delta) & 0xffff;
+                continue;
             }
+            //calculate offset into glyph array and determine ultimate value.
+            auto offset = idRangeOffsets + segmentIdx + idRangeOffset + 2U * (unsigned int)(shortCode - startCode);
+            if (offset > size - 2) break;
+            auto id = _u16(data, offset);
+            //intentional integer under- and overflow.
+            codes.bmp[code] = (id > 0) ? ((id + delta) & 0xffff) : 0;
         }
-        segment = (bytes + low * 2);
+        //the segments are sorted in the spec, never step back on the unsorted ones.
+        if (code <= endCode) code = endCode + 1;
     }
+}
 
-    auto segmentIdx = static_cast<uint32_t>(segment - (data + endCodes));
 
-    //look up segment info from the arrays & short circuit if the spec requires.
-    auto startCode = _u16(data, startCodes + segmentIdx);
-    if (startCode > shortCode) return 0;
+void TtfReader::cmap_6(uint32_t table)
+{
+    //cmap format 6 only supports the Unicode BMP.
+    auto firstCode  = _u16(data, table);
+    auto entryCnt = _u16(data, table + 2);
+    if (!validate(table, 4 + 2 * entryCnt)) return;
+
+    for (uint32_t i = 0; i < entryCnt && firstCode + i <= 0xffff; ++i) {
+        codes.bmp[firstCode + i] = _u16(data, table + 4 + 2 * i);
+    }
+}
+
+
+//Build the codepoint to glyph index tables from the preferred unicode cmap subtable.
+void TtfReader::buildCodes()
+{
+    codes.ready = true;
+
+    auto cmap = this->cmap.load();
+    if (cmap == 0) {
+        this->cmap = cmap = table("cmap");
+        if (!validate(cmap, 4)) return;
+    }
 
-    auto delta = _u16(data, idDeltas + segmentIdx);
-    auto idRangeOffset = _u16(data, idRangeOffsets + segmentIdx);
-    //intentional integer under- and overflow.
-    if (idRangeOffset == 0) return (shortCode + delta) & 0xffff;
+    auto entryCnt = _u16(data, cmap + 2);
+    if (!validate(cmap, 4 + entryCnt * 8)) return;
 
-    //calculate offset into glyph array and determine ultimate value.
-    auto offset = idRangeOffsets + segmentIdx + idRangeOffset + 2U * (unsigned int)(shortCode - startCode);
-    if (!validate(offset, 2)) return -1;
+    //0xffff stands for no glyph
+    codes.bmp = tvg::malloc<uint16_t*>(0x10000 * sizeof(uint16_t));
+    memset(codes.bmp, 0xff, 0x10000 * sizeof(uint16_t));
 
-    auto id = _u16(data, offset);
-    //intentional integer under- and overflow.
-    if (id > 0) return (id + delta) & 0xffff;
+    //full repertory (non-BMP map).
+    for (auto idx = 0; idx < entryCnt; ++idx) {
+        auto entry = cmap + 4 + idx * 8;
+        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
+        //unicode map
+        if (type == 0004 || type == 0312) {
+            auto table = cmap + _u32(data, entry + 4);
+            if (!validate(table, 8)) return;
+            //dispatch based on cmap format.
+            if (_u16(data, table) == 12) cmap_12(table);
+            return;
+        }
+    }
 
-    return 0;
+    //Try looking for a BMP map.
+    for (auto idx = 0; idx < entryCnt; ++idx) {
+        auto entry = cmap + 4 + idx * 8;
+        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
+        //Unicode BMP
+        if (type == 0003 || type == 0301) {
+            auto table = cmap + _u32(data, entry + 4);
+            if (!validate(table, 6)) return;
+            //Dispatch based on cmap format.
+            switch (_u16(data, table)) {
+                case 4: cmap_4(table + 6); break;
+                case 6: cmap_6(table + 6); break;
+            }
+            return;
+        }
+    }
 }
 
 
-uint32_t TtfReader::cmap_6(uint32_t table, uint32_t codepoint) const
+//Gather the kerning pairs of the all subtables into a single sorted list.
+void TtfReader::buildPairs()
 {
-    //cmap format 6 only supports the Unicode BMP.
-    if (codepoint > 0xFFFF) return 0;
+    #define HORIZONTAL_KERNING 0x01
+    #define MINIMUM_KERNING 0x02
+    #define CROSS_STREAM_KERNING 0x04
 
-    auto firstCode  = _u16(data, table);
-    auto entryCnt = _u16(data, table + 2);
-    if (!validate(table, 4 + 2 * entryCnt)) return -1;
+    pairs.ready = true;
+
+    auto kern = this->kern.load();
+
+    //kern tables
+    auto tableCnt = _u16(data, kern + 2);
+    kern += 4;
 
-    if (codepoint < firstCode) return -1;
-    codepoint -= firstCode;
-    if (codepoint >= entryCnt) return -1;
-    return _u16(data, table + 4 + 2 * codepoint);
+    while (tableCnt > 0) {
+        //read subtable header.
+        if (!validate(kern, 6)) break;
+        auto length = _u16(data, kern + 2);
+        auto format = _u8(data, kern + 4);
+        auto flags = _u8(data, kern + 5);
+
+        if (format == 0 && (flags & HORIZONTAL_KERNING) && !(flags & MINIMUM_KERNING)) {
+            //read format 0 header.
+            if (!validate(kern + 6, 8)) break;
+            auto pairCnt = _u16(data, kern + 6);
+            auto pair = kern + 14;
+            if (!validate(pair, pairCnt * 6)) break;
+
+            pairs.list.grow(pairCnt);
+            for (uint32_t i = 0; i < pairCnt; ++i, pair += 6) {
+                auto value = static_cast<float>(_i16(data, pair + 4));
+                if (flags & CROSS_STREAM_KERNING) pairs.list.push({_u32(data, pair), {0.0f, value}});
+                else pairs.list.push({_u32(data, pair), {value, 0.0f}});
+            }
+        }
+        if (length < 6) break;
+        kern += length;
+        --tableCnt;
+    }
+
+    if (pairs.list.empty()) return;
+
+    //sort and accumulate the pairs of the same glyphs.
+    qsort(pairs.list.data, pairs.list.count, sizeof(TtfKernPair), _cmpPair);
+
+    auto last = pairs.list.data;
+    for (auto p = pairs.list.begin() + 1; p < pairs.list.end(); ++p) {
+        if (p->key == last->key) last->value += p->value;
+        else *(++last) = *p;
+    }
+    pairs.list.count = static_cast<uint32_t>(last - pairs.list.data) + 1;
 }
 
 
@@ -294,6 +432,24 @@ bool TtfReader::flags(uint32_t *outline, uint8_t* flags, uint32_t flagsCnt)
 /* External Class Implementation                                        */
 /************************************************************************/
 
+TtfReader::~TtfReader()
+{
+    tvg::free(codes.bmp);
+}
+
+
+void TtfReader::clear()
+{
+    tvg::free(codes.bmp);
+    codes.bmp = nullptr;
+    codes.ranges.reset();
+    codes.ready = false;
+
+    pairs.list.reset();
+    pairs.ready = false;
+}
+
+
 bool TtfReader::header()
 {
     if (!validate(0, 12)) return false;
@@ -331,49 +487,25 @@ bool TtfReader::header()
 
 uint32_t TtfReader::glyph(uint32_t codepoint)
 {
-    auto cmap = this->cmap.load();
-    if (cmap == 0) {
-        this->cmap = cmap = table("cmap");
-        if (!validate(cmap, 4)) return -1;
-    }
-
-    auto entryCnt = _u16(data, cmap + 2);
-    if (!validate(cmap, 4 + entryCnt * 8)) return -1;
+    if (!codes.ready) buildCodes();
+    if (!codes.bmp) return INVALID_GLYPH;
 
-    //full repertory (non-BMP map).
-    for (auto idx = 0; idx < entryCnt; ++idx) {
-        auto entry = cmap + 4 + idx * 8;
-        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
-        //unicode map
-        if (type == 0004 || type == 0312) {
-            auto table = cmap + _u32(data, entry + 4);
-            if (!validate(table, 8)) return -1;
-            //dispatch based on cmap format.
-            auto format = _u16(data, table);
-            switch (format) {
-                case 12: return cmap_12_13(table, codepoint, 12);
-                default: return -1;
-            }
-        }
+    if (codepoint <= 0xffff) {
+        auto glyph = codes.bmp[codepoint];
+        return (glyph == 0xffff) ? INVALID_GLYPH : glyph;
     }
 
-    //Try looking for a BMP map.
-    for (auto idx = 0; idx < entryCnt; ++idx) {
-        auto entry = cmap + 4 + idx * 8;
-        auto type = _u16(data, entry) * 0100 + _u16(data, entry + 2);
-        //Unicode BMP
-        if (type == 0003 || type == 0301) {
-            auto table = cmap + _u32(data, entry + 4);
-            if (!validate(table, 6)) return -1;
-            //Dispatch based on cmap format.
-            switch (_u16(data, table)) {
-                case 4: return cmap_4(table + 6, codepoint);
-                case 6: return cmap_6(table + 6, codepoint);
-                default: return -1;
-            }
-        }
+    //binary search the range that contains the codepoint.
+    uint32_t low = 0;
+    auto high = codes.ranges.count;
+    while (low < high) {
+        auto mid = low + (high - low) / 2;
+        auto& range = codes.ranges[mid];
+        if (codepoint < range.first) high = mid;
+        else if (codepoint > range.last) low = mid + 1;
+        else return (codepoint - range.first) + range.glyph;
     }
-    return -1;
+    return INVALID_GLYPH;
 }
 
 
@@ -436,7 +568,7 @@ bool TtfReader::glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics)
     return true;
 }
 
-bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
+bool TtfReader::convert(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
 {
     #define ON_CURVE 0x01
 
@@ -451,7 +583,7 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
             maxComponentDepth = _u16(data, maxp + 30);
         }
         if (componentDepth > maxComponentDepth) return false;
-        return convertComposite(shape, gmetrics, offset, kerning, componentDepth + 1);
+        return convertComposite(path, gmetrics, offset, kerning, componentDepth + 1);
     }
     auto cntrsCnt = (uint32_t) outlineCnt;
 
@@ -474,7 +606,6 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
     if (!this->points(outline, flags, pts, ptsCnt, offset + kerning)) return false;
 
     //generate tvg paths.
-    auto& path = SHAPE(shape)->rs.path;
     path.cmds.reserve(ptsCnt);
     path.pts.reserve(ptsCnt);
 
@@ -514,7 +645,7 @@ bool TtfReader::convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& of
     return true;
 }
 
-bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
+bool TtfReader::convertComposite(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth)
 {
     #define ARG_1_AND_2_ARE_WORDS 0x0001
     #define ARGS_ARE_XY_VALUES 0x0002
@@ -576,7 +707,7 @@ bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const
             pointer += 8U;
         }
         if (!glyphMetrics(glyphIndex, componentGmetrics)) return false;
-        if (!convert(shape, componentGmetrics, offset + componentOffset, kerning, componentDepth)) return false;
+        if (!convert(path, componentGmetrics, offset + componentOffset, kerning, componentDepth)) return false;
     } while (flags & MORE_COMPONENTS);
     return true;
 }
@@ -584,50 +715,15 @@ bool TtfReader::convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const
 
 void TtfReader::kerning(uint32_t lglyph, uint32_t rglyph, Point& out)
 {
-    #define HORIZONTAL_KERNING 0x01
-    #define MINIMUM_KERNING 0x02
-    #define CROSS_STREAM_KERNING 0x04
-
     if (!kern) return;
 
-    auto kern = this->kern.load();
+    if (!pairs.ready) buildPairs();
 
     out.x = out.y = 0.0f;
+    if (pairs.list.empty()) return;
 
-    //kern tables
-    auto tableCnt = _u16(data, kern + 2);
-    kern += 4;
-
-    while (tableCnt > 0) {
-        //read subtable header.
-        if (!validate(kern, 6)) return;
-        auto length = _u16(data, kern + 2);
-        auto format = _u8(data, kern + 4);
-        auto flags = _u8(data, kern + 5);
-        kern += 6;
-
-        if (format == 0 && (flags & HORIZONTAL_KERNING) && !(flags & MINIMUM_KERNING)) {
-            //read format 0 header.
-            if (!validate(kern, 8)) return;
-            auto pairCnt = _u16(data, kern);
-            kern += 8;
-
-            //look up character code pair via binary search.
-            uint8_t key[4];
-            key[0] = (lglyph >> 8) & 0xff;
-            key[1] = lglyph & 0xff;
-            key[2] = (rglyph >> 8) & 0xff;
-            key[3] = rglyph & 0xff;
-
-            auto match = bsearch(key, data + kern, pairCnt, 6, _cmpu32);
-
-            if (match) {
-                auto value = _i16(data, (uint32_t)((uint8_t *) match - data + 4));
-                if (flags & CROSS_STREAM_KERNING) out.y += value;
-                else out.x += value;
-            }
-        }
-        kern += length;
-        --tableCnt;
-    }
+    TtfKernPair key = {(lglyph & 0xffff) << 16 | (rglyph & 0xffff), {}};
+    auto match = static_cast<TtfKernPair*>(bsearch(&key, pairs.list.data, pairs.list.count, sizeof(TtfKernPair), _cmpPair));
+    if (match) out = match->value;
 }
+
@@ -26,6 +26,7 @@
 #include <atomic>
 #include "tvgCommon.h"
 #include "tvgArray.h"
+#include "tvgRender.h"
 
 #define INVALID_GLYPH ((uint32_t)-1)
 
@@ -41,6 +42,21 @@ struct TtfGlyphMetrics
 };
 
 
+struct TtfCodeRange
+{
+    uint32_t first;      //the first codepoint of the range
+    uint32_t last;       //the last codepoint of the range
+    uint32_t glyph;      //the glyph index of the first codepoint
+};
+
+
+struct TtfKernPair
+{
+    uint32_t key;        //the left glyph index << 16 | the right glyph index
+    Point value;
+};
+
+
 struct TtfReader
 {
 public:
@@ -61,10 +77,15 @@ public:
         uint8_t locaFormat;    //0 for short offsets, 1 for long
     } metrics;
 
+    ~TtfReader();
+
     bool header();
+    void clear();
+    uint32_t glyph(uint32_t codepoint);
     uint32_t glyph(uint32_t codepoint, TtfGlyphMetrics& gmetrics);
+    bool glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics);
     void kerning(uint32_t lglyph, uint32_t rglyph, Point& out);
-    bool convert(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
+    bool convert(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
 
 private:
     //table offsets
@@ -75,15 +96,27 @@ private:
     atomic<uint32_t> kern{};
     atomic<uint32_t> maxp{};
 
-    uint32_t cmap_12_13(uint32_t table, uint32_t codepoint, int which) const;
-    uint32_t cmap_4(uint32_t table, uint32_t codepoint) const;
-    uint32_t cmap_6(uint32_t table, uint32_t codepoint) const;
+    //the lookup tables are built on the first use, the caller must serialize the accesses.
+    struct {
+        uint16_t* bmp = nullptr;          //the glyph indices of the Unicode BMP codepoints
+        Array<TtfCodeRange> ranges;       //the sorted codepoint ranges beyond the BMP
+        bool ready = false;
+    } codes;
+
+    struct {
+        Array<TtfKernPair> list;          //the sorted horizontal/cross-stream kerning pairs
+        bool ready = false;
+    } pairs;
+
+    void cmap_12(uint32_t table);
+    void cmap_4(uint32_t table);
+    void cmap_6(uint32_t table);
+    void buildCodes();
+    void buildPairs();
     bool validate(uint32_t offset, uint32_t margin) const;
     uint32_t table(const char* tag);
     uint32_t outlineOffset(uint32_t glyph);
-    uint32_t glyph(uint32_t codepoint);
-    bool glyphMetrics(uint32_t glyphIndex, TtfGlyphMetrics& gmetrics);
-    bool convertComposite(Shape* shape, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
+    bool convertComposite(RenderPath& path, TtfGlyphMetrics& gmetrics, const Point& offset, const Point& kerning, uint16_t componentDepth);
     bool genPath(uint8_t* flags, uint16_t basePoint, uint16_t count);
     bool genSimpleOutline(Shape* shape, uint32_t outline, uint32_t cntrsCnt);
     bool points(uint32_t outline, uint8_t* flags, Point* pts, uint32_t ptsCnt, const Point& offset);
@@ -40,7 +40,6 @@ void (*VP8PackRGB)(const uint8_t*, const uint8_t*, const uint8_t*,
                    int, int, uint32_t*);
 
 extern void VP8EncDspARGBInitMIPSdspR2(void);
-extern void VP8EncDspARGBInitSSE2(void);
 
 static volatile VP8CPUInfo argb_last_cpuinfo_used =
     (VP8CPUInfo)&argb_last_cpuinfo_used;
@@ -53,11 +52,6 @@ WEBP_TSAN_IGNORE_FUNCTION void VP8EncDspARGBInit(void) {
 
   // If defined, use CPUInfo() to overwrite some pointers with faster versions.
   if (VP8GetCPUInfo != NULL) {
-#if defined(WEBP_USE_SSE2)
-    if (VP8GetCPUInfo(kSSE2)) {
-      VP8EncDspARGBInitSSE2();
-    }
-#endif
 #if defined(WEBP_USE_MIPS_DSP_R2)
     if (VP8GetCPUInfo(kMIPSdspR2)) {
       VP8EncDspARGBInitMIPSdspR2();
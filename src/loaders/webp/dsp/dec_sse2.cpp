@@ -0,0 +1,524 @@
+// Copyright 2011 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// SSE2 version of some decoding functions (idct, loop filtering).
+// All of them are bit-exact with their C counterparts in dec.cpp.
+
+#include "./dsp.h"
+
+#if defined(WEBP_USE_SSE2)
+
+#include <emmintrin.h>
+#include <string.h>
+#include "../dec/vp8i.h"
+
+//------------------------------------------------------------------------------
+// Transforms (Paragraph 14.4)
+
+// MUL(a, kC1) and MUL(a, kC2) of the C version, with kC1 = 20091 + (1 << 16)
+// and kC2 = 35468 = -30068 + (1 << 16), using the signed high multiplication.
+static WEBP_INLINE __m128i MulC1(const __m128i x) {
+  return _mm_add_epi16(_mm_mulhi_epi16(x, _mm_set1_epi16(20091)), x);
+}
+
+static WEBP_INLINE __m128i MulC2(const __m128i x) {
+  return _mm_add_epi16(_mm_mulhi_epi16(x, _mm_set1_epi16(-30068)), x);
+}
+
+static WEBP_INLINE void IdctPass(__m128i* const x0, __m128i* const x1,
+                                 __m128i* const x2, __m128i* const x3) {
+  const __m128i a = _mm_add_epi16(*x0, *x2);
+  const __m128i b = _mm_sub_epi16(*x0, *x2);
+  const __m128i c = _mm_sub_epi16(MulC2(*x1), MulC1(*x3));
+  const __m128i d = _mm_add_epi16(MulC1(*x1), MulC2(*x3));
+  *x0 = _mm_add_epi16(a, d);
+  *x1 = _mm_add_epi16(b, c);
+  *x2 = _mm_sub_epi16(b, c);
+  *x3 = _mm_sub_epi16(a, d);
+}
+
+// Transposes the two 4x4 blocks held in the low and high halves of x0..x3.
+static WEBP_INLINE void Transpose2x4x4(__m128i* const x0, __m128i* const x1,
+                                       __m128i* const x2, __m128i* const x3) {
+  const __m128i t0 = _mm_unpacklo_epi16(*x0, *x1);
+  const __m128i t1 = _mm_unpacklo_epi16(*x2, *x3);
+  const __m128i t2 = _mm_unpackhi_epi16(*x0, *x1);
+  const __m128i t3 = _mm_unpackhi_epi16(*x2, *x3);
+  const __m128i u0 = _mm_unpacklo_epi32(t0, t1);
+  const __m128i u1 = _mm_unpackhi_epi32(t0, t1);
+  const __m128i u2 = _mm_unpacklo_epi32(t2, t3);
+  const __m128i u3 = _mm_unpackhi_epi32(t2, t3);
+  *x0 = _mm_unpacklo_epi64(u0, u2);
+  *x1 = _mm_unpackhi_epi64(u0, u2);
+  *x2 = _mm_unpacklo_epi64(u1, u3);
+  *x3 = _mm_unpackhi_epi64(u1, u3);
+}
+
+static void Transform(const int16_t* in, uint8_t* dst, int do_two) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i x[4];
+  int i;
+
+  // the first block goes in the low half, the second one (if any) in the high
+  for (i = 0; i < 4; ++i) {
+    const __m128i b0 = _mm_loadl_epi64((const __m128i*)&in[4 * i]);
+    const __m128i b1 =
+        do_two ? _mm_loadl_epi64((const __m128i*)&in[16 + 4 * i]) : zero;
+    x[i] = _mm_unpacklo_epi64(b0, b1);
+  }
+
+  // vertical pass, then the horizontal one on the transposed result
+  IdctPass(&x[0], &x[1], &x[2], &x[3]);
+  Transpose2x4x4(&x[0], &x[1], &x[2], &x[3]);
+  x[0] = _mm_add_epi16(x[0], _mm_set1_epi16(4));
+  IdctPass(&x[0], &x[1], &x[2], &x[3]);
+  Transpose2x4x4(&x[0], &x[1], &x[2], &x[3]);
+
+  // add to the prediction, rows of both blocks are adjacent in dst
+  for (i = 0; i < 4; ++i) {
+    uint8_t* const row = dst + i * BPS;
+    const __m128i res = _mm_srai_epi16(x[i], 3);
+    if (do_two) {
+      const __m128i p = _mm_loadl_epi64((const __m128i*)row);
+      const __m128i s = _mm_add_epi16(_mm_unpacklo_epi8(p, zero), res);
+      _mm_storel_epi64((__m128i*)row, _mm_packus_epi16(s, s));
+    } else {
+      int32_t p;
+      memcpy(&p, row, sizeof(p));
+      const __m128i s = _mm_add_epi16(
+          _mm_unpacklo_epi8(_mm_cvtsi32_si128(p), zero), res);
+      p = _mm_cvtsi128_si32(_mm_packus_epi16(s, s));
+      memcpy(row, &p, sizeof(p));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Loop Filter (Paragraph 15)
+//
+// The filters work on 16 lanes at once: the pixels are flipped to the signed
+// range (x ^ 0x80) where the saturated 8bit arithmetic does the same clipping
+// as the VP8ksclip1/VP8ksclip2/VP8kclip1 tables of the C version.
+
+static WEBP_INLINE __m128i Abs(const __m128i a, const __m128i b) {
+  return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+static WEBP_INLINE __m128i FlipSign(const __m128i x) {
+  return _mm_xor_si128(x, _mm_set1_epi8((char)0x80));
+}
+
+// Signed (x >> 3) of the bytes.
+static WEBP_INLINE __m128i SignedShift3(const __m128i x) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(zero, x), 3 + 8);
+  const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(zero, x), 3 + 8);
+  return _mm_packs_epi16(lo, hi);
+}
+
+// 4 * |p0 - q0| + |p1 - q1| <= 2 * thresh + 1, computed as
+// 2 * |p0 - q0| + |p1 - q1| / 2 <= thresh to stay in 8 bits.
+static WEBP_INLINE __m128i NeedsFilter(const __m128i p1, const __m128i p0,
+                                       const __m128i q0, const __m128i q1,
+                                       int thresh) {
+  const __m128i half = _mm_srli_epi16(
+      _mm_and_si128(Abs(p1, q1), _mm_set1_epi8((char)0xfe)), 1);
+  const __m128i t = _mm_adds_epu8(_mm_adds_epu8(Abs(p0, q0), Abs(p0, q0)),
+                                  half);
+  return _mm_cmpeq_epi8(_mm_subs_epu8(t, _mm_set1_epi8((char)thresh)),
+                        _mm_setzero_si128());
+}
+
+// x[] holds p3, p2, p1, p0, q0, q1, q2, q3
+static WEBP_INLINE __m128i NeedsFilter2(const __m128i* const x,
+                                        int thresh, int ithresh) {
+  __m128i m = _mm_max_epu8(Abs(x[0], x[1]), Abs(x[1], x[2]));
+  m = _mm_max_epu8(m, Abs(x[2], x[3]));
+  m = _mm_max_epu8(m, Abs(x[7], x[6]));
+  m = _mm_max_epu8(m, Abs(x[6], x[5]));
+  m = _mm_max_epu8(m, Abs(x[5], x[4]));
+  m = _mm_cmpeq_epi8(_mm_subs_epu8(m, _mm_set1_epi8((char)ithresh)),
+                     _mm_setzero_si128());
+  return _mm_and_si128(m, NeedsFilter(x[2], x[3], x[4], x[5], thresh));
+}
+
+// |p1 - p0| <= thresh && |q1 - q0| <= thresh
+static WEBP_INLINE __m128i NotHev(const __m128i p1, const __m128i p0,
+                                  const __m128i q0, const __m128i q1,
+                                  int hev_thresh) {
+  const __m128i t = _mm_max_epu8(Abs(p1, p0), Abs(q1, q0));
+  return _mm_cmpeq_epi8(_mm_subs_epu8(t, _mm_set1_epi8((char)hev_thresh)),
+                        _mm_setzero_si128());
+}
+
+// p1 - q1 + 3 * (q0 - p0) on the signed pixels
+static WEBP_INLINE __m128i BaseDelta(const __m128i p1, const __m128i p0,
+                                     const __m128i q0, const __m128i q1) {
+  const __m128i q0_p0 = _mm_subs_epi8(q0, p0);
+  const __m128i s = _mm_adds_epi8(_mm_subs_epi8(p1, q1), q0_p0);
+  return _mm_adds_epi8(q0_p0, _mm_adds_epi8(q0_p0, s));
+}
+
+// do_filter2() on the signed pixels
+static WEBP_INLINE void DoSimpleFilter(__m128i* const p0, __m128i* const q0,
+                                       const __m128i a) {
+  const __m128i a1 = SignedShift3(_mm_adds_epi8(a, _mm_set1_epi8(4)));
+  const __m128i a2 = SignedShift3(_mm_adds_epi8(a, _mm_set1_epi8(3)));
+  *q0 = _mm_subs_epi8(*q0, a1);
+  *p0 = _mm_adds_epi8(*p0, a2);
+}
+
+static WEBP_INLINE void DoFilter2(__m128i* const p1, __m128i* const p0,
+                                  __m128i* const q0, __m128i* const q1,
+                                  const __m128i mask) {
+  const __m128i sp1 = FlipSign(*p1), sq1 = FlipSign(*q1);
+  __m128i sp0 = FlipSign(*p0), sq0 = FlipSign(*q0);
+  const __m128i a = _mm_and_si128(BaseDelta(sp1, sp0, sq0, sq1), mask);
+  DoSimpleFilter(&sp0, &sq0, a);
+  *p0 = FlipSign(sp0);
+  *q0 = FlipSign(sq0);
+}
+
+// do_filter2() where hev, do_filter4() elsewhere
+static WEBP_INLINE void DoFilter4(__m128i* const p1, __m128i* const p0,
+                                  __m128i* const q0, __m128i* const q1,
+                                  const __m128i mask, int hev_thresh) {
+  const __m128i not_hev = NotHev(*p1, *p0, *q0, *q1, hev_thresh);
+  const __m128i sp1 = FlipSign(*p1), sp0 = FlipSign(*p0);
+  const __m128i sq0 = FlipSign(*q0), sq1 = FlipSign(*q1);
+  const __m128i q0_p0 = _mm_subs_epi8(sq0, sp0);
+  __m128i a = _mm_andnot_si128(not_hev, _mm_subs_epi8(sp1, sq1));
+  __m128i a1, a2, a3;
+  a = _mm_adds_epi8(a, q0_p0);
+  a = _mm_adds_epi8(a, q0_p0);
+  a = _mm_adds_epi8(a, q0_p0);
+  a = _mm_and_si128(a, mask);
+
+  a1 = SignedShift3(_mm_adds_epi8(a, _mm_set1_epi8(4)));
+  a2 = SignedShift3(_mm_adds_epi8(a, _mm_set1_epi8(3)));
+  *p0 = FlipSign(_mm_adds_epi8(sp0, a2));
+  *q0 = FlipSign(_mm_subs_epi8(sq0, a1));
+
+  // (a1 + 1) >> 1, signed: avg(x + 128, 0) - 64
+  a3 = _mm_avg_epu8(FlipSign(a1), _mm_setzero_si128());
+  a3 = _mm_and_si128(_mm_sub_epi8(a3, _mm_set1_epi8(64)), not_hev);
+  *p1 = FlipSign(_mm_adds_epi8(sp1, a3));
+  *q1 = FlipSign(_mm_subs_epi8(sq1, a3));
+}
+
+// p += t >> 7, q -= t >> 7 with t = k * a + 63 in 16 bits
+static WEBP_INLINE void Update2Pixels(__m128i* const p, __m128i* const q,
+                                      const __m128i lo, const __m128i hi) {
+  const __m128i d = _mm_packs_epi16(_mm_srai_epi16(lo, 7),
+                                    _mm_srai_epi16(hi, 7));
+  *p = _mm_adds_epi8(*p, d);
+  *q = _mm_subs_epi8(*q, d);
+}
+
+// do_filter2() where hev, do_filter6() elsewhere
+static WEBP_INLINE void DoFilter6(__m128i* const p2, __m128i* const p1,
+                                  __m128i* const p0, __m128i* const q0,
+                                  __m128i* const q1, __m128i* const q2,
+                                  const __m128i mask, int hev_thresh) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i not_hev = NotHev(*p1, *p0, *q0, *q1, hev_thresh);
+  __m128i sp2 = FlipSign(*p2), sp1 = FlipSign(*p1), sp0 = FlipSign(*p0);
+  __m128i sq0 = FlipSign(*q0), sq1 = FlipSign(*q1), sq2 = FlipSign(*q2);
+  const __m128i a = BaseDelta(sp1, sp0, sq0, sq1);
+
+  DoSimpleFilter(&sp0, &sq0, _mm_and_si128(a, _mm_andnot_si128(not_hev, mask)));
+
+  {
+    // 9 * a in 16 bits: (a << 8) * (9 << 8) >> 16
+    const __m128i f = _mm_and_si128(a, _mm_and_si128(not_hev, mask));
+    const __m128i k9 = _mm_set1_epi16(0x0900);
+    const __m128i k63 = _mm_set1_epi16(63);
+    const __m128i f9_lo = _mm_mulhi_epi16(_mm_unpacklo_epi8(zero, f), k9);
+    const __m128i f9_hi = _mm_mulhi_epi16(_mm_unpackhi_epi8(zero, f), k9);
+    const __m128i a3_lo = _mm_add_epi16(f9_lo, k63);
+    const __m128i a3_hi = _mm_add_epi16(f9_hi, k63);
+    const __m128i a2_lo = _mm_add_epi16(a3_lo, f9_lo);
+    const __m128i a2_hi = _mm_add_epi16(a3_hi, f9_hi);
+    const __m128i a1_lo = _mm_add_epi16(a2_lo, f9_lo);
+    const __m128i a1_hi = _mm_add_epi16(a2_hi, f9_hi);
+    Update2Pixels(&sp2, &sq2, a3_lo, a3_hi);
+    Update2Pixels(&sp1, &sq1, a2_lo, a2_hi);
+    Update2Pixels(&sp0, &sq0, a1_lo, a1_hi);
+  }
+
+  *p2 = FlipSign(sp2);
+  *p1 = FlipSign(sp1);
+  *p0 = FlipSign(sp0);
+  *q0 = FlipSign(sq0);
+  *q1 = FlipSign(sq1);
+  *q2 = FlipSign(sq2);
+}
+
+//------------------------------------------------------------------------------
+// Pixel loading for the vertical edges: 16 rows of 8 pixels (the first 8 rows
+// from 'top', the last 8 from 'bottom') transposed into 8 columns of 16 lanes.
+
+static WEBP_INLINE void Load16x8(const uint8_t* top, const uint8_t* bottom,
+                                 int stride, __m128i* const x) {
+  __m128i a[8], b[8], c[8];
+  int i;
+  for (i = 0; i < 4; ++i) {
+    a[i] = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((const __m128i*)(top + (2 * i + 0) * stride)),
+        _mm_loadl_epi64((const __m128i*)(top + (2 * i + 1) * stride)));
+    a[i + 4] = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((const __m128i*)(bottom + (2 * i + 0) * stride)),
+        _mm_loadl_epi64((const __m128i*)(bottom + (2 * i + 1) * stride)));
+  }
+  for (i = 0; i < 8; i += 2) {
+    b[i + 0] = _mm_unpacklo_epi16(a[i], a[i + 1]);
+    b[i + 1] = _mm_unpackhi_epi16(a[i], a[i + 1]);
+  }
+  for (i = 0; i < 8; i += 4) {
+    c[i + 0] = _mm_unpacklo_epi32(b[i + 0], b[i + 2]);
+    c[i + 1] = _mm_unpackhi_epi32(b[i + 0], b[i + 2]);
+    c[i + 2] = _mm_unpacklo_epi32(b[i + 1], b[i + 3]);
+    c[i + 3] = _mm_unpackhi_epi32(b[i + 1], b[i + 3]);
+  }
+  for (i = 0; i < 4; ++i) {
+    x[2 * i + 0] = _mm_unpacklo_epi64(c[i], c[i + 4]);
+    x[2 * i + 1] = _mm_unpackhi_epi64(c[i], c[i + 4]);
+  }
+}
+
+static WEBP_INLINE void Store16x8(const __m128i* const x,
+                                  uint8_t* top, uint8_t* bottom, int stride) {
+  __m128i a[8], b[8];
+  int i;
+  for (i = 0; i < 4; ++i) {
+    a[i + 0] = _mm_unpacklo_epi8(x[2 * i], x[2 * i + 1]);
+    a[i + 4] = _mm_unpackhi_epi8(x[2 * i], x[2 * i + 1]);
+  }
+  for (i = 0; i < 8; i += 4) {
+    b[i + 0] = _mm_unpacklo_epi16(a[i + 0], a[i + 1]);
+    b[i + 1] = _mm_unpackhi_epi16(a[i + 0], a[i + 1]);
+    b[i + 2] = _mm_unpacklo_epi16(a[i + 2], a[i + 3]);
+    b[i + 3] = _mm_unpackhi_epi16(a[i + 2], a[i + 3]);
+  }
+  for (i = 0; i < 8; i += 4) {
+    uint8_t* const dst = (i == 0) ? top : bottom;
+    const __m128i r01 = _mm_unpacklo_epi32(b[i + 0], b[i + 2]);
+    const __m128i r23 = _mm_unpackhi_epi32(b[i + 0], b[i + 2]);
+    const __m128i r45 = _mm_unpacklo_epi32(b[i + 1], b[i + 3]);
+    const __m128i r67 = _mm_unpackhi_epi32(b[i + 1], b[i + 3]);
+    _mm_storel_epi64((__m128i*)(dst + 0 * stride), r01);
+    _mm_storel_epi64((__m128i*)(dst + 1 * stride), _mm_unpackhi_epi64(r01, r01));
+    _mm_storel_epi64((__m128i*)(dst + 2 * stride), r23);
+    _mm_storel_epi64((__m128i*)(dst + 3 * stride), _mm_unpackhi_epi64(r23, r23));
+    _mm_storel_epi64((__m128i*)(dst + 4 * stride), r45);
+    _mm_storel_epi64((__m128i*)(dst + 5 * stride), _mm_unpackhi_epi64(r45, r45));
+    _mm_storel_epi64((__m128i*)(dst + 6 * stride), r67);
+    _mm_storel_epi64((__m128i*)(dst + 7 * stride), _mm_unpackhi_epi64(r67, r67));
+  }
+}
+
+// 8 rows of 16 pixels around the horizontal edge at p
+static WEBP_INLINE void Load16Rows(const uint8_t* p, int stride,
+                                   __m128i* const x) {
+  int i;
+  for (i = 0; i < 8; ++i) {
+    x[i] = _mm_loadu_si128((const __m128i*)(p + (i - 4) * stride));
+  }
+}
+
+static WEBP_INLINE void Store16Rows(const __m128i* const x, uint8_t* p,
+                                    int stride, int first, int last) {
+  int i;
+  for (i = first; i <= last; ++i) {
+    _mm_storeu_si128((__m128i*)(p + (i - 4) * stride), x[i]);
+  }
+}
+
+// 8 rows of 8 u and 8 v pixels around the horizontal edges at u and v
+static WEBP_INLINE void Load8UVRows(const uint8_t* u, const uint8_t* v,
+                                    int stride, __m128i* const x) {
+  int i;
+  for (i = 0; i < 8; ++i) {
+    x[i] = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i*)(u + (i - 4) * stride)),
+        _mm_loadl_epi64((const __m128i*)(v + (i - 4) * stride)));
+  }
+}
+
+static WEBP_INLINE void Store8UVRows(const __m128i* const x, uint8_t* u,
+                                     uint8_t* v, int stride, int first,
+                                     int last) {
+  int i;
+  for (i = first; i <= last; ++i) {
+    _mm_storel_epi64((__m128i*)(u + (i - 4) * stride), x[i]);
+    _mm_storel_epi64((__m128i*)(v + (i - 4) * stride),
+                     _mm_unpackhi_epi64(x[i], x[i]));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Simple In-loop filtering (Paragraph 15.2)
+
+static void SimpleVFilter16(uint8_t* p, int stride, int thresh) {
+  __m128i p1 = _mm_loadu_si128((const __m128i*)(p - 2 * stride));
+  __m128i p0 = _mm_loadu_si128((const __m128i*)(p - stride));
+  __m128i q0 = _mm_loadu_si128((const __m128i*)(p));
+  __m128i q1 = _mm_loadu_si128((const __m128i*)(p + stride));
+  DoFilter2(&p1, &p0, &q0, &q1, NeedsFilter(p1, p0, q0, q1, thresh));
+  _mm_storeu_si128((__m128i*)(p - stride), p0);
+  _mm_storeu_si128((__m128i*)p, q0);
+}
+
+static void SimpleHFilter16(uint8_t* p, int stride, int thresh) {
+  __m128i x[8];
+  Load16x8(p - 4, p - 4 + 8 * stride, stride, x);
+  DoFilter2(&x[2], &x[3], &x[4], &x[5],
+            NeedsFilter(x[2], x[3], x[4], x[5], thresh));
+  Store16x8(x, p - 4, p - 4 + 8 * stride, stride);
+}
+
+static void SimpleVFilter16i(uint8_t* p, int stride, int thresh) {
+  int k;
+  for (k = 3; k > 0; --k) {
+    p += 4 * stride;
+    SimpleVFilter16(p, stride, thresh);
+  }
+}
+
+static void SimpleHFilter16i(uint8_t* p, int stride, int thresh) {
+  int k;
+  for (k = 3; k > 0; --k) {
+    p += 4;
+    SimpleHFilter16(p, stride, thresh);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Complex In-loop filtering (Paragraph 15.3)
+
+// x[] holds p3, p2, p1, p0, q0, q1, q2, q3
+static WEBP_INLINE void FilterLoop26(__m128i* const x, int thresh,
+                                     int ithresh, int hev_thresh) {
+  const __m128i mask = NeedsFilter2(x, thresh, ithresh);
+  DoFilter6(&x[1], &x[2], &x[3], &x[4], &x[5], &x[6], mask, hev_thresh);
+}
+
+static WEBP_INLINE void FilterLoop24(__m128i* const x, int thresh,
+                                     int ithresh, int hev_thresh) {
+  const __m128i mask = NeedsFilter2(x, thresh, ithresh);
+  DoFilter4(&x[2], &x[3], &x[4], &x[5], mask, hev_thresh);
+}
+
+// on macroblock edges
+static void VFilter16(uint8_t* p, int stride,
+                      int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  Load16Rows(p, stride, x);
+  FilterLoop26(x, thresh, ithresh, hev_thresh);
+  Store16Rows(x, p, stride, 1, 6);
+}
+
+static void HFilter16(uint8_t* p, int stride,
+                      int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  Load16x8(p - 4, p - 4 + 8 * stride, stride, x);
+  FilterLoop26(x, thresh, ithresh, hev_thresh);
+  Store16x8(x, p - 4, p - 4 + 8 * stride, stride);
+}
+
+// on three inner edges
+static void VFilter16i(uint8_t* p, int stride,
+                       int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  int k;
+  for (k = 3; k > 0; --k) {
+    p += 4 * stride;
+    Load16Rows(p, stride, x);
+    FilterLoop24(x, thresh, ithresh, hev_thresh);
+    Store16Rows(x, p, stride, 2, 5);
+  }
+}
+
+static void HFilter16i(uint8_t* p, int stride,
+                       int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  int k;
+  for (k = 3; k > 0; --k) {
+    p += 4;
+    Load16x8(p - 4, p - 4 + 8 * stride, stride, x);
+    FilterLoop24(x, thresh, ithresh, hev_thresh);
+    Store16x8(x, p - 4, p - 4 + 8 * stride, stride);
+  }
+}
+
+// 8-pixels wide variant, for chroma filtering: u and v are done together
+static void VFilter8(uint8_t* u, uint8_t* v, int stride,
+                     int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  Load8UVRows(u, v, stride, x);
+  FilterLoop26(x, thresh, ithresh, hev_thresh);
+  Store8UVRows(x, u, v, stride, 1, 6);
+}
+
+static void HFilter8(uint8_t* u, uint8_t* v, int stride,
+                     int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  Load16x8(u - 4, v - 4, stride, x);
+  FilterLoop26(x, thresh, ithresh, hev_thresh);
+  Store16x8(x, u - 4, v - 4, stride);
+}
+
+static void VFilter8i(uint8_t* u, uint8_t* v, int stride,
+                      int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  u += 4 * stride;
+  v += 4 * stride;
+  Load8UVRows(u, v, stride, x);
+  FilterLoop24(x, thresh, ithresh, hev_thresh);
+  Store8UVRows(x, u, v, stride, 2, 5);
+}
+
+static void HFilter8i(uint8_t* u, uint8_t* v, int stride,
+                      int thresh, int ithresh, int hev_thresh) {
+  __m128i x[8];
+  u += 4;
+  v += 4;
+  Load16x8(u - 4, v - 4, stride, x);
+  FilterLoop24(x, thresh, ithresh, hev_thresh);
+  Store16x8(x, u - 4, v - 4, stride);
+}
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void VP8DspInitSSE2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void VP8DspInitSSE2(void) {
+  VP8Transform = Transform;
+
+  VP8VFilter16 = VFilter16;
+  VP8HFilter16 = HFilter16;
+  VP8VFilter8 = VFilter8;
+  VP8HFilter8 = HFilter8;
+  VP8VFilter16i = VFilter16i;
+  VP8HFilter16i = HFilter16i;
+  VP8VFilter8i = VFilter8i;
+  VP8HFilter8i = HFilter8i;
+
+  VP8SimpleVFilter16 = SimpleVFilter16;
+  VP8SimpleHFilter16 = SimpleHFilter16;
+  VP8SimpleVFilter16i = SimpleVFilter16i;
+  VP8SimpleHFilter16i = SimpleHFilter16i;
+}
+
+#else  // !WEBP_USE_SSE2
+
+WEBP_DSP_INIT_STUB(VP8DspInitSSE2)
+
+#endif  // WEBP_USE_SSE2
@@ -57,7 +57,7 @@ extern "C" {
 // Files containing intrinsics will need to be built targeting the instruction
 // set so should succeed on one of the earlier tests.
 #if defined(__SSE2__) || defined(WEBP_MSC_SSE2) || defined(WEBP_HAVE_SSE2)
-//#define WEBP_USE_SSE2
+#define WEBP_USE_SSE2
 #endif
 
 // This macro prevents thread_sanitizer from reporting known concurrent writes.
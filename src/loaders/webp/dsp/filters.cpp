@@ -206,7 +206,6 @@ WebPFilterFunc WebPFilters[WEBP_FILTER_LAST];
 WebPUnfilterFunc WebPUnfilters[WEBP_FILTER_LAST];
 
 extern void VP8FiltersInitMIPSdspR2(void);
-extern void VP8FiltersInitSSE2(void);
 
 static volatile VP8CPUInfo filters_last_cpuinfo_used =
     (VP8CPUInfo)&filters_last_cpuinfo_used;
@@ -225,11 +224,6 @@ WEBP_TSAN_IGNORE_FUNCTION void VP8FiltersInit(void) {
   WebPFilters[WEBP_FILTER_GRADIENT] = GradientFilter;
 
   if (VP8GetCPUInfo != NULL) {
-#if defined(WEBP_USE_SSE2)
-    if (VP8GetCPUInfo(kSSE2)) {
-      VP8FiltersInitSSE2();
-    }
-#endif
 #if defined(WEBP_USE_MIPS_DSP_R2)
     if (VP8GetCPUInfo(kMIPSdspR2)) {
       VP8FiltersInitMIPSdspR2();
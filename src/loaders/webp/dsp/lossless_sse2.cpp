@@ -0,0 +1,107 @@
+// Copyright 2014 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// SSE2 variant of methods for lossless decoder
+
+#include "./dsp.h"
+
+#if defined(WEBP_USE_SSE2)
+
+#include <emmintrin.h>
+#include "./lossless.h"
+
+//------------------------------------------------------------------------------
+// Color Transforms
+
+static void AddGreenToBlueAndRed(uint32_t* argb_data, int num_pixels) {
+  int i;
+  for (i = 0; i + 4 <= num_pixels; i += 4) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)&argb_data[i]);
+    const __m128i A = _mm_srli_epi16(in, 8);     // 0 a 0 g
+    const __m128i B = _mm_shufflelo_epi16(A, _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128i C = _mm_shufflehi_epi16(B, _MM_SHUFFLE(2, 2, 0, 0));  // 0g0g
+    const __m128i out = _mm_add_epi8(in, C);
+    _mm_storeu_si128((__m128i*)&argb_data[i], out);
+  }
+  // fallthrough and finish off with plain-C
+  VP8LAddGreenToBlueAndRed_C(argb_data + i, num_pixels - i);
+}
+
+static void TransformColorInverse(const VP8LMultipliers* const m,
+                                  uint32_t* argb_data, int num_pixels) {
+  // sign-extended multiplying constants, pre-shifted by 5:
+  // mulhi(x << 8, c << 3) == (x * c) >> 5
+#define CST(X)  (((int16_t)(m->X << 8)) >> 5)
+  const __m128i mults_rb = _mm_set_epi16(
+      CST(green_to_red_), CST(green_to_blue_),
+      CST(green_to_red_), CST(green_to_blue_),
+      CST(green_to_red_), CST(green_to_blue_),
+      CST(green_to_red_), CST(green_to_blue_));
+  const __m128i mults_b2 = _mm_set_epi16(
+      CST(red_to_blue_), 0, CST(red_to_blue_), 0,
+      CST(red_to_blue_), 0, CST(red_to_blue_), 0);
+#undef CST
+  const __m128i mask_ag = _mm_set1_epi32(0xff00ff00);  // alpha-green masks
+  int i;
+  for (i = 0; i + 4 <= num_pixels; i += 4) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)&argb_data[i]);
+    const __m128i A = _mm_and_si128(in, mask_ag);     // a   0   g   0
+    const __m128i B = _mm_shufflelo_epi16(A, _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128i C = _mm_shufflehi_epi16(B, _MM_SHUFFLE(2, 2, 0, 0));  // g0g0
+    const __m128i D = _mm_mulhi_epi16(C, mults_rb);   // x   dr  x   db1
+    const __m128i E = _mm_add_epi8(in, D);            // x   r'  x   b'
+    const __m128i F = _mm_slli_epi16(E, 8);           // r'  0   b'  0
+    const __m128i G = _mm_mulhi_epi16(F, mults_b2);   // x   db2 0   0
+    const __m128i H = _mm_srli_epi32(G, 8);           // 0   x   db2 0
+    const __m128i I = _mm_add_epi8(H, F);             // r'  x   b'' 0
+    const __m128i J = _mm_srli_epi16(I, 8);           // 0   r'  0   b''
+    const __m128i out = _mm_or_si128(J, A);
+    _mm_storeu_si128((__m128i*)&argb_data[i], out);
+  }
+  // Fall-back to C-version for left-overs.
+  VP8LTransformColorInverse_C(m, argb_data + i, num_pixels - i);
+}
+
+//------------------------------------------------------------------------------
+// Color-space conversion functions
+
+static void ConvertBGRAToRGBA(const uint32_t* src,
+                              int num_pixels, uint8_t* dst) {
+  const __m128i mask_ag = _mm_set1_epi32(0xff00ff00);
+  const uint32_t* const src_end = src + (num_pixels & ~3);
+  while (src < src_end) {
+    const __m128i in = _mm_loadu_si128((const __m128i*)src);
+    const __m128i ag = _mm_and_si128(in, mask_ag);     // a 0 g 0
+    const __m128i br = _mm_andnot_si128(mask_ag, in);  // 0 r 0 b
+    // swap the two 16b halves of each pixel: 0 b 0 r
+    const __m128i rb0 = _mm_shufflelo_epi16(br, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m128i rb = _mm_shufflehi_epi16(rb0, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128((__m128i*)dst, _mm_or_si128(ag, rb));
+    src += 4;
+    dst += 16;
+  }
+  VP8LConvertBGRAToRGBA_C(src, num_pixels & 3, dst);  // left-overs
+}
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void VP8LDspInitSSE2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void VP8LDspInitSSE2(void) {
+  VP8LAddGreenToBlueAndRed = AddGreenToBlueAndRed;
+  VP8LTransformColorInverse = TransformColorInverse;
+  VP8LConvertBGRAToRGBA = ConvertBGRAToRGBA;
+}
+
+#else  // !WEBP_USE_SSE2
+
+WEBP_DSP_INIT_STUB(VP8LDspInitSSE2)
+
+#endif  // WEBP_USE_SSE2
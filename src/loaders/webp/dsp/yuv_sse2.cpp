@@ -0,0 +1,160 @@
+// Copyright 2014 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// YUV->RGB conversion functions, SSE2 version.
+// Bit-exact with the plain-C VP8YUVToR/G/B() of yuv.h.
+
+#include "./yuv.h"
+
+#if defined(WEBP_USE_SSE2) && !defined(WEBP_YUV_USE_TABLE)
+
+#include <emmintrin.h>
+#include <string.h>
+
+// Computes R, G and B (as 16b) of 8 pixels, with u/v shared by pixel pairs.
+// The 32b sums match the C version: (kYScale * y + kVToR * v + kRCst) etc.
+static WEBP_INLINE void YuvToRgb8(const uint8_t* y, const uint8_t* u,
+                                  const uint8_t* v, __m128i* const R,
+                                  __m128i* const G, __m128i* const B) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i kYVToR = _mm_set_epi16(kVToR, kYScale, kVToR, kYScale,
+                                       kVToR, kYScale, kVToR, kYScale);
+  const __m128i kYUToG = _mm_set_epi16(-kUToG, kYScale, -kUToG, kYScale,
+                                       -kUToG, kYScale, -kUToG, kYScale);
+  const __m128i kVToG0 = _mm_set_epi16(0, -kVToG, 0, -kVToG,
+                                       0, -kVToG, 0, -kVToG);
+  // kUToB doesn't fit in 16 bits: u * kUToB = u * (kUToB - 32768) + (u << 15)
+  const __m128i kYUToB = _mm_set_epi16(kUToB - 32768, kYScale,
+                                       kUToB - 32768, kYScale,
+                                       kUToB - 32768, kYScale,
+                                       kUToB - 32768, kYScale);
+  int32_t u4, v4;
+  __m128i Y, U, V;
+  memcpy(&u4, u, sizeof(u4));
+  memcpy(&v4, v, sizeof(v4));
+  Y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)y), zero);
+  U = _mm_cvtsi32_si128(u4);
+  V = _mm_cvtsi32_si128(v4);
+  U = _mm_unpacklo_epi8(_mm_unpacklo_epi8(U, U), zero);
+  V = _mm_unpacklo_epi8(_mm_unpacklo_epi8(V, V), zero);
+
+  {
+    const __m128i yv_lo = _mm_unpacklo_epi16(Y, V);
+    const __m128i yv_hi = _mm_unpackhi_epi16(Y, V);
+    const __m128i cst = _mm_set1_epi32(kRCst);
+    const __m128i lo = _mm_add_epi32(_mm_madd_epi16(yv_lo, kYVToR), cst);
+    const __m128i hi = _mm_add_epi32(_mm_madd_epi16(yv_hi, kYVToR), cst);
+    *R = _mm_packs_epi32(_mm_srai_epi32(lo, YUV_FIX2),
+                         _mm_srai_epi32(hi, YUV_FIX2));
+  }
+  {
+    const __m128i yu_lo = _mm_unpacklo_epi16(Y, U);
+    const __m128i yu_hi = _mm_unpackhi_epi16(Y, U);
+    const __m128i v_lo = _mm_unpacklo_epi16(V, zero);
+    const __m128i v_hi = _mm_unpackhi_epi16(V, zero);
+    const __m128i cst = _mm_set1_epi32(kGCst);
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(yu_lo, kYUToG),
+                               _mm_madd_epi16(v_lo, kVToG0));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(yu_hi, kYUToG),
+                               _mm_madd_epi16(v_hi, kVToG0));
+    lo = _mm_add_epi32(lo, cst);
+    hi = _mm_add_epi32(hi, cst);
+    *G = _mm_packs_epi32(_mm_srai_epi32(lo, YUV_FIX2),
+                         _mm_srai_epi32(hi, YUV_FIX2));
+
+    lo = _mm_add_epi32(_mm_madd_epi16(yu_lo, kYUToB),
+                       _mm_slli_epi32(_mm_unpacklo_epi16(U, zero), 15));
+    hi = _mm_add_epi32(_mm_madd_epi16(yu_hi, kYUToB),
+                       _mm_slli_epi32(_mm_unpackhi_epi16(U, zero), 15));
+    lo = _mm_add_epi32(lo, _mm_set1_epi32(kBCst));
+    hi = _mm_add_epi32(hi, _mm_set1_epi32(kBCst));
+    *B = _mm_packs_epi32(_mm_srai_epi32(lo, YUV_FIX2),
+                         _mm_srai_epi32(hi, YUV_FIX2));
+  }
+}
+
+// R, G, B as 16 clipped bytes of 16 pixels
+static WEBP_INLINE void YuvToRgb16(const uint8_t* y, const uint8_t* u,
+                                   const uint8_t* v, __m128i* const R,
+                                   __m128i* const G, __m128i* const B) {
+  __m128i R0, G0, B0, R1, G1, B1;
+  YuvToRgb8(y + 0, u + 0, v + 0, &R0, &G0, &B0);
+  YuvToRgb8(y + 8, u + 4, v + 4, &R1, &G1, &B1);
+  *R = _mm_packus_epi16(R0, R1);
+  *G = _mm_packus_epi16(G0, G1);
+  *B = _mm_packus_epi16(B0, B1);
+}
+
+// Interleaves the 4 channels of 16 pixels, in the c0 c1 c2 c3 byte order.
+static WEBP_INLINE void Store4Channels(const __m128i c0, const __m128i c1,
+                                       const __m128i c2, const __m128i c3,
+                                       uint8_t* dst) {
+  const __m128i c01_lo = _mm_unpacklo_epi8(c0, c1);
+  const __m128i c01_hi = _mm_unpackhi_epi8(c0, c1);
+  const __m128i c23_lo = _mm_unpacklo_epi8(c2, c3);
+  const __m128i c23_hi = _mm_unpackhi_epi8(c2, c3);
+  _mm_storeu_si128((__m128i*)(dst +  0), _mm_unpacklo_epi16(c01_lo, c23_lo));
+  _mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(c01_lo, c23_lo));
+  _mm_storeu_si128((__m128i*)(dst + 32), _mm_unpacklo_epi16(c01_hi, c23_hi));
+  _mm_storeu_si128((__m128i*)(dst + 48), _mm_unpackhi_epi16(c01_hi, c23_hi));
+}
+
+#define ROW_FUNC(FUNC_NAME, FUNC, C0, C1, C2, C3)                              \
+static void FUNC_NAME(const uint8_t* y,                                        \
+                      const uint8_t* u, const uint8_t* v,                      \
+                      uint8_t* dst, int len) {                                 \
+  const __m128i A = _mm_set1_epi8((char)0xff);                                 \
+  int n;                                                                       \
+  for (n = 0; n + 16 <= len; n += 16) {                                        \
+    __m128i R, G, B;                                                           \
+    YuvToRgb16(y, u, v, &R, &G, &B);                                           \
+    Store4Channels(C0, C1, C2, C3, dst);                                       \
+    y += 16;                                                                   \
+    u += 8;                                                                    \
+    v += 8;                                                                    \
+    dst += 64;                                                                 \
+  }                                                                            \
+  for (; n + 1 < len; n += 2) {                                                \
+    FUNC(y[0], u[0], v[0], dst);                                               \
+    FUNC(y[1], u[0], v[0], dst + 4);                                           \
+    y += 2;                                                                    \
+    ++u;                                                                       \
+    ++v;                                                                       \
+    dst += 8;                                                                  \
+  }                                                                            \
+  if (len & 1) {                                                               \
+    FUNC(y[0], u[0], v[0], dst);                                               \
+  }                                                                            \
+}
+
+ROW_FUNC(YuvToRgbaRow, VP8YuvToRgba, R, G, B, A)
+ROW_FUNC(YuvToBgraRow, VP8YuvToBgra, B, G, R, A)
+ROW_FUNC(YuvToArgbRow, VP8YuvToArgb, A, R, G, B)
+
+#undef ROW_FUNC
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void WebPInitSamplersSSE2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void WebPInitSamplersSSE2(void) {
+  WebPSamplers[MODE_RGBA] = YuvToRgbaRow;
+  WebPSamplers[MODE_BGRA] = YuvToBgraRow;
+  WebPSamplers[MODE_ARGB] = YuvToArgbRow;
+  WebPSamplers[MODE_rgbA] = YuvToRgbaRow;
+  WebPSamplers[MODE_bgrA] = YuvToBgraRow;
+  WebPSamplers[MODE_Argb] = YuvToArgbRow;
+}
+
+#else  // !WEBP_USE_SSE2 || WEBP_YUV_USE_TABLE
+
+WEBP_DSP_INIT_STUB(WebPInitSamplersSSE2)
+
+#endif  // WEBP_USE_SSE2 && !WEBP_YUV_USE_TABLE
@@ -33,14 +33,14 @@ void WebpLoader::clear()
 }
 
 
-void WebpLoader::run(unsigned tid)
+void WebpLoader::run(TVG_UNUSED unsigned tid)
 {
-    if (surface.cs == ColorSpace::ARGB8888 || surface.cs == ColorSpace::ARGB8888S) {
-        surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
-        surface.cs = ColorSpace::ARGB8888;
-    } else  {
+    if (target == ColorSpace::ABGR8888 || target == ColorSpace::ABGR8888S) {
         surface.buf8 = WebPDecodeRGBA(data, size, nullptr, nullptr);
         surface.cs = ColorSpace::ABGR8888;
+    } else  {
+        surface.buf8 = WebPDecodeBGRA(data, size, nullptr, nullptr);
+        surface.cs = ColorSpace::ARGB8888;
     }
 
     surface.stride = static_cast<uint32_t>(w);
@@ -138,9 +138,8 @@ bool WebpLoader::read()
 
     if (!data || w == 0 || h == 0) return false;
 
-    surface.cs = ImageLoader::cs;
-
-    TaskScheduler::request(this);
+    //decode it in the background if the target colorspace is known already
+    decode(this, ImageLoader::cs, false);
 
     return true;
 }
@@ -154,9 +153,9 @@ bool WebpLoader::close()
 }
 
 
-RenderSurface* WebpLoader::bitmap()
+RenderSurface* WebpLoader::bitmap(ColorSpace cs)
 {
-    this->done();
-
-    return ImageLoader::bitmap();
+    //otherwise, decode it in the colorspace of the first request
+    decode(this, cs, true);
+    return ImageLoader::bitmap(cs);
 }
\ No newline at end of file
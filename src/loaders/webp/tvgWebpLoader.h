@@ -42,7 +42,7 @@ public:
     bool read() override;
     bool close() override;
 
-    RenderSurface* bitmap() override;
+    RenderSurface* bitmap(ColorSpace cs) override;
 };
 
 #endif //_TVG_WEBP_LOADER_H_
\ No newline at end of file
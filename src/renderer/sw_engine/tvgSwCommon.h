@@ -261,6 +261,7 @@ struct SwImage
     int32_t      oy = 0;         //offset y
     float        scale;
     uint8_t      channelSize;
+    uint8_t      lod = 0;         //mipmap level, the data is the source image halved lod times
 
     bool         direct = false;  //draw image directly (with offset)
     bool         scaled = false;  //draw scaled image
@@ -683,6 +684,7 @@ bool imageGenRle(SwImage* image, const RenderRegion& bbox, bool antiAlias);
 void imageDelOutline(SwImage* image, SwMpool* mpool, uint32_t tid);
 void imageReset(SwImage* image);
 void imageFree(SwImage* image);
+void imageHalve(const uint32_t* src, uint32_t stride, uint32_t w, uint32_t h, uint32_t* dst);
 
 bool fillGenColorTable(SwFill* fill, const Fill* fdata, const Matrix& transform, SwSurface* surface, uint8_t opacity, bool ctable);
 const Fill::ColorStop* fillFetchSolid(const SwFill* fill, const Fill* fdata);
@@ -706,6 +708,7 @@ SwRle* rleRender(SwRle* rle, const SwOutline* outline, const RenderRegion& bbox,
 SwRle* rleRender(const RenderRegion* bbox);
 void rleFree(SwRle* rle);
 void rleReset(SwRle* rle);
+void rleTranslate(SwRle* rle, int32_t x, int32_t y);
 void rleMerge(SwRle* rle, SwRle* clip1, SwRle* clip2);
 bool rleClip(SwRle* rle, const SwRle* clip);
 bool rleClip(SwRle* rle, const RenderRegion* clip);
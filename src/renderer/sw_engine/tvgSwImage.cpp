@@ -120,3 +120,25 @@ void imageFree(SwImage* image)
 {
     rleFree(image->rle);
 }
+
+
+//2x2 box filter, the dst size is ((w + 1) / 2) x ((h + 1) / 2) and the odd edges are repeated.
+void imageHalve(const uint32_t* src, uint32_t stride, uint32_t w, uint32_t h, uint32_t* dst)
+{
+    auto dw = (w + 1) / 2;
+    auto dh = (h + 1) / 2;
+
+    for (uint32_t y = 0; y < dh; ++y) {
+        auto row0 = src + (y * 2) * stride;
+        auto row1 = (y * 2 + 1 < h) ? row0 + stride : row0;
+        for (uint32_t x = 0; x < dw; ++x, ++dst) {
+            auto x0 = x * 2;
+            auto x1 = (x0 + 1 < w) ? x0 + 1 : x0;
+            auto p0 = row0[x0], p1 = row0[x1], p2 = row1[x0], p3 = row1[x1];
+            //sum up the two channel pairs in parallel, each channel fits in 10 bits.
+            auto rb = (p0 & 0x00ff00ff) + (p1 & 0x00ff00ff) + (p2 & 0x00ff00ff) + (p3 & 0x00ff00ff) + 0x00020002;
+            auto ag = ((p0 >> 8) & 0x00ff00ff) + ((p1 >> 8) & 0x00ff00ff) + ((p2 >> 8) & 0x00ff00ff) + ((p3 >> 8) & 0x00ff00ff) + 0x00020002;
+            *dst = ((rb >> 2) & 0x00ff00ff) | (((ag >> 2) & 0x00ff00ff) << 8);
+        }
+    }
+}
@@ -252,6 +252,24 @@ static inline uint32_t _sampleSize(float scale)
 }
 
 
+//Map the inverse transform onto the mipmap level of the image
+static inline SwImage _lod(const SwImage& image, Matrix& itransform)
+{
+    auto level = image;
+    if (image.lod > 0) {
+        auto s = 1.0f / static_cast<float>(1 << image.lod);
+        itransform.e11 *= s;
+        itransform.e12 *= s;
+        itransform.e13 *= s;
+        itransform.e21 *= s;
+        itransform.e22 *= s;
+        itransform.e23 *= s;
+        level.scale /= s;
+    }
+    return level;
+}
+
+
 //Bilinear Interpolation
 //OPTIMIZE_ME: Skip the function pointer access
 static uint32_t _interpUpScaler(const uint32_t *img, TVG_UNUSED uint32_t stride, uint32_t w, uint32_t h, float sx, float sy, TVG_UNUSED int32_t miny, TVG_UNUSED int32_t maxy, TVG_UNUSED int32_t n)
@@ -1580,13 +1598,15 @@ bool rasterScaledImage(SwSurface* surface, const SwImage& image, const Matrix& t
 
     if (!inverse(&transform, &itransform)) return true;
 
+    auto level = _lod(image, itransform);
+
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterScaledMattedImage(surface, image, &itransform, bbox, opacity);
-        else return _rasterScaledMaskedImage(surface, image, &itransform, bbox, opacity);
+        if (_matting(surface)) return _rasterScaledMattedImage(surface, level, &itransform, bbox, opacity);
+        else return _rasterScaledMaskedImage(surface, level, &itransform, bbox, opacity);
     } else if (_blending(surface)) {
-        return _rasterScaledBlendingImage(surface, image, &itransform, bbox, opacity);
+        return _rasterScaledBlendingImage(surface, level, &itransform, bbox, opacity);
     } else {
-        return _rasterScaledImage(surface, image, &itransform, bbox, opacity);
+        return _rasterScaledImage(surface, level, &itransform, bbox, opacity);
     }
     return false;
 }
@@ -1623,13 +1643,15 @@ bool rasterScaledRleImage(SwSurface* surface, const SwImage& image, const Matrix
 
     if (!inverse(&transform, &itransform)) return true;
 
+    auto level = _lod(image, itransform);
+
     if (_compositing(surface)) {
-        if (_matting(surface)) return _rasterScaledMattedRleImage(surface, image, &itransform, bbox, opacity);
-        else return _rasterScaledMaskedRleImage(surface, image, &itransform, bbox, opacity);
+        if (_matting(surface)) return _rasterScaledMattedRleImage(surface, level, &itransform, bbox, opacity);
+        else return _rasterScaledMaskedRleImage(surface, level, &itransform, bbox, opacity);
     } else if (_blending(surface)) {
-        return _rasterScaledBlendingRleImage(surface, image, &itransform, bbox, opacity);
+        return _rasterScaledBlendingRleImage(surface, level, &itransform, bbox, opacity);
     } else {
-        return _rasterScaledRleImage(surface, image, &itransform, bbox, opacity);
+        return _rasterScaledRleImage(surface, level, &itransform, bbox, opacity);
     }
     return false;
 }
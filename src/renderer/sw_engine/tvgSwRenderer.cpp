@@ -75,6 +75,8 @@ struct SwShapeTask : SwTask
 {
     SwShape shape;
     const RenderShape* rshape = nullptr;
+    Matrix rasterized;          //the transform of the current rle
+    RenderRegion rasterBox;     //the clipping region of the current rle
     bool clipper = false;
 
     /* We assume that if the stroke width is greater than 2,
@@ -99,6 +101,35 @@ struct SwShapeTask : SwTask
         return (width * sqrt(transform.e11 * transform.e11 + transform.e12 * transform.e12));
     }
 
+    /* The text labels are often just moved around. If the text is moved by whole pixels
+       without any other changes, the rasterized spans are still valid at the new spot. */
+    bool translate()
+    {
+        if (!rshape->text || flags != RenderUpdateFlag::Transform || clipper || clips.count > 0) return false;
+        if (!shape.rle || shape.rle->spans.empty() || shape.fastTrack || shape.strokeRle || rshape->fill) return false;
+        if (transform.e11 != rasterized.e11 || transform.e12 != rasterized.e12 || transform.e21 != rasterized.e21 || transform.e22 != rasterized.e22) return false;
+
+        auto dx = transform.e13 - rasterized.e13;
+        auto dy = transform.e23 - rasterized.e23;
+        if (dx != nearbyintf(dx) || dy != nearbyintf(dy)) return false;
+
+        //the spans must not be clipped by the region at both the old and the new spots.
+        auto inside = [](const RenderRegion& box, const RenderRegion& clip) {
+            return box.min.x > clip.min.x && box.min.y > clip.min.y && box.max.x < clip.max.x && box.max.y < clip.max.y;
+        };
+        auto x = static_cast<int32_t>(dx);
+        auto y = static_cast<int32_t>(dy);
+        RenderRegion box = {{shape.bbox.min.x + x, shape.bbox.min.y + y}, {shape.bbox.max.x + x, shape.bbox.max.y + y}};
+        if (!inside(shape.bbox, rasterBox) || !inside(box, curBox)) return false;
+
+        rleTranslate(shape.rle, x, y);
+        rasterized = transform;
+        rasterBox = curBox;
+        shape.bbox = curBox = box;
+        if (!nodirty) dirtyRegion->add(prvBox, curBox);
+        return true;
+    }
+
     bool clip(SwRle* target) override
     {
         if (shape.strokeRle) return rleClip(target, shape.strokeRle);
@@ -115,6 +146,8 @@ struct SwShapeTask : SwTask
             return;
         }
 
+        if (translate()) return;
+
         auto strokeWidth = validStrokeWidth(clipper);
         RenderRegion renderBox{};
         auto updateShape = flags & (RenderUpdateFlag::Path | RenderUpdateFlag::Transform | RenderUpdateFlag::Clip);
@@ -127,6 +160,8 @@ struct SwShapeTask : SwTask
             if (updateFill || clipper) {
                 if (shapePrepare(&shape, rshape, transform, curBox, renderBox, mpool, tid, clips.count > 0 ? true : false)) {
                     if (!shapeGenRle(&shape, rshape, antialiasing(strokeWidth))) goto err;
+                    rasterized = transform;
+                    rasterBox = curBox;
                 } else {
                     updateFill = false;
                     renderBox.reset();
@@ -196,6 +231,57 @@ struct SwImageTask : SwTask
         return true;
     }
 
+    /* The downscaler samples a wider area of the source image as the scale gets smaller.
+       Instead, let it sample the level that is close to the scale with a small kernel.
+       The levels are kept in the source surface, so the images of the same source share them. */
+    void lod()
+    {
+        if (!image.scaled || image.direct || image.channelSize != sizeof(uint32_t)) return;
+
+        auto scale = image.scale;
+        uint8_t lod = 0;
+        while (scale <= 0.25f && (source->w >> (lod + 1)) > 0 && (source->h >> (lod + 1)) > 0) {
+            scale *= 2.0f;
+            ++lod;
+        }
+        if (lod == 0) return;
+
+        ScopedLock lock(source->key);
+
+        //the pixels are replaced or converted in place
+        auto& mipmap = source->mipmap;
+        if (mipmap.data != source->data || mipmap.cs != source->cs || mipmap.premultiplied != source->premultiplied) {
+            ARRAY_FOREACH(p, mipmap.levels) tvg::free(*p);
+            mipmap.levels.clear();
+            mipmap.data = source->data;
+            mipmap.cs = source->cs;
+            mipmap.premultiplied = source->premultiplied;
+        }
+
+        auto data = source->buf32;
+        auto w = source->w;
+        auto h = source->h;
+        auto stride = source->stride;
+
+        for (uint32_t i = 0; i < lod; ++i) {
+            if (i == mipmap.levels.count) {
+                auto level = tvg::malloc<uint32_t*>(((w + 1) / 2) * ((h + 1) / 2) * sizeof(uint32_t));
+                imageHalve(data, stride, w, h, level);
+                mipmap.levels.push(level);
+            }
+            data = mipmap.levels[i];
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+            stride = w;
+        }
+
+        image.buf32 = data;
+        image.w = w;
+        image.h = h;
+        image.stride = stride;
+        image.lod = lod;
+    }
+
     void run(unsigned tid) override
     {
         //invisible
@@ -215,6 +301,7 @@ struct SwImageTask : SwTask
         image.h = source->h;
         image.stride = source->stride;
         image.channelSize = source->channelSize;
+        image.lod = 0;
 
         //Invisible shape turned to visible by alpha.
         if ((flags & (RenderUpdateFlag::Image | RenderUpdateFlag::Transform | RenderUpdateFlag::Color)) && (opacity > 0)) {
@@ -230,11 +317,14 @@ struct SwImageTask : SwTask
                         auto clipper = static_cast<SwTask*>(*p);
                         if (!clipper->clip(image.rle)) goto err;
                     }
+                    lod();
                     if (!nodirty) dirtyRegion->add(prvBox, curBox);
                     return;
                 }
             }
         }
+        //the mipmap levels are built only for the visible image
+        if (curBox.valid()) lod();
         goto end;
     err:
         curBox.reset();
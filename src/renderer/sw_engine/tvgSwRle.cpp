@@ -868,6 +868,16 @@ void rleReset(SwRle* rle)
 }
 
 
+void rleTranslate(SwRle* rle, int32_t x, int32_t y)
+{
+    if (!rle) return;
+    ARRAY_FOREACH(p, rle->spans) {
+        p->x += x;
+        p->y += y;
+    }
+}
+
+
 void rleFree(SwRle* rle)
 {
     delete(rle);
@@ -27,6 +27,8 @@
 #include "tvgCommon.h"
 #include "tvgRender.h"
 #include "tvgInlist.h"
+#include "tvgLock.h"
+#include "tvgTaskScheduler.h"
 
 
 struct LoadModule
@@ -39,7 +41,7 @@ struct LoadModule
 
     FileType type;                                  //current loader file type
     atomic<uint16_t> sharing{};                     //reference count
-    bool readied = false;                           //read done already.
+    atomic<bool> readied{};                         //read done already. the cached loader can be read by the threads at once
     bool cached = false;                            //cached for sharing
 
     LoadModule(FileType type) : type(type) {}
@@ -67,9 +69,7 @@ struct LoadModule
 
     virtual bool read()
     {
-        if (readied) return false;
-        readied = true;
-        return true;
+        return !readied.exchange(true);
     }
 
     virtual bool close()
@@ -83,17 +83,52 @@ struct LoadModule
 
 struct ImageLoader : LoadModule
 {
-    static atomic<ColorSpace> cs;                   //desired value
+    static atomic<ColorSpace> cs;                   //the colorspace of the recent canvas target, just a hint for the early decoding
 
     float w = 0, h = 0;                             //default image size
     RenderSurface surface;
+    Key key;                                        //guards the decoding request
+    ColorSpace target = ColorSpace::Unknown;        //the colorspace to decode in
+    uint8_t shrink = 0;                             //the surface is reduced to 1/2^shrink of the image size
+    bool requested = false;                         //the decoding is requested already
 
     ImageLoader(FileType type) : LoadModule(type) {}
 
     virtual bool animatable() { return false; }  //true if this loader supports animation.
     virtual Paint* paint() { return nullptr; }
+    virtual uint8_t reduction(TVG_UNUSED float w, TVG_UNUSED float h) const { return 0; }  //the shrink for the desired size, if the loader can decode a reduced surface.
 
-    virtual RenderSurface* bitmap()
+    //the power of 2 reduction (up to 1/2^max) of the image which still covers the desired size
+    uint8_t cover(float w, float h, uint8_t max) const
+    {
+        if (this->w <= 0.0f || this->h <= 0.0f) return 0;
+        auto scale = std::min(w / this->w, h / this->h);
+        uint8_t n = 0;
+        while (n < max && scale * static_cast<float>(2 << n) <= 1.0f) ++n;
+        return n;
+    }
+
+    //start the decoding task once in the given colorspace. wait for it to finish if required
+    void decode(Task* task, ColorSpace cs, bool wait)
+    {
+        ScopedLock lock(key);
+        if (!requested) {
+            if (!wait && cs == ColorSpace::Unknown) return;
+            requested = true;
+            target = cs;
+            //the caller waits for it anyway, run it here so that the decoder can spread over the workers
+            if (wait) {
+                auto async = TaskScheduler::async(false);
+                TaskScheduler::request(task);
+                TaskScheduler::async(async);
+            } else TaskScheduler::request(task);
+        }
+        //the waiters are serialized by the key since the task notifies only one
+        if (wait) task->done();
+    }
+
+    //the decoded image, in the desired colorspace and premultiplied if the loader supports it. (unknown: the loader's choice)
+    virtual RenderSurface* bitmap(TVG_UNUSED ColorSpace cs)
     {
         if (surface.data) return &surface;
         return nullptr;
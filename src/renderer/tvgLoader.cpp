@@ -62,8 +62,7 @@ uintptr_t HASH_KEY(const char* data)
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
-//TODO: remove it.
-atomic<ColorSpace> ImageLoader::cs{ColorSpace::ARGB8888};
+atomic<ColorSpace> ImageLoader::cs{ColorSpace::Unknown};
 
 static Key _key;
 static Inlist<LoadModule> _activeLoaders;
@@ -166,7 +165,7 @@ static LoadModule* _findByPath(const char* filename)
     if (!ext) return nullptr;
 
     if (!strcmp(ext, "svg")) return _find(FileType::Svg);
-    if (!strcmp(ext, "lot") || !strcmp(ext, "json")) return _find(FileType::Lot);
+    if (!strcmp(ext, "lot") || !strcmp(ext, "json") || !strcmp(ext, "lotb")) return _find(FileType::Lot);
     if (!strcmp(ext, "png")) return _find(FileType::Png);
     if (!strcmp(ext, "jpg")) return _find(FileType::Jpg);
     if (!strcmp(ext, "webp")) return _find(FileType::Webp);
@@ -202,11 +201,29 @@ static LoadModule* _findByType(const char* mimeType)
 }
 
 
-static LoadModule* _findFromCache(const char* filename)
+//the image reduced by the size hint serves the ones requesting the same reduction only
+static bool _shareable(LoadModule* loader, const Point* hint)
+{
+    if (loader->type == FileType::Ttf) return true;
+    auto image = static_cast<ImageLoader*>(loader);
+    return image->shrink == (hint ? image->reduction(hint->x, hint->y) : 0);
+}
+
+
+//the reduction must be decided before the loader is shared through the cache
+static void _hint(LoadModule* loader, const Point* hint)
+{
+    if (!hint) return;
+    auto image = static_cast<ImageLoader*>(loader);
+    image->shrink = image->reduction(hint->x, hint->y);
+}
+
+
+static LoadModule* _findFromCache(const char* filename, const Point* hint = nullptr)
 {
     ScopedLock lock(_key);
     INLIST_FOREACH(_activeLoaders, loader) {
-        if (loader->cached && loader->hashpath && !strcmp(loader->hashpath, filename)) {
+        if (loader->cached && loader->hashpath && !strcmp(loader->hashpath, filename) && _shareable(loader, hint)) {
             ++loader->sharing;
             return loader;
         }
@@ -215,7 +232,7 @@ static LoadModule* _findFromCache(const char* filename)
 }
 
 
-static LoadModule* _findFromCache(const char* data, uint32_t size, const char* mimeType)
+static LoadModule* _findFromCache(const char* data, uint32_t size, const char* mimeType, const Point* hint = nullptr)
 {
     auto type = _convert(mimeType);
     if (type == FileType::Unknown) return nullptr;
@@ -225,7 +242,7 @@ static LoadModule* _findFromCache(const char* data, uint32_t size, const char* m
     ScopedLock lock(_key);
 
     INLIST_FOREACH(_activeLoaders, loader) {
-        if (loader->type == type && loader->hashkey == key) {
+        if (loader->type == type && loader->hashkey == key && _shareable(loader, hint)) {
             ++loader->sharing;
             return loader;
         }
@@ -241,6 +258,8 @@ static LoadModule* _findFromCache(const char* data, uint32_t size, const char* m
 
 bool LoaderMgr::init()
 {
+    //no canvas targeted yet
+    ImageLoader::cs = ColorSpace::Unknown;
     return true;
 }
 
@@ -262,17 +281,19 @@ bool LoaderMgr::retrieve(LoadModule* loader)
 {
     if (!loader) return false;
 
-    if (loader->close()) {
-        if (loader->cached) {
-            _activeLoaders.remove(loader);
-        }
-        delete(loader);
+    //the other threads could find the cached loader meanwhile
+    auto ret = false;
+    {
+        ScopedLock lock(_key);
+        ret = loader->close();
+        if (ret && loader->cached) _activeLoaders.remove(loader);
     }
+    if (ret) delete(loader);
     return true;
 }
 
 
-LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
+LoadModule* LoaderMgr::loader(const char* filename, bool* invalid, const Point* hint)
 {
 #ifdef THORVG_FILE_IO_SUPPORT
     *invalid = false;
@@ -280,14 +301,15 @@ LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
     //TODO: svg & lottie is not sharable.
     auto allowCache = true;
     auto ext = fileext(filename);
-    if (ext && (!strcmp(ext, "svg") || !strcmp(ext, "json") || !strcmp(ext, "lot"))) allowCache = false;
+    if (ext && (!strcmp(ext, "svg") || !strcmp(ext, "json") || !strcmp(ext, "lot") || !strcmp(ext, "lotb"))) allowCache = false;
 
     if (allowCache) {
-        if (auto loader = _findFromCache(filename)) return loader;
+        if (auto loader = _findFromCache(filename, hint)) return loader;
     }
 
     if (auto loader = _findByPath(filename)) {
         if (loader->open(filename)) {
+            _hint(loader, hint);
             if (allowCache) {
                 loader->cache(duplicate(filename));
                 {
@@ -303,6 +325,7 @@ LoadModule* LoaderMgr::loader(const char* filename, bool* invalid)
     for (int i = 0; i < static_cast<int>(FileType::Raw); i++) {
         if (auto loader = _find(static_cast<FileType>(i))) {
             if (loader->open(filename)) {
+                _hint(loader, hint);
                 if (allowCache) {
                     loader->cache(duplicate(filename));
                     {
@@ -327,7 +350,7 @@ bool LoaderMgr::retrieve(const char* filename)
 }
 
 
-LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy)
+LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy, const Point* hint)
 {
     //Note that users could use the same data pointer with the different content.
     //Thus caching is only valid for shareable.
@@ -340,13 +363,14 @@ LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeT
     }
 
     if (allowCache) {
-        if (auto loader = _findFromCache(data, size, mimeType)) return loader;
+        if (auto loader = _findFromCache(data, size, mimeType, hint)) return loader;
     }
 
     //Try with the given MimeType
     if (mimeType) {
         if (auto loader = _findByType(mimeType)) {
             if (loader->open(data, size, rpath, copy)) {
+                _hint(loader, hint);
                 if (allowCache) {
                     loader->cache(HASH_KEY(data));
                     ScopedLock lock(_key);
@@ -364,6 +388,7 @@ LoadModule* LoaderMgr::loader(const char* data, uint32_t size, const char* mimeT
         auto loader = _find(static_cast<FileType>(i));
         if (loader) {
             if (loader->open(data, size, rpath, copy)) {
+                _hint(loader, hint);
                 if (allowCache) {
                     loader->cache(HASH_KEY(data));
                     ScopedLock lock(_key);
@@ -29,8 +29,8 @@ struct LoaderMgr
 {
     static bool init();
     static bool term();
-    static LoadModule* loader(const char* filename, bool* invalid);
-    static LoadModule* loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy);
+    static LoadModule* loader(const char* filename, bool* invalid, const Point* hint = nullptr);
+    static LoadModule* loader(const char* data, uint32_t size, const char* mimeType, const char* rpath, bool copy, const Point* hint = nullptr);
     static LoadModule* loader(const uint32_t* data, uint32_t w, uint32_t h, ColorSpace cs, bool copy);
     static LoadModule* loader(const char* name, const char* data, uint32_t size, const char* mimeType, bool copy);
     static LoadModule* font(const char* name);
@@ -83,12 +83,12 @@ struct PictureImpl : Picture
 
     bool update(RenderMethod* renderer, const Matrix& transform, Array<RenderData>& clips, uint8_t opacity, RenderUpdateFlag flag, TVG_UNUSED bool clipper)
     {
-        load();
+        load(renderer->colorSpace());
 
         if (bitmap) {
             //Overriding Transformation by the desired image size
-            auto sx = w / loader->w;
-            auto sy = h / loader->h;
+            auto sx = w / static_cast<float>(bitmap->w);
+            auto sy = h / static_cast<float>(bitmap->h);
             auto scale = sx < sy ? sx : sy;
             auto m = transform * Matrix{scale, 0, 0, 0, scale, 0, 0, 0, 1};
             impl.rd = renderer->prepare(bitmap, impl.rd, m, clips, opacity, flag);
@@ -128,12 +128,19 @@ struct PictureImpl : Picture
         return Result::Success;
     }
 
+    //the size given in advance lets the image loader decode a reduced surface close to it.
+    bool hinted() const
+    {
+        return resizing && w > 0.0f && h > 0.0f;
+    }
+
     Result load(const char* filename)
     {
         if (vector || bitmap) return Result::InsufficientCondition;
 
         bool invalid;  //Invalid Path
-        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(filename, &invalid));
+        Point hint = {w, h};
+        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(filename, &invalid, hinted() ? &hint : nullptr));
         if (!loader) {
             if (invalid) return Result::InvalidArguments;
             return Result::NonSupport;
@@ -145,7 +152,8 @@ struct PictureImpl : Picture
     {
         if (!data || size <= 0) return Result::InvalidArguments;
         if (vector || bitmap) return Result::InsufficientCondition;
-        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(data, size, mimeType, rpath, copy));
+        Point hint = {w, h};
+        auto loader = static_cast<ImageLoader*>(LoaderMgr::loader(data, size, mimeType, rpath, copy, hinted() ? &hint : nullptr));
         if (!loader) return Result::NonSupport;
         return load(loader);
     }
@@ -200,7 +208,10 @@ struct PictureImpl : Picture
         //Try it, If not loaded yet.
         load();
 
-        if (loader) {
+        if (bitmap) {
+            if (w) *w = bitmap->w;
+            if (h) *h = bitmap->h;
+        } else if (loader) {
             if (w) *w = static_cast<uint32_t>(loader->w);
             if (h) *h = static_cast<uint32_t>(loader->h);
         } else {
@@ -211,7 +222,8 @@ struct PictureImpl : Picture
         else return nullptr;
     }
 
-    void load()
+    //cs: the colorspace of the target renderer, the bitmap is decoded in it at the first request
+    void load(ColorSpace cs = ColorSpace::Unknown)
     {
         if (loader) {
             if (vector) {
@@ -227,7 +239,7 @@ struct PictureImpl : Picture
                     resizing = false;
                 }
             } else if (!bitmap) {
-                bitmap = loader->bitmap();
+                bitmap = loader->bitmap(cs);
             }
         }
     }
@@ -285,8 +297,10 @@ struct PictureImpl : Picture
 
         if (!loader->read()) return Result::Unknown;
 
-        this->w = loader->w;
-        this->h = loader->h;
+        if (!hinted()) {
+            this->w = loader->w;
+            this->h = loader->h;
+        }
 
         impl.mark(RenderUpdateFlag::All);
 
@@ -67,10 +67,23 @@ struct RenderSurface
     uint8_t channelSize = 0;
     bool premultiplied = false;         //Alpha-premultiplied
 
+    //the box filtered levels of the image for the large downscaling, shared by the draws of this surface
+    struct {
+        Array<uint32_t*> levels;        //the image halved once, twice, ...
+        const void* data = nullptr;     //the pixels the levels are made of
+        ColorSpace cs = ColorSpace::Unknown;
+        bool premultiplied = false;
+    } mipmap;
+
     RenderSurface()
     {
     }
 
+    ~RenderSurface()
+    {
+        ARRAY_FOREACH(p, mipmap.levels) tvg::free(*p);
+    }
+
     RenderSurface(const RenderSurface* rhs)
     {
         data = rhs->data;
@@ -332,6 +345,7 @@ struct RenderShape
     RenderColor color{};
     RenderStroke *stroke = nullptr;
     FillRule rule = FillRule::NonZero;
+    bool text = false;      //the glyph outlines of a text
 
     ~RenderShape()
     {
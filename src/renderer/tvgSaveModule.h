@@ -28,6 +28,19 @@
 namespace tvg
 {
 
+//the user function receiving the saved data in order, instead of a file
+struct SaveWriter
+{
+    std::function<bool(const char* buffer, uint32_t size, void* data)> func = nullptr;
+    void* data = nullptr;
+
+    bool write(const void* buffer, uint32_t size) const
+    {
+        return func(static_cast<const char*>(buffer), size, data);
+    }
+};
+
+
 class SaveModule
 {
 public:
@@ -35,6 +48,7 @@ public:
 
     virtual bool save(Paint* paint, Paint* bg, const char* filename, uint32_t quality) = 0;
     virtual bool save(Animation* animation, Paint* bg, const char* filename, uint32_t quality, uint32_t fps) = 0;
+    virtual bool save(Animation* animation, Paint* bg, const SaveWriter& writer, uint32_t quality, uint32_t fps) = 0;
     virtual bool close() = 0;
 };
 
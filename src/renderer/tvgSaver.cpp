@@ -23,11 +23,15 @@
 #include <cstring>
 #include "tvgCommon.h"
 #include "tvgStr.h"
+#include "tvgArray.h"
 #include "tvgSaveModule.h"
 
 #ifdef THORVG_GIF_SAVER_SUPPORT
     #include "tvgGifSaver.h"
 #endif
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+    #include "tvgLottieSaver.h"
+#endif
 
 /************************************************************************/
 /* Internal Class Implementation                                        */
@@ -37,6 +41,9 @@ struct Saver::Impl
 {
     SaveModule* saveModule = nullptr;
     Paint* bg = nullptr;
+    Array<char> output;           //the saved data in the memory
+    char** buffer = nullptr;      //the user's to receive the output
+    uint32_t* size = nullptr;
 
     ~Impl()
     {
@@ -52,6 +59,12 @@ static SaveModule* _find(FileType type)
         case FileType::Gif: {
 #ifdef THORVG_GIF_SAVER_SUPPORT
             return new GifSaver;
+#endif
+            break;
+        }
+        case FileType::Lot: {
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+            return new LottieSaver;
 #endif
             break;
         }
@@ -67,6 +80,10 @@ static SaveModule* _find(FileType type)
             format = "GIF";
             break;
         }
+        case FileType::Lot: {
+            format = "LOTTIE";
+            break;
+        }
         default: {
             format = "???";
             break;
@@ -81,11 +98,74 @@ static SaveModule* _find(FileType type)
 static SaveModule* _find(const char* filename)
 {
     auto ext = fileext(filename);
-    if (ext && !strcmp(ext, "gif")) return _find(FileType::Gif);
+    if (!ext) return nullptr;
+    if (!strcmp(ext, "gif")) return _find(FileType::Gif);
+    if (!strcmp(ext, "lotb")) return _find(FileType::Lot);
     return nullptr;
 }
 
 
+static SaveModule* _findByType(const char* mimeType)
+{
+    if (!mimeType) return nullptr;
+    if (!strcmp(mimeType, "gif")) return _find(FileType::Gif);
+    if (!strcmp(mimeType, "lotb")) return _find(FileType::Lot);
+    TVGLOG("RENDERER", "Given mimetype is unknown = \"%s\".", mimeType);
+    return nullptr;
+}
+
+
+//write out to the memory, it grows by doubling
+static bool _append(const char* buffer, uint32_t size, void* data)
+{
+    auto output = static_cast<Array<char>*>(data);
+    if (output->count + size > output->reserved) output->reserve((output->count + size) * 2);
+    memcpy(output->end(), buffer, size);
+    output->count += size;
+    return true;
+}
+
+
+//save the animation to the file, or to the writer if it's given
+static Result _save(Saver::Impl* impl, Animation* animation, const char* filename, const SaveWriter* writer, const char* mimeType, uint32_t quality, uint32_t fps)
+{
+    if (!animation) return Result::InvalidArguments;
+
+    //animation holds the picture, it must be 1 at the bottom.
+    auto remove = animation->picture()->refCnt() <= 1 ? true : false;
+
+    if (writer && !writer->func) {
+        if (remove) delete(animation);
+        return Result::InvalidArguments;
+    }
+
+    if (tvg::zero(animation->totalFrame())) {
+        if (remove) delete(animation);
+        return Result::InsufficientCondition;
+    }
+
+    //Already on saving another resource.
+    if (impl->saveModule) {
+        if (remove) delete(animation);
+        return Result::InsufficientCondition;
+    }
+
+    if (auto saveModule = writer ? _findByType(mimeType) : _find(filename)) {
+        auto ret = writer ? saveModule->save(animation, impl->bg, *writer, quality, fps) : saveModule->save(animation, impl->bg, filename, quality, fps);
+        if (ret) {
+            impl->saveModule = saveModule;
+            return Result::Success;
+        } else {
+            if (remove) delete(animation);
+            delete(saveModule);
+            return Result::Unknown;
+        }
+    }
+    if (remove) delete(animation);
+    return Result::NonSupport;
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -140,34 +220,36 @@ Result Saver::background(Paint* paint) noexcept
 
 Result Saver::save(Animation* animation, const char* filename, uint32_t quality, uint32_t fps) noexcept
 {
-    if (!animation) return Result::InvalidArguments;
+    return _save(pImpl, animation, filename, nullptr, nullptr, quality, fps);
+}
 
-    //animation holds the picture, it must be 1 at the bottom.
-    auto remove = animation->picture()->refCnt() <= 1 ? true : false;
 
-    if (tvg::zero(animation->totalFrame())) {
-        if (remove) delete(animation);
-        return Result::InsufficientCondition;
-    }
+Result Saver::save(Animation* animation, std::function<bool(const char* buffer, uint32_t size, void* data)> writer, void* data, const char* mimeType, uint32_t quality, uint32_t fps) noexcept
+{
+    SaveWriter output;
+    output.func = writer;
+    output.data = data;
+    return _save(pImpl, animation, nullptr, &output, mimeType, quality, fps);
+}
 
-    //Already on saving another resource.
-    if (pImpl->saveModule) {
-        if (remove) delete(animation);
-        return Result::InsufficientCondition;
+
+Result Saver::save(Animation* animation, char** buffer, uint32_t* size, const char* mimeType, uint32_t quality, uint32_t fps) noexcept
+{
+    SaveWriter output;
+    if (buffer && size) {
+        output.func = _append;
+        output.data = &pImpl->output;
     }
 
-    if (auto saveModule = _find(filename)) {
-        if (saveModule->save(animation, pImpl->bg, filename, quality, fps)) {
-            pImpl->saveModule = saveModule;
-            return Result::Success;
-        } else {
-            if (remove) delete(animation);
-            delete(saveModule);
-            return Result::Unknown;
-        }
+    //keep the data of the ongoing one
+    if (!pImpl->saveModule) pImpl->output.clear();
+
+    auto ret = _save(pImpl, animation, nullptr, &output, mimeType, quality, fps);
+    if (ret == Result::Success) {
+        pImpl->buffer = buffer;
+        pImpl->size = size;
     }
-    if (remove) delete(animation);
-    return Result::NonSupport;
+    return ret;
 }
 
 
@@ -178,6 +260,17 @@ Result Saver::sync() noexcept
     delete(pImpl->saveModule);
     pImpl->saveModule = nullptr;
 
+    //hand over the data saved in the memory
+    if (pImpl->buffer) {
+        auto& output = pImpl->output;
+        *pImpl->buffer = output.data;
+        *pImpl->size = output.count;
+        output.data = nullptr;
+        output.count = output.reserved = 0;
+        pImpl->buffer = nullptr;
+        pImpl->size = nullptr;
+    }
+
     return Result::Success;
 }
 
@@ -33,6 +33,9 @@ namespace tvg {
 
 #ifdef THORVG_THREAD_SUPPORT
 
+static thread_local bool _async = true;
+static thread_local int32_t _queue = -1;  //the queue of the current worker thread
+
 struct TaskQueue {
     Inlist<Task>             taskDeque;
     mutex                    mtx;
@@ -129,6 +132,7 @@ struct TaskSchedulerImpl
     void run(unsigned i)
     {
         Task* task;
+        _queue = i;
 
         //Thread Loop
         while (true) {
@@ -148,12 +152,17 @@ struct TaskSchedulerImpl
     void request(Task* task)
     {
         //Async
-        if (threads.count > 0) {
+        if (threads.count > 0 && _async) {
             task->prepare();
             auto i = idx++;
+            /* a worker requesting a task likely waits for it, don't leave it
+               in the own queue that nobody might pop in the meantime. */
+            auto skip = (threads.count > 1) ? _queue : -1;
             for (uint32_t n = 0; n < threads.count; ++n) {
-                if (taskQueues[(i + n) % threads.count]->tryPush(task)) return;
+                auto q = (i + n) % threads.count;
+                if (int32_t(q) != skip && taskQueues[q]->tryPush(task)) return;
             }
+            if (int32_t(i % threads.count) == skip) ++i;
             taskQueues[i % threads.count]->push(task);
         //Sync
         } else {
@@ -209,6 +218,18 @@ void TaskScheduler::request(Task* task)
 }
 
 
+bool TaskScheduler::async(TVG_UNUSED bool on)
+{
+#ifdef THORVG_THREAD_SUPPORT
+    auto prev = _async;
+    _async = on;
+    return prev;
+#else
+    return false;
+#endif
+}
+
+
 uint32_t TaskScheduler::threads()
 {
     return _inst ? _inst->threadCnt() : 0;
@@ -112,6 +112,7 @@ struct TaskScheduler
     static void init(uint32_t threads);
     static void term();
     static void request(Task* task);
+    static bool async(bool on);  //toggle the async tasking for the current thread, returns the previous state
     static bool onthread();  //figure out whether on worker thread or not
     static ThreadID tid();
 };
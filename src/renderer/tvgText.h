@@ -45,6 +45,7 @@ struct TextImpl : Text
     TextImpl() : impl(Paint::Impl(this)), shape(Shape::gen())
     {
         PAINT(shape)->parent = this;
+        SHAPE(shape)->rs.text = true;
     }
 
     ~TextImpl()
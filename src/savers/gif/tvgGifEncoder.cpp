@@ -52,6 +52,7 @@
 #define TRANSPARENT_IDX 0
 #define TRANSPARENT_THRESHOLD 127
 #define BIT_DEPTH 8
+#define BLOCK_SIZE (64 * 1024)   // the output is written out in this size at least
 
 
 // Simple structure to write out the LZW-compressed portion of the image
@@ -288,21 +289,21 @@ static int _pickChangedPixels(const uint8_t* lastFrame, uint8_t* frame, int numP
 
 // Creates a palette by placing all the image pixels in a k-d tree and then averaging the blocks at the bottom.
 // This is known as the "modified median split" technique
-static void _makePalette(GifWriter* writer, const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool transparent)
+static void _makePalette(GifFrame* frame, const uint8_t* lastFrame, const uint8_t* nextFrame, uint32_t width, uint32_t height, int bitDepth, bool transparent)
 {
-    auto& pal = writer->pal;
+    auto& pal = frame->pal;
 
     size_t imageSize = (size_t)(width * height * 4 * sizeof(uint8_t));
-    memcpy(writer->tmpImage, nextFrame, imageSize);
+    memcpy(frame->tmpImage, nextFrame, imageSize);
 
     int numPixels = (int)(width * height);
-    if (lastFrame) numPixels = _pickChangedPixels(lastFrame, writer->tmpImage, numPixels, transparent);
+    if (lastFrame) numPixels = _pickChangedPixels(lastFrame, frame->tmpImage, numPixels, transparent);
 
     const int lastElt = 1 << bitDepth;
     const int splitElt = lastElt/2;
     const int splitDist = splitElt/2;
 
-    _splitPalette(writer->tmpImage, numPixels, 1, lastElt, splitElt, splitDist, 1, &pal);
+    _splitPalette(frame->tmpImage, numPixels, 1, lastElt, splitElt, splitDist, 1, &pal);
 
     // add the bottom node for the transparency index
     pal.treeSplit[1 << (bitDepth-1)] = 0;
@@ -326,9 +327,9 @@ void _palettizePixel(const uint8_t* nextFrame, uint8_t* outFrame, GifPalette* pP
 
 
 // Picks palette colors for the image using simple threshholding, no dithering
-static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const uint8_t* nextFrame,  uint32_t width, uint32_t height, bool transparent)
+static void _thresholdImage(GifFrame* frame, const uint8_t* lastFrame, const uint8_t* nextFrame,  uint32_t width, uint32_t height, bool transparent)
 {
-    auto outFrame = writer->oldImage;
+    auto outFrame = frame->image;
     uint32_t numPixels = width*height;
 
     if (transparent) {
@@ -339,7 +340,7 @@ static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const u
                 outFrame[2] = 0;
                 outFrame[3] = TRANSPARENT_IDX;
             } else {
-                _palettizePixel(nextFrame, outFrame, &writer->pal);
+                _palettizePixel(nextFrame, outFrame, &frame->pal);
             }
             if (lastFrame) lastFrame += 4;
             outFrame += 4;
@@ -355,7 +356,7 @@ static void _thresholdImage(GifWriter* writer, const uint8_t* lastFrame, const u
                 outFrame[2] = lastFrame[2];
                 outFrame[3] = TRANSPARENT_IDX;
             } else {
-                _palettizePixel(nextFrame, outFrame, &writer->pal);
+                _palettizePixel(nextFrame, outFrame, &frame->pal);
             }
             if (lastFrame) lastFrame += 4;
             outFrame += 4;
@@ -383,11 +384,13 @@ static void _writeBit(GifBitStatus* stat, uint32_t bit)
 }
 
 
-// write all bytes so far to the file
-static void _writeChunk(FILE* f, GifBitStatus* stat)
+// write all bytes so far to the frame
+static void _writeChunk(Array<uint8_t>& out, GifBitStatus* stat)
 {
-    fputc((int)stat->chunkIndex, f);
-    fwrite(stat->chunk, 1, stat->chunkIndex, f);
+    out.grow(stat->chunkIndex + 1);
+    out.push((uint8_t)stat->chunkIndex);
+    memcpy(out.end(), stat->chunk, stat->chunkIndex);
+    out.count += stat->chunkIndex;
 
     stat->bitIndex = 0;
     stat->byte = 0;
@@ -395,74 +398,173 @@ static void _writeChunk(FILE* f, GifBitStatus* stat)
 }
 
 
-static void _writeCode(FILE* f, GifBitStatus* stat, uint32_t code, uint32_t length)
+static void _writeCode(Array<uint8_t>& out, GifBitStatus* stat, uint32_t code, uint32_t length)
 {
     for (uint32_t ii = 0; ii < length; ++ii) {
         _writeBit(stat, code);
         code = code >> 1;
-        if (stat->chunkIndex == 255) _writeChunk(f, stat);
+        if (stat->chunkIndex == 255) _writeChunk(out, stat);
     }
 }
 
 
-// write a 256-color (8-bit) image palette to the file
-static void _writePalette(const GifPalette* pPal, FILE* f)
+// write a 256-color (8-bit) image palette to the frame
+static void _writePalette(const GifPalette* pPal, Array<uint8_t>& out)
 {
-    fputc(0, f);  // first color: transparency
-    fputc(0, f);
-    fputc(0, f);
+    out.push(0);  // first color: transparency
+    out.push(0);
+    out.push(0);
 
     for (int ii = 1; ii < (1 << BIT_DEPTH); ++ii) {
-        uint32_t r = pPal->r[ii];
-        uint32_t g = pPal->g[ii];
-        uint32_t b = pPal->b[ii];
+        out.push(pPal->r[ii]);
+        out.push(pPal->g[ii]);
+        out.push(pPal->b[ii]);
+    }
+}
+
 
-        fputc((int)r, f);
-        fputc((int)g, f);
-        fputc((int)b, f);
+// find the region of the pixels to be drawn, the others are left to the transparency index.
+// returns false if there is none.
+static bool _drawnRegion(const uint8_t* image, uint32_t width, uint32_t height, uint32_t region[4])
+{
+    uint32_t minX = width, minY = height, maxX = 0, maxY = 0;
+
+    for (uint32_t yy = 0; yy < height; ++yy) {
+        auto row = image + yy * width * 4 + 3;
+        uint32_t xx = 0;
+        while (xx < width && row[xx * 4] == TRANSPARENT_IDX) ++xx;
+        if (xx == width) continue;
+        if (xx < minX) minX = xx;
+        xx = width - 1;
+        while (row[xx * 4] == TRANSPARENT_IDX) --xx;
+        if (xx > maxX) maxX = xx;
+        if (yy < minY) minY = yy;
+        maxY = yy;
     }
+
+    if (minY == height) return false;
+
+    region[0] = minX;
+    region[1] = minY;
+    region[2] = maxX - minX + 1;
+    region[3] = maxY - minY + 1;
+    return true;
+}
+
+
+// write out the data to the file or the user function
+static bool _output(GifWriter* writer, const uint8_t* data, uint32_t size)
+{
+    if (writer->failed) return false;
+    if (writer->f) writer->failed = (fwrite(data, 1, size, writer->f) != size);
+    else writer->failed = !writer->func(data, size, writer->user);
+    return !writer->failed;
+}
+
+
+// write out the pending output
+static bool _flush(GifWriter* writer)
+{
+    auto& out = writer->out;
+    if (out.empty()) return true;
+    auto ret = _output(writer, out.data, out.count);
+    out.clear();
+    return ret;
+}
+
+
+// append the data to the pending output, it's written out once the block is filled up
+static bool _write(GifWriter* writer, const uint8_t* data, uint32_t size)
+{
+    auto& out = writer->out;
+
+    // a large one goes out directly
+    if (size >= BLOCK_SIZE) return _flush(writer) && _output(writer, data, size);
+
+    out.grow(size);
+    memcpy(out.end(), data, size);
+    out.count += size;
+
+    if (out.count < BLOCK_SIZE) return true;
+    return _flush(writer);
 }
 
 
-// write the image header, LZW-compress and write out the image
-static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+static void _writeString(Array<uint8_t>& out, const char* str)
 {
-    auto f = writer->f;
-    auto image = writer->oldImage;
+    while (*str) out.push(*str++);
+}
+
+
+// write the graphics control extension of a frame
+static void _writeControl(Array<uint8_t>& out, uint32_t delay, bool transparent)
+{
+    out.push(0x21);
+    out.push(0xf9);
+    out.push(0x04);
+    out.push((transparent ? 0x09 : 0x05));  //clear prev frame or not.
+    out.push(delay & 0xff);
+    out.push((delay >> 8) & 0xff);
+    out.push(TRANSPARENT_IDX); // transparent color index
+    out.push(0);
+}
+
+
+// write out the last frame once its delay is settled
+static bool _flushFrame(GifWriter* writer)
+{
+    auto& last = writer->last;
+    if (last.empty()) return true;
+
+    // the delay field is 16 bits, repeat the frame for the longer ones
+    auto delay = writer->lastDelay;
+    do {
+        auto cur = (delay > 0xffff) ? 0xffff : delay;
+        _writeControl(writer->out, cur, writer->lastTransparent);
+        if (!_write(writer, last.data, last.count)) return false;
+        delay -= cur;
+    } while (delay > 0);
+
+    last.clear();
+    return true;
+}
+
+
+// write the image header, LZW-compress and write out the region (x, y, w, h) of the image
+static void _writeLzwImage(GifFrame* frame, uint32_t width, const uint32_t region[4])
+{
+    auto& out = frame->data;
 
-    // graphics control extension
-    fputc(0x21, f);
-    fputc(0xf9, f);
-    fputc(0x04, f);
-    fputc((transparent ? 0x09 : 0x05), f);  //clear prev frame or not.
-    fputc(delay & 0xff, f);
-    fputc((delay >> 8) & 0xff, f);
-    fputc(TRANSPARENT_IDX, f); // transparent color index
-    fputc(0, f);
+    out.clear();
 
-    fputc(0x2c, f); // image descriptor block
+    out.push(0x2c); // image descriptor block
 
     // corner of image (left, top) in canvas space
-    fputc(0, f);
-    fputc(0, f);
-    fputc(0, f);
-    fputc(0, f);
+    out.push(region[0] & 0xff);
+    out.push((region[0] >> 8) & 0xff);
+    out.push(region[1] & 0xff);
+    out.push((region[1] >> 8) & 0xff);
+
+    auto height = region[3];
+    auto image = frame->image + (region[1] * width + region[0]) * 4;
+    auto stride = width;
+    width = region[2];
 
-    fputc(width & 0xff, f);          // width and height of image
-    fputc((width >> 8) & 0xff, f);
-    fputc(height & 0xff, f);
-    fputc((height >> 8) & 0xff, f);
+    out.push(width & 0xff);          // width and height of image
+    out.push((width >> 8) & 0xff);
+    out.push(height & 0xff);
+    out.push((height >> 8) & 0xff);
 
     //fputc(0, f); // no local color table, no transparency
     //fputc(0x80, f); // no local color table, but transparency
 
-    fputc(0x80 + BIT_DEPTH - 1, f); // local color table present, 2 ^ bitDepth entries
-    _writePalette(&writer->pal, f);
+    out.push(0x80 + BIT_DEPTH - 1); // local color table present, 2 ^ bitDepth entries
+    _writePalette(&frame->pal, out);
 
     const int minCodeSize = BIT_DEPTH;
     const uint32_t clearCode = 1 << BIT_DEPTH;
 
-    fputc(minCodeSize, f); // min code size 8 bits
+    out.push(minCodeSize); // min code size 8 bits
 
     GifLzwNode* codetree = tvg::malloc<GifLzwNode*>(sizeof(GifLzwNode)*4096);
 
@@ -476,12 +578,12 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
     stat.bitIndex = 0;
     stat.chunkIndex = 0;
 
-    _writeCode(f, &stat, clearCode, codeSize);  // start with a fresh LZW dictionary
+    _writeCode(out, &stat, clearCode, codeSize);  // start with a fresh LZW dictionary
 
     for (uint32_t yy = 0; yy < height; ++yy) {
         for (uint32_t xx=0; xx<width; ++xx) {
             // top-left origin
-            uint8_t nextValue = image[(yy*width+xx)*4+3];
+            uint8_t nextValue = image[(yy*stride+xx)*4+3];
 
             // "loser mode" - no compression, every single code is followed immediately by a clear
             //WriteCode( f, stat, nextValue, codeSize );
@@ -495,7 +597,7 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
                 curCode = codetree[curCode].m_next[nextValue];
             } else {
                 // finish the current run, write a code
-                _writeCode(f, &stat, (uint32_t)curCode, codeSize);
+                _writeCode(out, &stat, (uint32_t)curCode, codeSize);
 
                 // insert the new run into the dictionary
                 codetree[curCode].m_next[nextValue] = (uint16_t)++maxCode;
@@ -507,7 +609,7 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
                 }
                 if (maxCode == 4095) {
                     // the dictionary is full, clear it out and begin anew
-                    _writeCode(f, &stat, clearCode, codeSize); // clear tree
+                    _writeCode(out, &stat, clearCode, codeSize); // clear tree
 
                     memset(codetree, 0, sizeof(GifLzwNode)*4096);
                     codeSize = (uint32_t)(minCodeSize + 1);
@@ -520,20 +622,71 @@ static void _writeLzwImage(GifWriter* writer, uint32_t width, uint32_t height, u
     }
 
     // compression footer
-    _writeCode(f, &stat, (uint32_t)curCode, codeSize);
-    _writeCode(f, &stat, clearCode, codeSize);
-    _writeCode(f, &stat, clearCode + 1, (uint32_t)minCodeSize + 1);
+    _writeCode(out, &stat, (uint32_t)curCode, codeSize);
+    _writeCode(out, &stat, clearCode, codeSize);
+    _writeCode(out, &stat, clearCode + 1, (uint32_t)minCodeSize + 1);
 
     // write out the last partial chunk
     while (stat.bitIndex) _writeBit(&stat, 0);
-    if (stat.chunkIndex) _writeChunk(f, &stat);
+    if (stat.chunkIndex) _writeChunk(out, &stat);
 
-    fputc(0, f); // image block terminator
+    out.push(0); // image block terminator
 
     tvg::free(codetree);
 }
 
 
+// reset the writer and write the header
+static void _begin(GifWriter* writer, uint32_t width, uint32_t height, uint32_t delay)
+{
+    writer->firstFrame = true;
+    writer->failed = false;
+    writer->lastDelay = 0;
+    writer->lastTransparent = false;
+
+    auto& out = writer->out;
+    out.reserve(BLOCK_SIZE * 2);
+    out.clear();
+
+    _writeString(out, "GIF89a");
+
+    // screen descriptor
+    out.push(width & 0xff);
+    out.push((width >> 8) & 0xff);
+    out.push(height & 0xff);
+    out.push((height >> 8) & 0xff);
+
+    out.push(0xf0);  // there is an unsorted global color table of 2 entries
+    out.push(0);     // background color
+    out.push(0);     // pixels are square (we need to specify this because it's 1989)
+
+    // now the "global" palette (really just a dummy palette)
+    // color 0: black
+    out.push(0);
+    out.push(0);
+    out.push(0);
+    // color 1: also black
+    out.push(0);
+    out.push(0);
+    out.push(0);
+
+    if(delay != 0) {
+        // animation header
+        out.push(0x21); // extension
+        out.push(0xff); // application specific
+        out.push(11); // length 11
+        _writeString(out, "NETSCAPE2.0"); // yes, really
+        out.push(3); // 3 bytes of NETSCAPE2.0 data
+
+        out.push(1); // JUST BECAUSE
+        out.push(0); // loop infinitely (byte 0)
+        out.push(0); // loop infinitely (byte 1)
+
+        out.push(0); // block terminator
+    }
+}
+
+
 /************************************************************************/
 /* External Class Implementation                                        */
 /************************************************************************/
@@ -549,79 +702,114 @@ bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t
 #endif
     if (!writer->f) return false;
 
-    writer->firstFrame = true;
+    writer->func = nullptr;
+    writer->user = nullptr;
+
+    _begin(writer, width, height, delay);
 
-    // allocate
-    writer->oldImage = tvg::malloc<uint8_t*>(width*height*4);
-    writer->tmpImage = tvg::malloc<uint8_t*>(width*height*4);
+    return true;
+}
 
-    fputs("GIF89a", writer->f);
 
-    // screen descriptor
-    fputc(width & 0xff, writer->f);
-    fputc((width >> 8) & 0xff, writer->f);
-    fputc(height & 0xff, writer->f);
-    fputc((height >> 8) & 0xff, writer->f);
+bool gifBegin(GifWriter* writer, GifWriteFunc func, void* user, uint32_t width, uint32_t height, uint32_t delay)
+{
+    if (!func) return false;
 
-    fputc(0xf0, writer->f);  // there is an unsorted global color table of 2 entries
-    fputc(0, writer->f);     // background color
-    fputc(0, writer->f);     // pixels are square (we need to specify this because it's 1989)
+    writer->f = NULL;
+    writer->func = func;
+    writer->user = user;
 
-    // now the "global" palette (really just a dummy palette)
-    // color 0: black
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    // color 1: also black
-    fputc(0, writer->f);
-    fputc(0, writer->f);
-    fputc(0, writer->f);
+    _begin(writer, width, height, delay);
 
-    if(delay != 0) {
-        // animation header
-        fputc(0x21, writer->f); // extension
-        fputc(0xff, writer->f); // application specific
-        fputc(11, writer->f); // length 11
-        fputs("NETSCAPE2.0", writer->f); // yes, really
-        fputc(3, writer->f); // 3 bytes of NETSCAPE2.0 data
+    return true;
+}
 
-        fputc(1, writer->f); // JUST BECAUSE
-        fputc(0, writer->f); // loop infinitely (byte 0)
-        fputc(0, writer->f); // loop infinitely (byte 1)
 
-        fputc(0, writer->f); // block terminator
+bool gifWriteFrame(GifWriter* writer, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+{
+    if (!writer->f && !writer->func) return false;
+
+    const uint8_t* oldImage = writer->firstFrame? NULL : writer->frame.image;
+    writer->firstFrame = false;
+
+    if (!gifEncodeFrame(&writer->frame, oldImage, image, width, height, delay, transparent)) return false;
+    return gifWriteFrame(writer, &writer->frame);
+}
+
+
+bool gifEncodeFrame(GifFrame* frame, const uint8_t* lastImage, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+{
+    if (!frame->image) frame->image = tvg::malloc<uint8_t*>(width*height*4);
+    if (!frame->tmpImage) frame->tmpImage = tvg::malloc<uint8_t*>(width*height*4);
+    if (!frame->image || !frame->tmpImage) return false;
+
+    //the unused leaves would keep the colors of any former frame otherwise
+    memset(&frame->pal, 0, sizeof(GifPalette));
+    frame->delay = delay;
+    frame->transparent = transparent;
+
+    _makePalette(frame, lastImage, image, width, height, 8, transparent);
+    _thresholdImage(frame, lastImage, image, width, height, transparent);
+
+    /* crop the frame to the drawn pixels. nothing changed in the opaque mode, just keep
+       showing the last frame. the transparent frame clears the last one at least. */
+    uint32_t region[4] = {0, 0, 1, 1};
+    if (!_drawnRegion(frame->image, width, height, region) && !transparent) {
+        frame->data.clear();
+        return true;
     }
 
+    _writeLzwImage(frame, width, region);
+
     return true;
 }
 
 
-bool gifWriteFrame(GifWriter* writer, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent)
+bool gifWriteFrame(GifWriter* writer, const GifFrame* frame)
 {
-    if (!writer->f) return false;
+    if (!writer->f && !writer->func) return false;
 
-    const uint8_t* oldImage = writer->firstFrame? NULL : writer->oldImage;
-    writer->firstFrame = false;
+    // an empty frame just extends the last one
+    if (frame->data.empty()) {
+        writer->lastDelay += frame->delay;
+        return true;
+    }
+
+    if (!_flushFrame(writer)) return false;
 
-    _makePalette(writer, oldImage, image, width, height, 8, transparent);
-    _thresholdImage(writer, oldImage, image, width, height, transparent);
-    _writeLzwImage(writer, width, height, delay, transparent);
+    writer->last = frame->data;
+    writer->lastDelay = frame->delay;
+    writer->lastTransparent = frame->transparent;
 
     return true;
 }
 
 
+void gifFreeFrame(GifFrame* frame)
+{
+    tvg::free(frame->image);
+    tvg::free(frame->tmpImage);
+    frame->image = frame->tmpImage = nullptr;
+    frame->data.reset();
+}
+
+
 bool gifEnd(GifWriter* writer)
 {
-    if (!writer->f) return false;
+    if (!writer->f && !writer->func) return false;
+
+    auto ret = _flushFrame(writer);
 
-    fputc(0x3b, writer->f); // end of file
-    fclose(writer->f);
-    tvg::free(writer->oldImage);
-    tvg::free(writer->tmpImage);
+    writer->out.push(0x3b); // end of file
+    if (!_flush(writer)) ret = false;
+
+    if (writer->f) fclose(writer->f);
+    gifFreeFrame(&writer->frame);
+    writer->last.reset();
+    writer->out.reset();
 
     writer->f = NULL;
-    writer->oldImage = NULL;
+    writer->func = nullptr;
 
-    return true;
+    return ret;
 }
@@ -25,6 +25,7 @@
 #define TVG_GIF_ENCODER_H
 
 #include "tvgCommon.h"
+#include "tvgArray.h"
 
 typedef struct
 {
@@ -40,13 +41,34 @@ typedef struct
 } GifPalette;
 
 
+// A frame encoded apart from the writer, so that the frames can be encoded on the worker threads.
 typedef struct
 {
-    FILE* f;
-    uint8_t* oldImage;
-    uint8_t* tmpImage;
+    uint8_t* image = nullptr;       // the palettized image, it's the previous image of the next frame
+    uint8_t* tmpImage = nullptr;
     GifPalette pal;
+    Array<uint8_t> data;            // the encoded image of this frame, cropped to the drawn region
+    uint32_t delay = 0;
+    bool transparent = false;
+} GifFrame;
+
+
+// Receives the gif data in order, returns false to stop writing.
+typedef bool (*GifWriteFunc)(const uint8_t* data, uint32_t size, void* user);
+
+
+typedef struct
+{
+    FILE* f;
+    GifWriteFunc func;              // the user function, writes out to it instead of the file
+    void* user;
+    Array<uint8_t> out;             // the pending output, written out in large blocks
+    GifFrame frame;
+    Array<uint8_t> last;            // the last frame is held until the next one settles its delay
+    uint32_t lastDelay;
+    bool lastTransparent;
     bool firstFrame;
+    bool failed;
 } GifWriter;
 
 
@@ -55,14 +77,29 @@ typedef struct
 // The delay value is the time between frames in hundredths of a second - note that not all viewers pay much attention to this value.
 bool gifBegin(GifWriter* writer, const char* filename, uint32_t width, uint32_t height, uint32_t delay);
 
+// Same as above, but the gif data is passed to the func in large blocks.
+bool gifBegin(GifWriter* writer, GifWriteFunc func, void* user, uint32_t width, uint32_t height, uint32_t delay);
+
 // Writes out a new frame to a GIF in progress.
 // The GIFWriter should have been created by GIFBegin.
 // AFAIK, it is legal to use different bit depths for different frames of an image -
 // this may be handy to save bits in animations that don't change much.
 bool gifWriteFrame(GifWriter* writer, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent);
 
+// Encodes a frame into the memory, independently of the writer.
+// The lastImage is the palettized image of the previous frame or null, it can be the image of this frame itself.
+// The frame is cropped to the changed region, or left empty if nothing changed in the opaque mode.
+// The frame buffers are allocated on demand, release them with gifFreeFrame().
+bool gifEncodeFrame(GifFrame* frame, const uint8_t* lastImage, const uint8_t* image, uint32_t width, uint32_t height, uint32_t delay, bool transparent);
+
+// Writes out a frame encoded by gifEncodeFrame(). The frames must be written in order.
+// An empty frame extends the delay of the last one.
+bool gifWriteFrame(GifWriter* writer, const GifFrame* frame);
+
+void gifFreeFrame(GifFrame* frame);
+
 
-// Writes the EOF code, closes the file handle, and frees temp memory used by a GIF.
+// Writes the EOF code, flushes the output, closes the file handle, and frees temp memory used by a GIF.
 // Many if not most viewers will still display a GIF properly if the EOF code is missing,
 // but it's still a good idea to write it out.
 bool gifEnd(GifWriter* writer);
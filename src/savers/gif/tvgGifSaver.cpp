@@ -20,6 +20,7 @@
  * SOFTWARE.
  */
 
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include "tvgStr.h"
@@ -30,18 +31,156 @@
 /* Internal Class Implementation                                        */
 /************************************************************************/
 
+/* Encode a frame on a worker thread, or on the requester if no worker started it yet.
+   The frames are written out in order by the requester. */
+struct GifSaver::EncodeTask : Task
+{
+    GifFrame frame;
+    uint8_t* image = nullptr;           //the rendered frame
+    const uint8_t* last = nullptr;      //the palettized previous frame
+    uint32_t w, h, delay;
+    uint32_t skipped = 0;               //the following frames identical to this
+    bool transparent;
+    bool result = false;
+    atomic<bool> claimed{false};
+    atomic<bool> finished{false};       //popped out of the queue
+    bool requested = false;
+    bool encoded = false;               //not written out yet
+
+    EncodeTask(uint32_t w, uint32_t h, uint32_t delay, bool transparent) : w(w), h(h), delay(delay), transparent(transparent) {}
+
+    ~EncodeTask()
+    {
+        gifFreeFrame(&frame);
+        tvg::free(image);
+    }
+
+    bool encode()
+    {
+        if (claimed.exchange(true)) return false;
+        result = gifEncodeFrame(&frame, last, image, w, h, delay, transparent);
+        return true;
+    }
+
+    bool write(GifWriter* writer)
+    {
+        encoded = false;
+        frame.delay += skipped * delay;
+        skipped = 0;
+        return result && gifWriteFrame(writer, &frame);
+    }
+
+    void request()
+    {
+        claimed = false;
+        finished = false;
+        requested = true;
+        encoded = true;
+        TaskScheduler::request(this);
+    }
+
+    //finish the encoding, it returns the task holding the frame.
+    EncodeTask* sync(Array<EncodeTask*>& retired)
+    {
+        if (!requested) return this;
+        requested = false;
+
+        if (!encode() || finished) {
+            done();
+            return this;
+        }
+
+        //taken over but still in a queue, leave it there and move the frame to a spare one.
+        auto task = spare(retired);
+        task->frame.image = frame.image;
+        task->frame.tmpImage = frame.tmpImage;
+        task->frame.pal = frame.pal;
+        task->frame.delay = frame.delay;
+        task->frame.transparent = frame.transparent;
+        frame.data.move(task->frame.data);
+        task->image = image;
+        task->result = result;
+        task->encoded = encoded;
+        task->skipped = skipped;
+        frame.image = frame.tmpImage = image = nullptr;
+        retired.push(this);
+        return task;
+    }
+
+    //a retired task popped out of its queue already, or a new one
+    EncodeTask* spare(Array<EncodeTask*>& retired)
+    {
+        for (uint32_t i = 0; i < retired.count; ++i) {
+            auto task = retired[i];
+            if (!task->finished) continue;
+            task->done();
+            retired[i] = retired.last();
+            retired.pop();
+            return task;
+        }
+        return new EncodeTask(w, h, delay, transparent);
+    }
+
+    void run(TVG_UNUSED unsigned tid) override
+    {
+        encode();
+        finished = true;
+    }
+};
+
+
+static bool _write(const uint8_t* data, uint32_t size, void* user)
+{
+    return static_cast<const SaveWriter*>(user)->write(data, size);
+}
+
+
+bool GifSaver::start(Animation* animation, Paint* bg, uint32_t fps)
+{
+    auto picture = animation->picture();
+    float x, y;
+    x = y = 0;
+    picture->bounds(&x, &y, &vsize[0], &vsize[1]);
+
+    //cut off the negative space
+    if (x < 0) vsize[0] += x;
+    if (y < 0) vsize[1] += y;
+
+    if (vsize[0] < FLOAT_EPSILON || vsize[1] < FLOAT_EPSILON) {
+        TVGLOG("GIF_SAVER", "Saving animation(%p) has zero view size.", animation);
+        return false;
+    }
+
+    this->animation = animation;
+
+    if (bg) {
+        bg->ref();
+        this->bg = bg;
+    }
+    this->fps = static_cast<float>(fps);
+
+    TaskScheduler::request(this);
+
+    return true;
+}
+
+
 void GifSaver::run(unsigned tid)
 {
     auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
     if (!canvas) return;
 
+    /* render on this thread. the nested tasks might be queued behind this worker
+       which would wait for them forever. */
+    TaskScheduler::async(false);
+
     auto w = static_cast<uint32_t>(vsize[0]);
     auto h = static_cast<uint32_t>(vsize[1]);
 
     buffer = tvg::realloc<uint32_t*>(buffer, sizeof(uint32_t) * w * h);
     canvas->target(buffer, w, w, h, ColorSpace::ABGR8888S);
-    canvas->push(bg);
-    bg = nullptr;
+    //the background is released on close()
+    if (bg) canvas->push(bg);
 
     canvas->push(animation->picture());
 
@@ -55,12 +194,24 @@ void GifSaver::run(unsigned tid)
     auto transparent = bg ? false : true;
 
     GifWriter writer;
-    if (!gifBegin(&writer, path, w, h, uint32_t(delay * 100.f))) {
+    auto began = path ? gifBegin(&writer, path, w, h, uint32_t(delay * 100.f)) : gifBegin(&writer, _write, &output, w, h, uint32_t(delay * 100.f));
+    if (!began) {
         TVGERR("GIF_SAVER", "Failed gif encoding");
+        TaskScheduler::async(true);
         return;
     }
 
+    //a frame per a worker is encoded while the next frames are rendered here
+    Array<EncodeTask*> tasks(TaskScheduler::threads() + 1);
+    for (uint32_t i = 0; i < TaskScheduler::threads() + 1; ++i) {
+        auto task = new EncodeTask(w, h, uint32_t(delay * 100.0f), transparent);
+        task->image = tvg::malloc<uint8_t*>(sizeof(uint32_t) * w * h);
+        tasks.push(task);
+    }
+
+    auto success = true;
     auto duration = animation->duration();
+    uint32_t idx = 0;   //the frames to be encoded
 
     for (auto p = 0.0f; p < duration; p += delay) {
         auto frameNo = animation->totalFrame() * (p / duration);
@@ -69,13 +220,58 @@ void GifSaver::run(unsigned tid)
         if (canvas->draw(true) == tvg::Result::Success) {
             canvas->sync();
         }
-        if (!gifWriteFrame(&writer, reinterpret_cast<uint8_t*>(buffer), w, h, uint32_t(delay * 100.0f), transparent)) {
-            TVGERR("GIF_SAVER", "Failed gif encoding");
-            break;
+
+        //the same as the last frame, keep showing it instead
+        if (idx > 0) {
+            auto prev = tasks[(idx - 1) % tasks.count];
+            if (!memcmp(prev->image, buffer, sizeof(uint32_t) * w * h)) {
+                ++prev->skipped;
+                continue;
+            }
         }
+
+        //write out the oldest frame to reuse its slot
+        auto& task = tasks[idx % tasks.count];
+        if (task->encoded) {
+            task = task->sync(retired);
+            if (!task->write(&writer)) {
+                success = false;
+                break;
+            }
+        }
+        memcpy(task->image, buffer, sizeof(uint32_t) * w * h);
+
+        /* the opaque frames are the deltas of the previous palettized ones. the transparent
+           frames don't refer to it, but only the first one has the transparent pixels in its palette. */
+        task->last = (idx > 0) ? task->image : nullptr;
+        if (!transparent && idx > 0) {
+            auto& prev = tasks[(idx - 1) % tasks.count];
+            prev = prev->sync(retired);
+            if (!prev->result) {
+                success = false;
+                break;
+            }
+            task->last = prev->frame.image;
+        }
+        TaskScheduler::async(true);
+        task->request();
+        TaskScheduler::async(false);
+        ++idx;
+    }
+
+    //write out the rest in order
+    for (uint32_t i = 0; i < tasks.count; ++i) {
+        auto& task = tasks[(idx + i) % tasks.count];
+        task = task->sync(retired);
+        if (success && task->encoded) success = task->write(&writer);
     }
 
+    ARRAY_FOREACH(p, tasks) delete(*p);
+
+    if (!success) TVGERR("GIF_SAVER", "Failed gif encoding");
     if (!gifEnd(&writer)) TVGERR("GIF_SAVER", "Failed gif encoding");
+
+    TaskScheduler::async(true);
 }
 
 
@@ -93,6 +289,12 @@ bool GifSaver::close()
 {
     this->done();
 
+    ARRAY_FOREACH(p, retired) {
+        (*p)->done();
+        delete(*p);
+    }
+    retired.clear();
+
     if (bg) bg->unref();
     bg = nullptr;
 
@@ -102,6 +304,7 @@ bool GifSaver::close()
 
     tvg::free(path);
     path = nullptr;
+    output = SaveWriter();
 
     tvg::free(buffer);
     buffer = nullptr;
@@ -121,32 +324,19 @@ bool GifSaver::save(Animation* animation, Paint* bg, const char* filename, TVG_U
 {
     close();
 
-    auto picture = animation->picture();
-    float x, y;
-    x = y = 0;
-    picture->bounds(&x, &y, &vsize[0], &vsize[1]);
-
-    //cut off the negative space
-    if (x < 0) vsize[0] += x;
-    if (y < 0) vsize[1] += y;
-
-    if (vsize[0] < FLOAT_EPSILON || vsize[1] < FLOAT_EPSILON) {
-        TVGLOG("GIF_SAVER", "Saving animation(%p) has zero view size.", animation);
-        return false;
-    }
-
     if (!filename) return false;
     this->path = duplicate(filename);
 
-    this->animation = animation;
+    return start(animation, bg, fps);
+}
 
-    if (bg) {
-        bg->ref();
-        this->bg = bg;
-    }
-    this->fps = static_cast<float>(fps);
 
-    TaskScheduler::request(this);
+bool GifSaver::save(Animation* animation, Paint* bg, const SaveWriter& writer, TVG_UNUSED uint32_t quality, uint32_t fps)
+{
+    close();
 
-    return true;
+    if (!writer.func) return false;
+    this->output = writer;
+
+    return start(animation, bg, fps);
 }
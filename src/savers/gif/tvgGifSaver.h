@@ -23,6 +23,7 @@
 #ifndef _TVG_GIFSAVER_H_
 #define _TVG_GIFSAVER_H_
 
+#include "tvgArray.h"
 #include "tvgSaveModule.h"
 #include "tvgTaskScheduler.h"
 
@@ -32,13 +33,18 @@ namespace tvg
 class GifSaver : public SaveModule, public Task
 {
 private:
+    struct EncodeTask;
+
+    Array<EncodeTask*> retired;   //the encoding tasks which might be still in the queues
     uint32_t* buffer = nullptr;
     Animation* animation = nullptr;
     Paint* bg = nullptr;
     char *path = nullptr;
+    SaveWriter output;            //written out to it, if no path
     float vsize[2] = {0.0f, 0.0f};
     float fps = 0.0f;
 
+    bool start(Animation* animation, Paint* bg, uint32_t fps);
     void run(unsigned tid) override;
 
 public:
@@ -46,6 +52,7 @@ public:
 
     bool save(Paint* paint, Paint* bg, const char* filename, uint32_t quality) override;
     bool save(Animation* animation, Paint* bg, const char* filename, uint32_t quality, uint32_t fps) override;
+    bool save(Animation* animation, Paint* bg, const SaveWriter& writer, uint32_t quality, uint32_t fps) override;
     bool close() override;
 };
 
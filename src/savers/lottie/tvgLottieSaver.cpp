@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025 the ThorVG project. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "tvgStr.h"
+#include "tvgPicture.h"
+#include "tvgLottieLoader.h"
+#include "tvgLottieSaver.h"
+
+/************************************************************************/
+/* Internal Class Implementation                                        */
+/************************************************************************/
+
+//write out to the file, or to the user writer if no file
+static bool _write(FILE* f, const SaveWriter& writer, const void* data, uint32_t size)
+{
+    if (size == 0) return true;
+    if (f) return fwrite(data, size, 1, f) == 1;
+    return writer.write(data, size);
+}
+
+
+void LottieSaver::run(TVG_UNUSED unsigned tid)
+{
+    //the built model, the deferred assets are resolved together
+    Array<uint8_t> out;
+    if (!static_cast<LottieLoader*>(PICTURE(animation->picture())->loader)->compile(out)) {
+        TVGERR("LOTTIE_SAVER", "Failed to compile the animation(%p)", animation);
+        return;
+    }
+
+    FILE* f = nullptr;
+    if (path) f = fopen(path, "wb");
+    if ((path && !f) || !_write(f, writer, out.data, out.count)) TVGERR("LOTTIE_SAVER", "Failed to write the data(%s)", path ? path : "writer");
+    if (f) fclose(f);
+}
+
+
+/************************************************************************/
+/* External Class Implementation                                        */
+/************************************************************************/
+
+LottieSaver::~LottieSaver()
+{
+    close();
+}
+
+
+bool LottieSaver::close()
+{
+    this->done();
+
+    //animation holds the picture, it must be 1 at the bottom.
+    if (animation && animation->picture()->refCnt() <= 1) delete(animation);
+    animation = nullptr;
+
+    tvg::free(path);
+    path = nullptr;
+    writer = SaveWriter();
+
+    return true;
+}
+
+
+bool LottieSaver::save(TVG_UNUSED Paint* paint, TVG_UNUSED Paint* bg, TVG_UNUSED const char* filename, TVG_UNUSED uint32_t quality)
+{
+    TVGLOG("LOTTIE_SAVER", "Paint is not supported.");
+    return false;
+}
+
+
+bool LottieSaver::start(Animation* animation)
+{
+    auto loader = PICTURE(animation->picture())->loader;
+    if (!loader || loader->type != FileType::Lot) {
+        TVGLOG("LOTTIE_SAVER", "Saving animation(%p) is not a Lottie.", animation);
+        return false;
+    }
+
+    //the loading must be completed on this thread, the worker can't wait for it.
+    if (!static_cast<LottieLoader*>(loader)->ready()) return false;
+
+    this->animation = animation;
+
+    TaskScheduler::request(this);
+
+    return true;
+}
+
+
+bool LottieSaver::save(Animation* animation, TVG_UNUSED Paint* bg, const char* filename, TVG_UNUSED uint32_t quality, TVG_UNUSED uint32_t fps)
+{
+    close();
+
+    if (!filename) return false;
+    this->path = duplicate(filename);
+
+    return start(animation);
+}
+
+
+bool LottieSaver::save(Animation* animation, TVG_UNUSED Paint* bg, const SaveWriter& writer, TVG_UNUSED uint32_t quality, TVG_UNUSED uint32_t fps)
+{
+    close();
+
+    if (!writer.func) return false;
+    this->writer = writer;
+
+    return start(animation);
+}
@@ -129,4 +129,195 @@ TEST_CASE("Lottie Marker", "[tvgLottie]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
-#endif
\ No newline at end of file
+TEST_CASE("Lottie Shared Composition", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation->picture()->load(TEST_DIR"/lottiemarker.json") == Result::Success);
+
+        //The other instances of the identical source
+        auto animation2 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+        REQUIRE(animation2->picture()->load(TEST_DIR"/lottiemarker.json") == Result::Success);
+
+        auto animation3 = LottieAnimation::gen();
+        REQUIRE(animation3->picture()->load(TEST_DIR"/lottiemarker.json") == Result::Success);
+
+        REQUIRE(animation->totalFrame() == animation2->totalFrame());
+        REQUIRE(animation3->markersCnt() == 3);
+
+        REQUIRE(canvas->push(animation->picture()) == Result::Success);
+        REQUIRE(canvas->push(animation2->picture()) == Result::Success);
+        REQUIRE(canvas->push(animation3->picture()) == Result::Success);
+
+        //Play the instances independently
+        REQUIRE(animation->frame(10.0f) == Result::Success);
+        REQUIRE(animation2->frame(20.0f) == Result::Success);
+        REQUIRE(animation3->segment("sectionB") == Result::Success);
+        REQUIRE(animation3->frame(5.0f) == Result::Success);
+
+        REQUIRE(animation->curFrame() == 10.0f);
+        REQUIRE(animation2->curFrame() == 20.0f);
+
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+
+        //Release one of them while the others are alive
+        REQUIRE(canvas->remove(animation3->picture()) == Result::Success);
+        delete(animation3);
+
+        REQUIRE(animation2->frame(30.0f) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+        REQUIRE(canvas->draw() == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Lottie Shared Composition Data", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(2) == Result::Success);
+    {
+        char data[] = "{\"v\":\"5.7.0\",\"fr\":30,\"ip\":0,\"op\":10,\"w\":100,\"h\":100,\"layers\":[{\"ty\":4,\"ip\":0,\"op\":10,\"st\":0,\"ks\":{},\"shapes\":[{\"ty\":\"rc\",\"p\":{\"a\":0,\"k\":[50,50]},\"s\":{\"a\":0,\"k\":[80,80]},\"r\":{\"a\":0,\"k\":0}},{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[1,0,0,1]},\"o\":{\"a\":0,\"k\":100}}]}]}";
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto draw = [&](Animation* animation) {
+            REQUIRE(canvas->push(animation->picture()) == Result::Success);
+            memset(buffer, 0, sizeof(buffer));
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(canvas->remove(animation->picture()) == Result::Success);
+            return buffer[50 * 100 + 50];
+        };
+
+        //the instances of the copied data
+        auto animation = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation->picture()->load(data, strlen(data), "lottie", nullptr, true) == Result::Success);
+
+        auto animation2 = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation2->picture()->load(data, strlen(data), "lottie", nullptr, true) == Result::Success);
+
+        REQUIRE(animation->frame(1.0f) == Result::Success);
+        REQUIRE(animation2->frame(2.0f) == Result::Success);
+        REQUIRE(draw(animation.get()) == 0xffff0000);
+        REQUIRE(draw(animation2.get()) == 0xffff0000);
+
+        //the same memory with the other content
+        auto color = strstr(data, "[1,0,0,1]");
+        REQUIRE(color);
+        memcpy(color, "[0,0,1,1]", 9);
+
+        auto animation3 = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation3->picture()->load(data, strlen(data), "lottie", nullptr, true) == Result::Success);
+
+        REQUIRE(animation3->frame(1.0f) == Result::Success);
+        REQUIRE(draw(animation3.get()) == 0xff0000ff);
+        REQUIRE(draw(animation.get()) == 0xffff0000);
+
+        //the other content of the same size and the same djb2 hash, the fill is gone
+        auto fill = strstr(data, "\"fl\"");
+        REQUIRE(fill);
+        memcpy(fill, "\"gK\"", 4);
+
+        auto animation4 = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation4->picture()->load(data, strlen(data), "lottie", nullptr, true) == Result::Success);
+
+        REQUIRE(animation4->frame(1.0f) == Result::Success);
+        REQUIRE(draw(animation4.get()) == 0);
+        REQUIRE(draw(animation3.get()) == 0xff0000ff);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+//draw the frames in order and keep each of them in its own area of the buffer
+static void _renderLottie(const char* path, uint32_t threads, uint32_t frames, uint32_t* buffer)
+{
+    REQUIRE(Initializer::init(threads) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+        uint32_t target[100 * 100];
+        REQUIRE(canvas->target(target, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        auto animation = unique_ptr<Animation>(Animation::gen());
+        auto picture = animation->picture();
+        REQUIRE(picture->load(path) == Result::Success);
+        REQUIRE(picture->size(100, 100) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+
+        for (uint32_t i = 0; i < frames; ++i) {
+            animation->frame(animation->totalFrame() * float(i + 1) / float(frames + 1));
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            memcpy(buffer + i * 100 * 100, target, sizeof(target));
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Update Lottie layers in parallel", "[tvgLottie]")
+{
+    //the root layers are updated by the workers with 2+ threads, sequentially with 1.
+    const char* paths[] = {TEST_DIR"/test12.json", TEST_DIR"/test2.json", TEST_DIR"/test7.json"};
+    const uint32_t frames = 6;
+
+    auto sequential = new uint32_t[frames * 100 * 100];
+    auto parallel = new uint32_t[frames * 100 * 100];
+
+    for (auto path : paths) {
+        memset(sequential, 0, sizeof(uint32_t) * frames * 100 * 100);
+        memset(parallel, 0xff, sizeof(uint32_t) * frames * 100 * 100);
+        _renderLottie(path, 1, frames, sequential);
+        _renderLottie(path, 4, frames, parallel);
+        REQUIRE(memcmp(sequential, parallel, sizeof(uint32_t) * frames * 100 * 100) == 0);
+    }
+
+    delete[] sequential;
+    delete[] parallel;
+}
+
+TEST_CASE("Lottie Broken Precomp Asset", "[tvgLottie]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+
+        uint32_t buffer[100*100];
+        REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+        //the second layer of the asset is broken, the asset is parsed on demand with the copied data
+        const char* data = "{\"v\":\"5.7.0\",\"fr\":30,\"ip\":0,\"op\":10,\"w\":100,\"h\":100,\"assets\":[{\"id\":\"a\",\"layers\":[{\"ty\":4,\"ip\":0,\"op\":10,\"st\":0,\"ks\":{},\"shapes\":[{\"ty\":\"rc\",\"p\":{\"a\":0,\"k\":[50,50]},\"s\":{\"a\":0,\"k\":[80,80]},\"r\":{\"a\":0,\"k\":0}},{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[1,0,0,1]},\"o\":{\"a\":0,\"k\":100}}]},{\"ty\":4,\"ip\":0,\"op\":10,\"st\":0,\"ks\":{},\"shapes\":[{\"ty\":\"rc\",\"p\":{\"a\":0,\"k\":[50,50]},\"s\":{\"a\":0,\"k\":[80,80]},\"r\":{\"a\":0,\"k\":nul}},{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[1,0,0,1]},\"o\":{\"a\":0,\"k\":100}}]}]}],\"layers\":[{\"ty\":0,\"refId\":\"a\",\"ip\":0,\"op\":10,\"st\":0,\"w\":100,\"h\":100,\"ks\":{}}]}";
+
+        auto animation = unique_ptr<Animation>(Animation::gen());
+        auto picture = animation->picture();
+        REQUIRE(picture->load(data, strlen(data), "lottie", nullptr, true) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+
+        //the half-parsed asset is never drawn
+        for (auto i = 0; i < 3; ++i) {
+            memset(buffer, 0, sizeof(buffer));
+            REQUIRE(animation->frame(float(i + 1)) == Result::Success);
+            REQUIRE(canvas->update() == Result::Success);
+            REQUIRE(canvas->draw() == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(buffer[55 * 100 + 55] == 0);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
@@ -23,6 +23,8 @@
 #include <thorvg.h>
 #include <fstream>
 #include <cstring>
+#include <thread>
+#include <vector>
 #include "config.h"
 #include "catch.hpp"
 
@@ -163,6 +165,189 @@ TEST_CASE("Picture Duplication", "[tvgPicture]")
     free(data);
 }
 
+TEST_CASE("Draw the downscaled duplicates", "[tvgPicture]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    {
+        ifstream file(TEST_DIR"/rawimage_200x300.raw");
+        REQUIRE(file.is_open());
+        auto data = (uint32_t*)malloc(sizeof(uint32_t) * (200*300));
+        file.read(reinterpret_cast<char *>(data), sizeof (uint32_t) * 200 * 300);
+        file.close();
+
+        //the downscaled images share the mipmap levels of the source, the invisible ones don't build them.
+        auto draw = [&](bool duplicate, uint32_t* buffer) {
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(buffer, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+
+            Picture* source = nullptr;
+            auto picture = [&]() -> Picture* {
+                if (duplicate && source) return static_cast<Picture*>(source->duplicate());
+                auto picture = Picture::gen();
+                REQUIRE(picture->load(data, 200, 300, ColorSpace::ARGB8888, false) == Result::Success);
+                source = picture;
+                return picture;
+            };
+
+            const struct {float x, y, scale; uint8_t opacity; } spots[] = {
+                {500.0f, 500.0f, 0.125f, 255}, {10.0f, 10.0f, 0.125f, 0},
+                {10.0f, 10.0f, 0.125f, 255}, {50.0f, 10.0f, 0.2f, 255}, {10.0f, 60.0f, 0.07f, 255}
+            };
+            for (auto& spot : spots) {
+                auto p = picture();
+                REQUIRE(p->translate(spot.x, spot.y) == Result::Success);
+                REQUIRE(p->scale(spot.scale) == Result::Success);
+                REQUIRE(p->opacity(spot.opacity) == Result::Success);
+                REQUIRE(canvas->push(p) == Result::Success);
+            }
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+        };
+
+        uint32_t shared[100*100];
+        uint32_t separate[100*100];
+        draw(true, shared);
+        draw(false, separate);
+        REQUIRE(shared[20 * 100 + 20] != 0);
+        REQUIRE(memcmp(shared, separate, sizeof(shared)) == 0);
+
+        free(data);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#if defined(THORVG_JPG_LOADER_SUPPORT) || defined(THORVG_PNG_LOADER_SUPPORT)
+
+//draw the image in the size given prior to or after load()
+static void _drawImage(const char* path, uint32_t size, bool before, uint32_t* buffer)
+{
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    REQUIRE(canvas->target(buffer, size, size, size, ColorSpace::ARGB8888) == Result::Success);
+
+    auto picture = Picture::gen();
+    if (before) REQUIRE(picture->size(float(size), float(size)) == Result::Success);
+    REQUIRE(picture->load(path) == Result::Success);
+    if (!before) REQUIRE(picture->size(float(size), float(size)) == Result::Success);
+
+    float w, h;
+    REQUIRE(picture->size(&w, &h) == Result::Success);
+    REQUIRE(w == float(size));
+    REQUIRE(h == float(size));
+
+    REQUIRE(canvas->push(picture) == Result::Success);
+    REQUIRE(canvas->draw(true) == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+}
+
+//the mean difference of the color channels
+static float _diffImage(const uint32_t* a, const uint32_t* b, uint32_t cnt)
+{
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < cnt; ++i) {
+        for (uint32_t s = 0; s < 32; s += 8) {
+            auto c1 = int((a[i] >> s) & 0xff);
+            auto c2 = int((b[i] >> s) & 0xff);
+            sum += abs(c1 - c2);
+        }
+    }
+    return float(sum) / float(cnt * 4);
+}
+
+//the sizes given in advance reduce the decoding by 1/2, 1/4 and 1/8 (the images are 512x512)
+static void _testImageHint(const char* path)
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        auto full = new uint32_t[512 * 512];
+        auto reduced = new uint32_t[512 * 512];
+
+        for (auto size : {256U, 128U, 64U}) {
+            _drawImage(path, size, false, full);
+            _drawImage(path, size, true, reduced);
+            REQUIRE(memcmp(full, reduced, size * size * sizeof(uint32_t)) != 0);
+            REQUIRE(_diffImage(full, reduced, size * size) < 10.0f);
+        }
+
+        //the reduced one is never shared with the full size one, and vice versa
+        auto hinted = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(hinted->size(64, 64) == Result::Success);
+        REQUIRE(hinted->load(path) == Result::Success);
+        _drawImage(path, 512, false, full);
+        hinted.reset();
+        _drawImage(path, 512, false, reduced);
+        REQUIRE(memcmp(full, reduced, 512 * 512 * sizeof(uint32_t)) == 0);
+
+        auto native = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(native->load(path) == Result::Success);
+        _drawImage(path, 64, true, full);
+        native.reset();
+        _drawImage(path, 64, true, reduced);
+        REQUIRE(memcmp(full, reduced, 64 * 64 * sizeof(uint32_t)) == 0);
+
+        delete[] full;
+        delete[] reduced;
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
+
+#if defined(THORVG_JPG_LOADER_SUPPORT) || defined(THORVG_PNG_LOADER_SUPPORT) || defined(THORVG_WEBP_LOADER_SUPPORT)
+
+//draw the pictures sharing the same loader on the canvas of the given colorspace, no catch macros on the threads
+static bool _drawShared(const char* path, ColorSpace cs, uint32_t* buffer)
+{
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    if (canvas->target(buffer, 64, 64, 64, cs) != Result::Success) return false;
+
+    for (int i = 0; i < 4; ++i) {
+        auto picture = Picture::gen();
+        if (picture->load(path) != Result::Success) return false;
+        picture->size(32, 32);
+        picture->translate(float(i % 2) * 32.0f, float(i / 2) * 32.0f);
+        if (canvas->push(picture) != Result::Success) return false;
+    }
+    if (canvas->draw(true) != Result::Success) return false;
+    return canvas->sync() == Result::Success;
+}
+
+//the canvases request the cached loader at once, it decodes only once.
+//the bitmap is converted in place to the colorspace of the canvas drawing it, so the different ones share it in turn.
+static void _testSharedImage(const char* path)
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    {
+        uint32_t argb[64*64], abgr[64*64];
+        REQUIRE(_drawShared(path, ColorSpace::ARGB8888, argb));
+        REQUIRE(_drawShared(path, ColorSpace::ABGR8888, abgr));
+        REQUIRE(memcmp(argb, abgr, sizeof(argb)) != 0);
+
+        for (int i = 0; i < 10; ++i) {
+            uint32_t buffer1[64*64], buffer2[64*64];
+            auto ret1 = false, ret2 = false;
+            thread t1([&] { ret1 = _drawShared(path, ColorSpace::ARGB8888, buffer1); });
+            thread t2([&] { ret2 = _drawShared(path, ColorSpace::ARGB8888, buffer2); });
+            t1.join();
+            t2.join();
+            REQUIRE(ret1);
+            REQUIRE(ret2);
+            REQUIRE(memcmp(argb, buffer1, sizeof(argb)) == 0);
+            REQUIRE(memcmp(argb, buffer2, sizeof(argb)) == 0);
+        }
+
+        auto shared = unique_ptr<Picture>(Picture::gen());
+        REQUIRE(shared->load(path) == Result::Success);
+        for (auto cs : {ColorSpace::ABGR8888, ColorSpace::ARGB8888, ColorSpace::ABGR8888}) {
+            uint32_t buffer[64*64];
+            REQUIRE(_drawShared(path, cs, buffer));
+            REQUIRE(memcmp(cs == ColorSpace::ARGB8888 ? argb : abgr, buffer, sizeof(buffer)) == 0);
+        }
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
+
 #ifdef THORVG_SVG_LOADER_SUPPORT
 
 TEST_CASE("Load SVG file", "[tvgPicture]")
@@ -227,6 +412,53 @@ TEST_CASE("Load SVG file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+static void _renderSvg(const string& svg, uint32_t threads, uint32_t* buffer)
+{
+    REQUIRE(Initializer::init(threads) == Result::Success);
+    {
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas);
+        REQUIRE(canvas->target(buffer, 200, 200, 200, ColorSpace::ARGB8888) == Result::Success);
+
+        auto picture = Picture::gen();
+        REQUIRE(picture);
+        REQUIRE(picture->load(svg.c_str(), svg.size(), "svg", nullptr, true) == Result::Success);
+
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Build SVG subtrees in parallel", "[tvgPicture]")
+{
+    //the large independent groups are built on the workers
+    string svg = "<svg viewBox=\"0 0 200 200\" xmlns=\"http://www.w3.org/2000/svg\">";
+    for (int g = 0; g < 3; ++g) {
+        svg += "<g transform=\"translate(" + to_string(g * 60) + " 0)\" opacity=\"0.8\">";
+        for (int i = 0; i < 150; ++i) {
+            svg += "<rect x=\"" + to_string(i % 10 * 6) + "\" y=\"" + to_string(i / 10 * 12) + "\" width=\"7\" height=\"9\" fill=\"#";
+            svg += (i % 3 == 0) ? "ff0000" : (i % 3 == 1) ? "00ff00" : "0000ff";
+            svg += "\" fill-opacity=\"0.5\"/>";
+        }
+        svg += "</g>";
+    }
+    //the dependent ones are built in order
+    svg += "<clipPath id=\"c\"><circle cx=\"100\" cy=\"100\" r=\"50\"/></clipPath><g clip-path=\"url(#c)\"><rect width=\"200\" height=\"200\" fill=\"#808080\" fill-opacity=\"0.5\"/></g></svg>";
+
+    auto serial = new uint32_t[200 * 200];
+    auto parallel = new uint32_t[200 * 200];
+
+    _renderSvg(svg, 0, serial);
+    _renderSvg(svg, 4, parallel);
+
+    REQUIRE(memcmp(serial, parallel, sizeof(uint32_t) * 200 * 200) == 0);
+
+    delete[] serial;
+    delete[] parallel;
+}
+
 #endif
 
 #ifdef THORVG_PNG_LOADER_SUPPORT
@@ -294,6 +526,16 @@ TEST_CASE("Load PNG file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Load PNG file in the size given in advance", "[tvgPicture]")
+{
+    _testImageHint(TEST_DIR"/test.png");
+}
+
+TEST_CASE("Draw the shared PNG file on the canvases of the different colorspaces", "[tvgPicture]")
+{
+    _testSharedImage(TEST_DIR"/test.png");
+}
+
 #endif
 
 #ifdef THORVG_JPG_LOADER_SUPPORT
@@ -363,6 +605,51 @@ TEST_CASE("Load JPG file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Load JPG file in the size given in advance", "[tvgPicture]")
+{
+    _testImageHint(TEST_DIR"/test.jpg");
+}
+
+TEST_CASE("Draw the shared JPG file on the canvases of the different colorspaces", "[tvgPicture]")
+{
+    _testSharedImage(TEST_DIR"/test.jpg");
+}
+
+//draw the jpg decoded in full or reduced to 1/4, the canvas is targeted after the load to decode it on the first update
+static vector<uint32_t> _drawJpg(const char* path, uint32_t threads, bool reduced)
+{
+    auto size = reduced ? 128U : 550U;
+    vector<uint32_t> buffer(size * size);
+    REQUIRE(Initializer::init(threads) == Result::Success);
+    {
+        auto picture = Picture::gen();
+        if (reduced) REQUIRE(picture->size(float(size), float(size)) == Result::Success);
+        REQUIRE(picture->load(path) == Result::Success);
+
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(buffer.data(), size, size, size, ColorSpace::ARGB8888) == Result::Success);
+        REQUIRE(canvas->push(picture) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+    return buffer;
+}
+
+TEST_CASE("Load JPG file with restart intervals", "[tvgPicture]")
+{
+    //the short restart segments are decoded on the workers, the long ones are pipelined by the rows
+    for (auto path : {TEST_DIR"/restart.jpg", TEST_DIR"/restart_long.jpg"}) {
+        for (auto reduced : {false, true}) {
+            auto serial = _drawJpg(path, 0, reduced);
+            REQUIRE(serial[serial.size() / 2] != 0);
+            for (auto threads : {1U, 4U}) {
+                REQUIRE(_drawJpg(path, threads, reduced) == serial);
+            }
+        }
+    }
+}
+
 #endif
 
 #ifdef THORVG_WEBP_LOADER_SUPPORT
@@ -430,5 +717,10 @@ TEST_CASE("Load WEBP file and render", "[tvgPicture]")
     REQUIRE(Initializer::term() == Result::Success);
 }
 
+TEST_CASE("Draw the shared WEBP file on the canvases of the different colorspaces", "[tvgPicture]")
+{
+    _testSharedImage(TEST_DIR"/test.webp");
+}
+
 #endif
 
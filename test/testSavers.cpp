@@ -21,8 +21,12 @@
  */
 
 #include <thorvg.h>
+#include <cstring>
 #include <fstream>
 #include "config.h"
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+#include <thorvg_lottie.h>
+#endif
 #include "catch.hpp"
 
 using namespace tvg;
@@ -70,7 +74,467 @@ TEST_CASE("Save a lottie into gif", "[tvgSavers]")
     REQUIRE(saver->save(animation2, TEST_DIR"/test.gif") == Result::Success);
     REQUIRE(saver->sync() == Result::Success);
 
+    //into the memory
+    auto animation3 = Animation::gen();
+    REQUIRE(animation3);
+    REQUIRE(animation3->picture()->load(TEST_DIR"/test.json") == Result::Success);
+    REQUIRE(animation3->picture()->size(100, 100) == Result::Success);
+
+    char* buffer = nullptr;
+    uint32_t size = 0;
+    REQUIRE(saver->save(animation3, &buffer, &size, "gif") == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+    REQUIRE(buffer);
+    REQUIRE(size > 6);
+    REQUIRE(!memcmp(buffer, "GIF89a", 6));
+
+    //through a writer
+    auto animation4 = Animation::gen();
+    REQUIRE(animation4);
+    REQUIRE(animation4->picture()->load(TEST_DIR"/test.json") == Result::Success);
+    REQUIRE(animation4->picture()->size(100, 100) == Result::Success);
+
+    string written;
+    auto writer = [](const char* buffer, uint32_t size, void* data) {
+        static_cast<string*>(data)->append(buffer, size);
+        return true;
+    };
+    REQUIRE(saver->save(animation4, writer, &written, "gif") == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+    REQUIRE(written == string(buffer, size));
+    free(buffer);
+
+    auto animation5 = Animation::gen();
+    REQUIRE(animation5);
+    REQUIRE(animation5->picture()->load(TEST_DIR"/test.json") == Result::Success);
+    REQUIRE(saver->save(animation5, writer, &written, "png") == Result::NonSupport);
+
+    REQUIRE(Initializer::term() == Result::Success);
+}
+#endif
+
+#ifdef THORVG_LOTTIE_SAVER_SUPPORT
+
+TEST_CASE("Save a lottie into the compiled form", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+
+    auto animation = Animation::gen();
+    REQUIRE(animation);
+    REQUIRE(animation->picture()->load(TEST_DIR"/lottieslot.json") == Result::Success);
+    auto totalFrame = animation->totalFrame();
+
+    auto saver = unique_ptr<Saver>(Saver::gen());
+    REQUIRE(saver);
+    REQUIRE(saver->save(animation, TEST_DIR"/test.lotb") == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    //loaded from memory
+    ifstream file(TEST_DIR"/test.json");
+    REQUIRE(file.is_open());
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    auto animation2 = Animation::gen();
+    REQUIRE(animation2);
+    REQUIRE(animation2->picture()->load(data.c_str(), data.size(), "lot", nullptr, true) == Result::Success);
+    REQUIRE(saver->save(animation2, TEST_DIR"/test2.lotb") == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+
+    //reload
+    auto animation3 = unique_ptr<LottieAnimation>(LottieAnimation::gen());
+    REQUIRE(animation3);
+    REQUIRE(animation3->picture()->load(TEST_DIR"/test.lotb") == Result::Success);
+    REQUIRE(animation3->totalFrame() == totalFrame);
+    REQUIRE(animation3->frame(totalFrame * 0.5f) == Result::Success);
+
+    //the slots are restored as well
+    const char* slotJson = R"({"gradient_fill":{"p":{"p":2,"k":{"a":0,"k":[0,0.1,0.1,0.2,1,1,0.1,0.2,0.1,1]}}}})";
+    REQUIRE(animation3->override(slotJson) == Result::Success);
+
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+#endif
+#endif
+
+#if defined(THORVG_LOTTIE_SAVER_SUPPORT) && defined(THORVG_LOTTIE_LOADER_SUPPORT)
+
+TEST_CASE("Save a lottie into the compiled form in memory", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(0) == Result::Success);
+    {
+        ifstream file(TEST_DIR"/test.json");
+        REQUIRE(file.is_open());
+        string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        //the saver takes the ownership of the animation
+        auto animation = Animation::gen();
+        REQUIRE(animation->picture()->load(data.c_str(), data.size(), "lot", nullptr, true) == Result::Success);
+
+        //the reference drawing
+        auto ref = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(ref->picture()->load(data.c_str(), data.size(), "lot", nullptr, true) == Result::Success);
+
+        auto saver = unique_ptr<Saver>(Saver::gen());
+        char* buffer = nullptr;
+        uint32_t size = 0;
+        REQUIRE(saver->save(animation, &buffer, &size, "lotb") == Result::Success);
+        REQUIRE(saver->sync() == Result::Success);
+        REQUIRE(buffer);
+        REQUIRE(size > 36);
+
+        //magic, version and the byte order mark in the host byte order
+        REQUIRE(!memcmp(buffer, "TVGLOTB", 7));
+        REQUIRE(buffer[7] == 3);
+        uint16_t bom;
+        memcpy(&bom, buffer + 8, sizeof(bom));
+        REQUIRE(bom == 0xFEFF);
+
+        //the frame rate is available without loading the model
+        float frameRate;
+        memcpy(&frameRate, buffer + 12, sizeof(frameRate));
+        REQUIRE(frameRate == Approx(ref->totalFrame() / ref->duration()));
+
+        //reload, it draws the same
+        auto animation2 = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation2->picture()->load(buffer, size, "lot", nullptr, true) == Result::Success);
+        REQUIRE(animation2->totalFrame() == ref->totalFrame());
+
+        uint32_t buffer1[100*100], buffer2[100*100];
+        auto draw = [&](Animation* animation, uint32_t* target) {
+            auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+            REQUIRE(canvas->target(target, 100, 100, 100, ColorSpace::ARGB8888) == Result::Success);
+            REQUIRE(animation->picture()->size(100, 100) == Result::Success);
+            REQUIRE(animation->frame(animation->totalFrame() * 0.5f) == Result::Success);
+            REQUIRE(canvas->push(animation->picture()) == Result::Success);
+            memset(target, 0, sizeof(uint32_t) * 100 * 100);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+            REQUIRE(canvas->remove(animation->picture()) == Result::Success);
+        };
+        draw(ref.get(), buffer1);
+        draw(animation2.get(), buffer2);
+        REQUIRE(!memcmp(buffer1, buffer2, sizeof(buffer1)));
+
+        free(buffer);
+    }
     REQUIRE(Initializer::term() == Result::Success);
 }
+
+#endif
+#if defined(THORVG_GIF_SAVER_SUPPORT) && defined(THORVG_LOTTIE_LOADER_SUPPORT)
+
+//a 16x16 red square moving 3px per frame for 10 frames, then it holds still for 10 frames
+static const char* _movingSquare = R"({"v":"5.7.0","fr":10,"ip":0,"op":20,"w":64,"h":64,"layers":[{"ty":4,"ind":1,"ip":0,"op":20,"st":0,
+"ks":{"p":{"a":1,"k":[{"t":0,"s":[16,16],"i":{"x":[1],"y":[1]},"o":{"x":[0],"y":[0]}},{"t":10,"s":[46,46]}]}},
+"shapes":[{"ty":"rc","p":{"a":0,"k":[0,0]},"s":{"a":0,"k":[16,16]},"r":{"a":0,"k":0}},{"ty":"fl","c":{"a":0,"k":[1,0,0,1]},"o":{"a":0,"k":100}}]}]})";
+
+struct GifImage
+{
+    uint32_t x, y, w, h;
+    uint32_t delay;         //in 1/100 seconds
+    uint8_t disposal;
+};
+
+static uint32_t _le16(const uint8_t* p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8);
+}
+
+//skip the data sub-blocks
+static const uint8_t* _skipBlocks(const uint8_t* p, const uint8_t* end)
+{
+    while (p < end && *p) p += *p + 1;
+    return (p < end) ? p + 1 : nullptr;
+}
+
+//decode the lzw codes of an image into its color indices
+static vector<uint8_t> _lzwDecode(const vector<uint8_t>& codes, uint32_t minCodeSize)
+{
+    vector<uint8_t> out;
+    vector<vector<uint8_t>> table;
+    auto clear = 1u << minCodeSize;
+    uint32_t codeSize = 0, bits = 0, bitCnt = 0;
+    auto prev = -1;
+
+    for (size_t i = 0; ; ) {
+        if (table.empty()) {
+            for (uint32_t c = 0; c < clear + 2; ++c) table.push_back({uint8_t(c)});
+            codeSize = minCodeSize + 1;
+            prev = -1;
+        }
+        while (bitCnt < codeSize) {
+            if (i >= codes.size()) return out;
+            bits |= uint32_t(codes[i++]) << bitCnt;
+            bitCnt += 8;
+        }
+        auto code = bits & ((1u << codeSize) - 1);
+        bits >>= codeSize;
+        bitCnt -= codeSize;
+
+        if (code == clear) {
+            table.clear();
+            continue;
+        }
+        if (code == clear + 1) return out;
+
+        vector<uint8_t> entry;
+        if (code < table.size()) entry = table[code];
+        else if (prev >= 0 && code == table.size()) {
+            entry = table[prev];
+            entry.push_back(entry[0]);
+        } else return {};
+
+        out.insert(out.end(), entry.begin(), entry.end());
+        if (prev >= 0 && table.size() < 4096) {
+            auto added = table[prev];
+            added.push_back(entry[0]);
+            table.push_back(added);
+        }
+        prev = code;
+        if (table.size() == (1u << codeSize) && codeSize < 12) ++codeSize;
+    }
+}
+
+/* walk through the gif blocks and collect the images with their graphic controls.
+   the screens receive the composited frames in ABGR8888S if requested. */
+static bool _readGif(const char* data, uint32_t size, uint32_t& w, uint32_t& h, vector<GifImage>& images, vector<vector<uint32_t>>* screens = nullptr)
+{
+    auto p = reinterpret_cast<const uint8_t*>(data);
+    auto end = p + size;
+    if (size < 13 || memcmp(p, "GIF89a", 6)) return false;
+    w = _le16(p + 6);
+    h = _le16(p + 8);
+    auto flags = p[10];
+    p += 13;
+    if (flags & 0x80) p += 3 * (2 << (flags & 7));
+
+    vector<uint32_t> screen(w * h, 0);
+    GifImage image{};
+    auto transparency = false;
+    uint8_t transparent = 0;
+
+    while (p && p < end) {
+        switch (*p++) {
+            case 0x21: {
+                if (p + 6 < end && p[0] == 0xf9) {
+                    image.disposal = (p[2] >> 2) & 7;
+                    transparency = p[2] & 1;
+                    image.delay = _le16(p + 3);
+                    transparent = p[5];
+                    p += 7;
+                } else p = _skipBlocks(p + 1, end);
+                break;
+            }
+            case 0x2c: {
+                if (p + 10 > end) return false;
+                image.x = _le16(p);
+                image.y = _le16(p + 2);
+                image.w = _le16(p + 4);
+                image.h = _le16(p + 6);
+                if (image.x + image.w > w || image.y + image.h > h) return false;
+                flags = p[8];
+                p += 9;
+                const uint8_t* palette = nullptr;
+                if (flags & 0x80) {
+                    palette = p;
+                    p += 3 * (2 << (flags & 7));
+                }
+                if (p >= end) return false;
+                auto minCodeSize = *p++;
+                vector<uint8_t> codes;
+                while (p < end && *p && p + *p < end) {
+                    codes.insert(codes.end(), p + 1, p + 1 + *p);
+                    p += *p + 1;
+                }
+                p = (p < end) ? p + 1 : nullptr;
+
+                if (screens) {
+                    auto indices = _lzwDecode(codes, minCodeSize);
+                    if (!palette || indices.size() < image.w * image.h) return false;
+                    for (uint32_t y = 0; y < image.h; ++y) {
+                        for (uint32_t x = 0; x < image.w; ++x) {
+                            auto idx = indices[y * image.w + x];
+                            if (transparency && idx == transparent) continue;
+                            auto c = palette + idx * 3;
+                            screen[(image.y + y) * w + image.x + x] = 0xff000000 | (uint32_t(c[2]) << 16) | (uint32_t(c[1]) << 8) | c[0];
+                        }
+                    }
+                    screens->push_back(screen);
+                    //restore to the background
+                    if (image.disposal == 2) {
+                        for (uint32_t y = 0; y < image.h; ++y) {
+                            memset(screen.data() + (image.y + y) * w + image.x, 0, sizeof(uint32_t) * image.w);
+                        }
+                    }
+                }
+                images.push_back(image);
+                image = {};
+                transparency = false;
+                break;
+            }
+            case 0x3b: return true;
+            default: return false;
+        }
+    }
+    return false;
+}
+
+static void _saveGif(const char* lottie, Paint* bg, char** buffer, uint32_t* size)
+{
+    //the saver takes the ownership of the animation
+    auto animation = Animation::gen();
+    REQUIRE(animation->picture()->load(lottie, strlen(lottie), "lot", nullptr, true) == Result::Success);
+
+    auto saver = unique_ptr<Saver>(Saver::gen());
+    if (bg) REQUIRE(saver->background(bg) == Result::Success);
+    REQUIRE(saver->save(animation, buffer, size, "gif") == Result::Success);
+    REQUIRE(saver->sync() == Result::Success);
+    REQUIRE(*buffer);
+}
+
+TEST_CASE("Save a lottie into gif in memory with the workers", "[tvgSavers]")
+{
+    //the frames are encoded on the workers while the next ones are rendered, the output doesn't depend on them
+    for (auto transparent : {true, false}) {
+        vector<char> ref;
+        for (auto threads : {0, 1, 2, 4}) {
+            REQUIRE(Initializer::init(threads) == Result::Success);
+            {
+                Shape* bg = nullptr;
+                if (!transparent) {
+                    bg = Shape::gen();
+                    REQUIRE(bg->appendRect(0, 0, 64, 64) == Result::Success);
+                    REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+                }
+                char* buffer = nullptr;
+                uint32_t size = 0;
+                _saveGif(_movingSquare, bg, &buffer, &size);
+                if (ref.empty()) ref.assign(buffer, buffer + size);
+                else REQUIRE(vector<char>(buffer, buffer + size) == ref);
+                free(buffer);
+            }
+            REQUIRE(Initializer::term() == Result::Success);
+        }
+    }
+}
+
+TEST_CASE("Save a lottie into gif in memory with its frame timing", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    for (auto transparent : {true, false}) {
+        Shape* bg = nullptr;
+        if (!transparent) {
+            bg = Shape::gen();
+            REQUIRE(bg->appendRect(0, 0, 64, 64) == Result::Success);
+            REQUIRE(bg->fill(255, 255, 255) == Result::Success);
+        }
+        char* buffer = nullptr;
+        uint32_t size = 0;
+        _saveGif(_movingSquare, bg, &buffer, &size);
+
+        uint32_t w, h;
+        vector<GifImage> images;
+        REQUIRE(_readGif(buffer, size, w, h, images));
+        REQUIRE(w == 64);
+        REQUIRE(h == 64);
+
+        //a frame per a move, the last one stays as long as the square holds still
+        REQUIRE(images.size() == 11);
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < images.size(); ++i) {
+            if (i < 10) REQUIRE(images[i].delay == 10);
+            total += images[i].delay;
+        }
+        REQUIRE(images.back().delay >= 100);
+        REQUIRE(total >= 200);
+        REQUIRE(total <= 210);
+
+        free(buffer);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
+TEST_CASE("Save a lottie into gif with the cropped and merged frames", "[tvgSavers]")
+{
+    REQUIRE(Initializer::init(4) == Result::Success);
+    for (auto transparent : {true, false}) {
+        auto background = [] {
+            auto bg = Shape::gen();
+            bg->appendRect(0, 0, 64, 64);
+            bg->fill(255, 255, 255);
+            return bg;
+        };
+
+        char* buffer = nullptr;
+        uint32_t size = 0;
+        _saveGif(_movingSquare, transparent ? nullptr : background(), &buffer, &size);
+
+        uint32_t w, h;
+        vector<GifImage> images;
+        vector<vector<uint32_t>> screens;
+        REQUIRE(_readGif(buffer, size, w, h, images, &screens));
+        REQUIRE(images.size() == 11);
+        REQUIRE(screens.size() == images.size());
+
+        //the reference drawing
+        auto animation = unique_ptr<Animation>(Animation::gen());
+        REQUIRE(animation->picture()->load(_movingSquare, strlen(_movingSquare), "lot", nullptr, true) == Result::Success);
+        vector<uint32_t> ref(w * h);
+        auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+        REQUIRE(canvas->target(ref.data(), w, w, h, ColorSpace::ABGR8888S) == Result::Success);
+        if (!transparent) REQUIRE(canvas->push(background()) == Result::Success);
+        REQUIRE(canvas->push(animation->picture()) == Result::Success);
+
+        uint32_t time = 0;
+        for (uint32_t i = 0; i < images.size(); ++i) {
+            auto& image = images[i];
+
+            //the transparent frames are cleared after shown, the opaque ones are overdrawn by the next ones
+            REQUIRE(image.disposal == (transparent ? 2 : 1));
+
+            //only the square of the transparent frames, the region the square left and entered of the opaque ones
+            if (transparent) {
+                REQUIRE(image.x == 8 + 3 * i);
+                REQUIRE(image.y == 8 + 3 * i);
+                REQUIRE(image.w == 16);
+                REQUIRE(image.h == 16);
+            } else if (i > 0) {
+                REQUIRE(image.x == 8 + 3 * (i - 1));
+                REQUIRE(image.y == 8 + 3 * (i - 1));
+                REQUIRE(image.w == 19);
+                REQUIRE(image.h == 19);
+            }
+
+            //shows the frame rendered at its start time
+            animation->frame(float(time / 10));
+            REQUIRE(canvas->update() == Result::Success);
+            memset(ref.data(), 0, sizeof(uint32_t) * w * h);
+            REQUIRE(canvas->draw(true) == Result::Success);
+            REQUIRE(canvas->sync() == Result::Success);
+
+            //the palettized colors may be off a little
+            uint32_t mismatched = 0;
+            auto& screen = screens[i];
+            for (uint32_t j = 0; j < w * h; ++j) {
+                if ((ref[j] >> 24) == 0) {
+                    if (screen[j] >> 24) ++mismatched;
+                    continue;
+                }
+                if ((screen[j] >> 24) != 0xff) ++mismatched;
+                else {
+                    for (auto shift : {0, 8, 16}) {
+                        if (abs(int((ref[j] >> shift) & 0xff) - int((screen[j] >> shift) & 0xff)) > 2) ++mismatched;
+                    }
+                }
+            }
+            REQUIRE(mismatched == 0);
+            time += image.delay;
+        }
+
+        free(buffer);
+    }
+    REQUIRE(Initializer::term() == Result::Success);
+}
+
 #endif
-#endif
\ No newline at end of file
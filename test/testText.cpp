@@ -164,4 +164,208 @@ TEST_CASE("Text with composite glyphs", "[tvgText]")
     Initializer::term();
 }
 
+TEST_CASE("Text with more glyphs than the cache", "[tvgText]")
+{
+    Initializer::init(0);
+
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    uint32_t buffer[100*100];
+    canvas->target(buffer, 100, 100, 100, ColorSpace::ABGR8888);
+
+    auto text = Text::gen();
+    REQUIRE(text);
+
+    REQUIRE(Text::load(TEST_DIR"/NanumGothicCoding.ttf") == tvg::Result::Success);
+    REQUIRE(text->font("NanumGothicCoding", 20) == tvg::Result::Success);
+    REQUIRE(text->fill(255, 255, 255) == tvg::Result::Success);
+    REQUIRE(canvas->push(text) == Result::Success);
+
+    REQUIRE(text->text("THORVG Text") == tvg::Result::Success);
+    float x1, y1, w1, h1;
+    REQUIRE(text->bounds(&x1, &y1, &w1, &h1) == tvg::Result::Success);
+
+    //1000 distinct hangul syllables (U+AC00~), over the glyph cache size
+    char hangul[1000 * 3 + 1];
+    for (uint32_t i = 0; i < 1000; ++i) {
+        auto code = 0xac00 + i;
+        hangul[i * 3] = char(0xe0 | (code >> 12));
+        hangul[i * 3 + 1] = char(0x80 | ((code >> 6) & 0x3f));
+        hangul[i * 3 + 2] = char(0x80 | (code & 0x3f));
+    }
+    hangul[1000 * 3] = '\0';
+
+    REQUIRE(text->text(hangul) == tvg::Result::Success);
+    float x2, y2, w2, h2;
+    REQUIRE(text->bounds(&x2, &y2, &w2, &h2) == tvg::Result::Success);
+    REQUIRE(w2 > w1 * 50);
+
+    REQUIRE(canvas->update() == Result::Success);
+    REQUIRE(canvas->draw() == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+
+    //the glyphs are converted again after the cache is flushed
+    REQUIRE(text->text("THORVG Text") == tvg::Result::Success);
+    float x3, y3, w3, h3;
+    REQUIRE(text->bounds(&x3, &y3, &w3, &h3) == tvg::Result::Success);
+    REQUIRE(x3 == Approx(x1));
+    REQUIRE(y3 == Approx(y1));
+    REQUIRE(w3 == Approx(w1));
+    REQUIRE(h3 == Approx(h1));
+
+    //unmapped codepoints are skipped silently
+    REQUIRE(text->text("\xef\xbf\xbe") == tvg::Result::Success);
+
+    Initializer::term();
+}
+
+//draw the paint at (x1, y1) and then move it to (x2, y2), or draw it at (x2, y2) only
+static void _moveText(Paint* paint, float x1, float y1, float x2, float y2, bool move, uint32_t* buffer)
+{
+    auto canvas = unique_ptr<SwCanvas>(SwCanvas::gen());
+    REQUIRE(canvas->target(buffer, 200, 200, 100, ColorSpace::ARGB8888) == Result::Success);
+
+    if (move) {
+        REQUIRE(paint->translate(x1, y1) == Result::Success);
+        REQUIRE(canvas->push(paint) == Result::Success);
+        REQUIRE(canvas->draw(true) == Result::Success);
+        REQUIRE(canvas->sync() == Result::Success);
+        REQUIRE(paint->translate(x2, y2) == Result::Success);
+        REQUIRE(canvas->update() == Result::Success);
+    } else {
+        REQUIRE(paint->translate(x2, y2) == Result::Success);
+        REQUIRE(canvas->push(paint) == Result::Success);
+    }
+    REQUIRE(canvas->draw(true) == Result::Success);
+    REQUIRE(canvas->sync() == Result::Success);
+}
+
+TEST_CASE("Text moved around", "[tvgText]")
+{
+    Initializer::init(0);
+
+    REQUIRE(Text::load(TEST_DIR"/Arial.ttf") == tvg::Result::Success);
+
+    uint32_t moved[200*100];
+    uint32_t drawn[200*100];
+
+    auto text = [](uint32_t option) -> Paint* {
+        auto text = Text::gen();
+        text->font("Arial", 20);
+        text->text("ThorVG");
+        if (option == 1) {
+            auto fill = LinearGradient::gen();
+            fill->linear(0, 0, 100, 0);
+            Fill::ColorStop colorStops[2] = {{0, 255, 0, 0, 255}, {1, 0, 0, 255, 255}};
+            fill->colorStops(colorStops, 2);
+            text->fill(fill);
+        } else {
+            text->fill(255, 255, 255);
+        }
+        if (option == 2) {
+            auto clipper = Shape::gen();
+            clipper->appendRect(30, 20, 40, 30);
+            text->clip(clipper);
+        }
+        return text;
+    };
+
+    //the spans are reused when moved by whole pixels, otherwise the text is rasterized again
+    struct {float x1, y1, x2, y2; uint32_t option; } cases[] = {
+        {10.0f, 10.0f, 25.0f, 30.0f, 0},     //whole pixels
+        {10.5f, 10.0f, 25.5f, 30.0f, 0},     //whole pixels from a sub-pixel spot
+        {10.0f, 10.0f, 25.5f, 30.25f, 0},    //sub-pixel offset
+        {10.0f, 10.0f, -5.0f, 2.0f, 0},      //partially out of the canvas
+        {10.0f, 10.0f, 120.0f, 30.0f, 0},    //partially out of the canvas
+        {10.0f, 10.0f, 25.0f, 30.0f, 1},     //gradient
+        {10.0f, 10.0f, 25.0f, 30.0f, 2},     //clip
+    };
+
+    for (auto& c : cases) {
+        _moveText(text(c.option), c.x1, c.y1, c.x2, c.y2, true, moved);
+        _moveText(text(c.option), c.x1, c.y1, c.x2, c.y2, false, drawn);
+        REQUIRE(memcmp(moved, drawn, sizeof(moved)) == 0);
+    }
+
+    //the shapes are always rasterized again, with or without stroke
+    auto shape = [](bool stroke) -> Paint* {
+        auto shape = Shape::gen();
+        shape->appendCircle(40, 40, 30, 20);
+        shape->fill(255, 255, 255);
+        if (stroke) shape->strokeFill(255, 0, 0);
+        if (stroke) shape->strokeWidth(3);
+        return shape;
+    };
+
+    for (auto stroke : {false, true}) {
+        _moveText(shape(stroke), 10.0f, 10.0f, 25.0f, 30.0f, true, moved);
+        _moveText(shape(stroke), 10.0f, 10.0f, 25.0f, 30.0f, false, drawn);
+        REQUIRE(memcmp(moved, drawn, sizeof(moved)) == 0);
+    }
+
+    Initializer::term();
+}
+
+TEST_CASE("Text with overlapping cmap groups", "[tvgText]")
+{
+    Initializer::init(0);
+
+    //a minimal font (head, hhea, cmap) of which format 12 groups cover the whole code space each
+    const uint32_t groupCnt = 20000;
+    const uint32_t cmap = 152;
+    const uint32_t size = cmap + 12 + 16 + groupCnt * 12;
+    auto data = (uint8_t*)calloc(size, 1);
+    REQUIRE(data);
+
+    auto u16 = [&](uint32_t offset, uint16_t value) {
+        data[offset] = value >> 8;
+        data[offset + 1] = value & 0xff;
+    };
+    auto u32 = [&](uint32_t offset, uint32_t value) {
+        u16(offset, value >> 16);
+        u16(offset + 2, value & 0xffff);
+    };
+    auto tag = [&](uint32_t offset, const char* tag, uint32_t table, uint32_t length) {
+        memcpy(data + offset, tag, 4);
+        u32(offset + 8, table);
+        u32(offset + 12, length);
+    };
+
+    u32(0, 0x00010000);
+    u16(4, 3);
+    tag(12, "cmap", cmap, size - cmap);
+    tag(28, "head", 60, 54);
+    tag(44, "hhea", 116, 36);
+    u16(60 + 18, 1000);             //unitsPerEm
+    u16(116 + 4, 800);              //ascent
+
+    u16(cmap + 2, 1);               //a subtable
+    u16(cmap + 4, 3);               //windows
+    u16(cmap + 6, 10);              //unicode full repertory
+    u32(cmap + 8, 12);
+    u16(cmap + 12, 12);             //format 12
+    u32(cmap + 16, 16 + groupCnt * 12);
+    u32(cmap + 24, groupCnt);
+    for (uint32_t i = 0; i < groupCnt; ++i) {
+        auto group = cmap + 28 + i * 12;
+        u32(group, 0);
+        u32(group + 4, 0x10ffff);
+        u32(group + 8, i);
+    }
+
+    REQUIRE(Text::load("Overlapped", (char*)data, size, "ttf", true) == Result::Success);
+
+    {
+        auto text = unique_ptr<Text>(Text::gen());
+        REQUIRE(text->font("Overlapped", 20) == Result::Success);
+        REQUIRE(text->text("ThorVG \xf0\x9f\x98\x80") == Result::Success);
+        float x, y, w, h;
+        text->bounds(&x, &y, &w, &h);
+    }
+
+    REQUIRE(Text::load("Overlapped", nullptr, 0) == Result::Success);
+
+    free(data);
+    Initializer::term();
+}
+
 #endif